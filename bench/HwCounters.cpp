@@ -0,0 +1,171 @@
+#include "HwCounters.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+struct EventSpec {
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+const EventSpec kEvents[HwEventCount] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+int openEvent(const EventSpec& spec)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = spec.type;
+    attr.config         = spec.config;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // This thread, any CPU.
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+} // namespace
+
+double HwSample::ipc() const
+{
+    if (!has(HwEvent::Cycles) || !has(HwEvent::Instructions) || get(HwEvent::Cycles) <= 0.0) {
+        return 0.0;
+    }
+    return get(HwEvent::Instructions) / get(HwEvent::Cycles);
+}
+
+HwCounters::HwCounters()
+{
+    for (int& fd : m_fds) {
+        fd = -1;
+    }
+}
+
+HwCounters::~HwCounters()
+{
+    close();
+}
+
+bool HwCounters::open()
+{
+    close();
+#ifdef __linux__
+    bool any = false;
+    for (int i = 0; i < HwEventCount; ++i) {
+        m_fds[i] = openEvent(kEvents[i]);
+        if (m_fds[i] < 0) {
+            std::fprintf(stderr, "[HwCounters] %s unavailable: %s\n",
+                         eventName(static_cast<HwEvent>(i)), std::strerror(errno));
+        } else {
+            any = true;
+        }
+    }
+    if (!any) {
+        std::fprintf(stderr, "[HwCounters] No counters (check /proc/sys/kernel/perf_event_paranoid)\n");
+    }
+    return any;
+#else
+    std::fprintf(stderr, "[HwCounters] perf_event_open is Linux-only\n");
+    return false;
+#endif
+}
+
+void HwCounters::close()
+{
+    for (int& fd : m_fds) {
+#ifdef __linux__
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+        fd = -1;
+    }
+}
+
+bool HwCounters::isOpen() const
+{
+    for (int fd : m_fds) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void HwCounters::start()
+{
+#ifdef __linux__
+    for (int fd : m_fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+HwSample HwCounters::stop()
+{
+    HwSample sample;
+    for (int i = 0; i < HwEventCount; ++i) {
+        sample.valid[i] = false;
+        sample.value[i] = 0.0;
+    }
+
+#ifdef __linux__
+    for (int fd : m_fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int i = 0; i < HwEventCount; ++i) {
+        if (m_fds[i] < 0) {
+            continue;
+        }
+        // value, time enabled, time running
+        std::uint64_t data[3] = { 0, 0, 0 };
+        if (read(m_fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+            continue;
+        }
+        sample.valid[i] = true;
+        sample.value[i] = static_cast<double>(data[0]) *
+                          (static_cast<double>(data[1]) / static_cast<double>(data[2]));
+    }
+#endif
+    return sample;
+}
+
+const char* HwCounters::eventName(HwEvent event)
+{
+    switch (event) {
+    case HwEvent::Cycles:       return "cycles";
+    case HwEvent::Instructions: return "instructions";
+    case HwEvent::L1dMisses:    return "L1d misses";
+    case HwEvent::LlcMisses:    return "LLC misses";
+    case HwEvent::BranchMisses: return "branch misses";
+    default:                    return "?";
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// Hardware performance counters for the benchmarks, read through Linux
+// perf_event_open. Counts user-space events of the calling thread only, so
+// benchmarks that want them should run their kernels single-threaded.
+//
+// Every event is opened separately; events the CPU, hypervisor or
+// perf_event_paranoid setting does not allow are reported as unavailable
+// instead of failing the whole set. Counts are scaled by enabled/running
+// time when the kernel multiplexes them. On other platforms open() fails.
+
+enum class HwEvent {
+    Cycles,
+    Instructions,
+    L1dMisses,     // L1 data cache read misses
+    LlcMisses,     // last-level cache misses
+    BranchMisses,
+    Count
+};
+
+constexpr int HwEventCount = static_cast<int>(HwEvent::Count);
+
+struct HwSample {
+    bool   valid[HwEventCount];
+    double value[HwEventCount];
+
+    bool has(HwEvent e) const { return valid[static_cast<int>(e)]; }
+    double get(HwEvent e) const { return value[static_cast<int>(e)]; }
+
+    // Instructions per cycle, or 0 if either count is missing.
+    double ipc() const;
+};
+
+class HwCounters {
+public:
+    HwCounters();
+    ~HwCounters();
+
+    HwCounters(const HwCounters&) = delete;
+    HwCounters& operator=(const HwCounters&) = delete;
+
+    // Returns false if no event could be opened; the reason is logged.
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    // Reset and enable all events.
+    void start();
+
+    // Disable all events and read them.
+    HwSample stop();
+
+    static const char* eventName(HwEvent event);
+
+private:
+    int m_fds[HwEventCount];
+};
@@ -0,0 +1,302 @@
+// Per-kernel benchmark for the training and data hot paths:
+// ToyNet::trainBatch, ToyNet::forwardSingle, the three optimizer update
+// kernels and dataset generation. Prints wall time per operation and, with
+// --counters, hardware counters per operation (cycles, instructions, IPC,
+// L1d / LLC misses, branch misses) read through perf_event_open.
+//
+// In builds with NNDEMO_PHASE_TIMING, trainBatch is also broken down into
+// its phases (input, forward, loss, backward, reduce, optimizer).
+//
+// The shared thread pool defaults to no workers here (NNDEMO_THREADS=0
+// unless set) because the counters only follow the calling thread.
+//
+// Usage: KernelBench [--counters] [--json file] [scale]
+//   scale multiplies every kernel's iteration count (default 1).
+//   --json also writes the results to `file`.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "DatasetGenerator.h"
+#include "HwCounters.h"
+#include "Optimizer.h"
+#include "PhaseTimer.h"
+#include "ToyNet.h"
+
+namespace {
+
+struct Kernel {
+    const char*           name;
+    long                  iterations;
+    std::function<void()> body;
+};
+
+struct KernelResult {
+    const char*     name;
+    long            iterations;
+    double          nsPerOp;
+    HwSample        counters;
+    TrainPhaseTimes phases;
+};
+
+// Keys for the JSON output, in HwEvent order.
+const char* const kEventKeys[HwEventCount] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses",
+};
+
+volatile float g_sink = 0.0f;
+
+void printHeader(bool counters)
+{
+    std::printf("%-16s %10s %12s", "kernel", "ops", "ns/op");
+    if (counters) {
+        std::printf(" %12s %12s %6s %10s %10s %10s",
+                    "cycles/op", "instr/op", "IPC", "L1d/op", "LLC/op", "brmiss/op");
+    }
+    std::printf("\n");
+}
+
+void printPerOp(const HwSample& s, HwEvent e, long ops, const char* fmt)
+{
+    if (s.has(e)) {
+        std::printf(fmt, s.get(e) / static_cast<double>(ops));
+    } else {
+        std::printf(" %10s", "-");
+    }
+}
+
+KernelResult runKernel(const Kernel& k, HwCounters* counters)
+{
+    // Warm caches, branch predictors and lazily sized buffers.
+    k.body();
+
+    const TrainPhaseTimes phasesBefore = trainPhaseTotals();
+    if (counters) {
+        counters->start();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < k.iterations; ++i) {
+        k.body();
+    }
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    const HwSample sample = counters ? counters->stop() : HwSample{};
+
+    KernelResult result;
+    result.name       = k.name;
+    result.iterations = k.iterations;
+    result.nsPerOp    = seconds * 1e9 / k.iterations;
+    result.counters   = sample;
+    result.phases     = trainPhaseDelta(trainPhaseTotals(), phasesBefore);
+
+    std::printf("%-16s %10ld %12.1f", k.name, k.iterations, result.nsPerOp);
+    if (counters) {
+        printPerOp(sample, HwEvent::Cycles, k.iterations, " %12.1f");
+        printPerOp(sample, HwEvent::Instructions, k.iterations, " %12.1f");
+        if (sample.ipc() > 0.0) {
+            std::printf(" %6.2f", sample.ipc());
+        } else {
+            std::printf(" %6s", "-");
+        }
+        printPerOp(sample, HwEvent::L1dMisses, k.iterations, " %10.2f");
+        printPerOp(sample, HwEvent::LlcMisses, k.iterations, " %10.3f");
+        printPerOp(sample, HwEvent::BranchMisses, k.iterations, " %10.2f");
+    }
+    std::printf("\n");
+    return result;
+}
+
+void printPhases(const KernelResult& r)
+{
+    std::uint64_t totalNs = 0;
+    for (int i = 0; i < TrainPhaseCount; ++i) {
+        totalNs += r.phases.ns[i];
+    }
+    if (totalNs == 0) {
+        return;
+    }
+    std::printf("\n%s phases (%llu steps)\n", r.name, static_cast<unsigned long long>(r.phases.steps));
+    std::printf("%-16s %12s %8s\n", "phase", "ns/op", "share");
+    for (int i = 0; i < TrainPhaseCount; ++i) {
+        std::printf("%-16s %12.1f %7.1f%%\n",
+                    trainPhaseName(static_cast<TrainPhase>(i)),
+                    static_cast<double>(r.phases.ns[i]) / r.iterations,
+                    100.0 * r.phases.ns[i] / totalNs);
+    }
+}
+
+// Per-op figures as one JSON object per kernel; counters and phases are
+// only present when measured.
+bool writeJson(const char* path, const std::vector<KernelResult>& results, bool counters)
+{
+    std::FILE* out = std::fopen(path, "w");
+    if (!out) {
+        std::fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+
+    std::fprintf(out, "{\n  \"batch\": %d,\n  \"counters\": %s,\n  \"phase_timing\": %s,\n  \"kernels\": [\n",
+                 ToyNet::MaxBatch,
+                 counters ? "true" : "false",
+                 phaseTimingEnabled() ? "true" : "false");
+    for (std::size_t k = 0; k < results.size(); ++k) {
+        const KernelResult& r = results[k];
+        std::fprintf(out, "    {\"name\": \"%s\", \"ops\": %ld, \"ns_per_op\": %.1f",
+                     r.name, r.iterations, r.nsPerOp);
+        if (counters) {
+            for (int e = 0; e < HwEventCount; ++e) {
+                if (r.counters.valid[e]) {
+                    std::fprintf(out, ", \"%s_per_op\": %.3f",
+                                 kEventKeys[e], r.counters.value[e] / r.iterations);
+                }
+            }
+        }
+        if (r.phases.steps > 0) {
+            std::fprintf(out, ", \"phases_ns_per_op\": {");
+            for (int i = 0; i < TrainPhaseCount; ++i) {
+                std::fprintf(out, "%s\"%s\": %.1f",
+                             i > 0 ? ", " : "",
+                             trainPhaseName(static_cast<TrainPhase>(i)),
+                             static_cast<double>(r.phases.ns[i]) / r.iterations);
+            }
+            std::fprintf(out, "}");
+        }
+        std::fprintf(out, "}%s\n", k + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    std::fclose(out);
+    return true;
+}
+
+// Parameter, gradient and moment buffers shaped like ToyNet's raw network.
+struct OptimizerBuffers {
+    std::vector<float> p[6];
+    std::vector<float> g[6];
+    std::vector<float> m[6];
+    std::vector<float> v[6];
+    int                adamStep = 0;
+
+    OptimizerBuffers() {
+        const int sizes[6] = {
+            ToyNet::Hidden1 * ToyNet::InputDim,   ToyNet::Hidden1,
+            ToyNet::Hidden2 * ToyNet::Hidden1,    ToyNet::Hidden2,
+            ToyNet::OutputDim * ToyNet::Hidden2,  ToyNet::OutputDim,
+        };
+        for (int i = 0; i < 6; ++i) {
+            p[i].assign(static_cast<std::size_t>(sizes[i]), 0.1f);
+            g[i].assign(static_cast<std::size_t>(sizes[i]), 0.01f);
+            m[i].assign(static_cast<std::size_t>(sizes[i]), 0.0f);
+            v[i].assign(static_cast<std::size_t>(sizes[i]), 0.0f);
+        }
+    }
+
+    void step(const OptimizerConfig& cfg) {
+        optimizerApplyUpdate(cfg,
+                             p[0], p[1], p[2], p[3], p[4], p[5],
+                             g[0], g[1], g[2], g[3], g[4], g[5],
+                             m[0], m[1], m[2], m[3], m[4], m[5],
+                             v[0], v[1], v[2], v[3], v[4], v[5],
+                             adamStep);
+    }
+};
+
+OptimizerConfig makeConfig(OptimizerType type)
+{
+    OptimizerConfig cfg;
+    cfg.type         = type;
+    cfg.learningRate = 1e-4f;
+    cfg.momentum     = 0.9f;
+    cfg.beta1        = 0.9f;
+    cfg.beta2        = 0.999f;
+    cfg.eps          = 1e-8f;
+    return cfg;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool useCounters = false;
+    const char* jsonPath = nullptr;
+    long scale = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--counters") == 0) {
+            useCounters = true;
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            scale = std::atol(argv[i]);
+        }
+    }
+    if (scale < 1) scale = 1;
+
+#ifndef _WIN32
+    setenv("NNDEMO_THREADS", "0", 0);
+#endif
+
+    HwCounters counters;
+    if (useCounters && !counters.open()) {
+        useCounters = false;
+    }
+
+    std::vector<DataPoint> dataset;
+    generateDataset(DatasetType::Spirals, 4096, 0.1f, dataset, 1);
+
+    ToyNet trainNet;
+    trainNet.setOptimizer(OptimizerType::Adam);
+    trainNet.setLearningRate(0.01f);
+    std::vector<DataPoint> batch(dataset.begin(), dataset.begin() + ToyNet::MaxBatch);
+
+    ToyNet evalNet;
+    std::size_t evalCursor = 0;
+
+    OptimizerBuffers sgd;
+    OptimizerBuffers momentum;
+    OptimizerBuffers adam;
+    const OptimizerConfig sgdCfg      = makeConfig(OptimizerType::SGD);
+    const OptimizerConfig momentumCfg = makeConfig(OptimizerType::SGDMomentum);
+    const OptimizerConfig adamCfg     = makeConfig(OptimizerType::Adam);
+
+    std::vector<DataPoint> generated;
+
+    const Kernel kernels[] = {
+        { "trainBatch", 2000 * scale, [&] {
+              float acc = 0.0f;
+              g_sink = trainNet.trainBatch(batch, acc);
+          } },
+        { "forwardSingle", 1000000 * scale, [&] {
+              const DataPoint& p = dataset[evalCursor];
+              evalCursor = (evalCursor + 1) % dataset.size();
+              float p0 = 0.0f;
+              float p1 = 0.0f;
+              evalNet.forwardSingle(p.x, p.y, p0, p1);
+              g_sink = p0;
+          } },
+        { "optimizer SGD", 1000000 * scale, [&] { sgd.step(sgdCfg); } },
+        { "optimizer mom", 1000000 * scale, [&] { momentum.step(momentumCfg); } },
+        { "optimizer Adam", 1000000 * scale, [&] { adam.step(adamCfg); } },
+        { "generate 64k", 20 * scale, [&] {
+              generateDataset(DatasetType::Spirals, 65536, 0.1f, generated, 7);
+          } },
+    };
+
+    std::printf("batch=%d counters=%s\n", ToyNet::MaxBatch, useCounters ? "on" : "off");
+    printHeader(useCounters);
+    std::vector<KernelResult> results;
+    for (const Kernel& k : kernels) {
+        results.push_back(runKernel(k, useCounters ? &counters : nullptr));
+    }
+    for (const KernelResult& r : results) {
+        printPhases(r);
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results, useCounters)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Reduction-mode benchmark for ToyNet::trainBatch.
+//
+// Trains the same network for a fixed number of steps with 1 to 64 threads,
+// once with the fast per-thread reduction and once with the deterministic
+// block/tree reduction. Reports steps/s for both, the overhead of the
+// deterministic mode, and whether its parameters are bit-identical to the
+// single-thread run.
+//
+// Usage: ReductionBench [steps] [batchSize]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "DatasetGenerator.h"
+#include "ThreadPool.h"
+#include "ToyNet.h"
+
+namespace {
+
+struct RunResult {
+    double             stepsPerSecond;
+    std::vector<float> params;
+};
+
+RunResult runTraining(ThreadPool& pool,
+                      bool deterministic,
+                      const std::vector<DataPoint>& dataset,
+                      int steps,
+                      int batchSize)
+{
+    ToyNet net;
+    net.setThreadPool(pool);
+    net.setDeterministicReduction(deterministic);
+    net.setOptimizer(OptimizerType::Adam);
+    net.setLearningRate(0.01f);
+    net.resetParameters(1);
+
+    std::vector<DataPoint> batch(static_cast<std::size_t>(batchSize));
+    const std::size_t dataCount = dataset.size();
+    std::size_t cursor = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s) {
+        for (auto& p : batch) {
+            p = dataset[cursor];
+            cursor = (cursor + 7919) % dataCount;
+        }
+        float acc = 0.0f;
+        net.trainBatch(batch, acc);
+    }
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    RunResult result;
+    result.stepsPerSecond = seconds > 0.0 ? steps / seconds : 0.0;
+    result.params.resize(static_cast<std::size_t>(net.getParameterCount()));
+    net.copyParametersTo(result.params.data());
+    return result;
+}
+
+float maxAbsDiff(const std::vector<float>& a, const std::vector<float>& b)
+{
+    float diff = 0.0f;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        diff = std::fmax(diff, std::fabs(a[i] - b[i]));
+    }
+    return diff;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int steps     = (argc > 1) ? std::atoi(argv[1]) : 2000;
+    int       batchSize = (argc > 2) ? std::atoi(argv[2]) : ToyNet::MaxBatch;
+    if (batchSize < 1) batchSize = 1;
+    if (batchSize > ToyNet::MaxBatch) batchSize = ToyNet::MaxBatch;
+
+    std::vector<DataPoint> dataset;
+    generateDataset(DatasetType::Spirals, 4096, 0.1f, dataset, 1);
+
+    std::printf("steps=%d batch=%d block=%d\n", steps, batchSize, ToyNet::DeterministicBlock);
+    std::printf("%8s %14s %14s %10s %14s %12s\n",
+                "threads", "fast steps/s", "det steps/s", "overhead", "fast max|d|", "det bitwise");
+
+    const int threadCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+    std::vector<float> fastReference;
+    std::vector<float> detReference;
+    bool allIdentical = true;
+
+    for (int threads : threadCounts) {
+        ThreadPool pool(threads - 1);
+
+        const RunResult fast = runTraining(pool, false, dataset, steps, batchSize);
+        const RunResult det  = runTraining(pool, true,  dataset, steps, batchSize);
+
+        if (fastReference.empty()) {
+            fastReference = fast.params;
+            detReference  = det.params;
+        }
+
+        const bool identical = std::memcmp(det.params.data(), detReference.data(),
+                                           det.params.size() * sizeof(float)) == 0;
+        allIdentical &= identical;
+
+        const double overhead = fast.stepsPerSecond > 0.0
+            ? (fast.stepsPerSecond / det.stepsPerSecond - 1.0) * 100.0
+            : 0.0;
+
+        std::printf("%8d %14.0f %14.0f %9.1f%% %14.3g %12s\n",
+                    threads,
+                    fast.stepsPerSecond,
+                    det.stepsPerSecond,
+                    overhead,
+                    static_cast<double>(maxAbsDiff(fast.params, fastReference)),
+                    identical ? "yes" : "NO");
+    }
+
+    std::printf("deterministic mode %s across thread counts\n",
+                allIdentical ? "is bit-identical" : "DIFFERS");
+    return allIdentical ? 0 : 1;
+}
@@ -0,0 +1,324 @@
+// Time-to-accuracy benchmark: end-to-end training cost as a user sees it.
+//
+// For every DatasetType and optimizer, trains a fresh Trainer from fixed
+// seeds (dataset and initialization) until the full-dataset accuracy
+// reaches the target, or the step cap is hit. Reports training wall time,
+// optimizer steps and samples consumed; the full-dataset evaluations that
+// check for the target are not counted in the time. Gradients are reduced
+// deterministically, so steps to target do not depend on the thread count.
+//
+// Usage: TimeToAccuracyBench [options]
+//   --target F       full-dataset accuracy to reach (default 0.95)
+//   --max-steps N    step cap per run (default 20000)
+//   --eval-every N   steps between accuracy checks (default 25)
+//   --seeds N        runs per dataset / optimizer, seeds 1..N (default 3)
+//   --points N       dataset size (default 2000)
+//   --spread F       dataset spread / noise (default 0.1)
+//   --batch N        samples per step (default 64)
+//   --features N     FeatureSet index, 0..3 (default 0 = raw)
+//   --json FILE      also write every run and the summary as JSON
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "DatasetGenerator.h"
+#include "FeatureExpansion.h"
+#include "Trainer.h"
+
+namespace {
+
+struct BenchConfig {
+    float target    = 0.95f;
+    int   maxSteps  = 20000;
+    int   evalEvery = 25;
+    int   seeds     = 3;
+    int   points    = 2000;
+    float spread    = 0.1f;
+    int   batchSize = 64;
+
+    FeatureSet featureSet = FeatureSet::Raw;
+};
+
+struct OptimizerSetup {
+    OptimizerType type;
+    const char*   name;
+    float         learningRate;
+};
+
+// Learning rates per optimizer. Momentum 0.9 takes steps about ten times
+// the learning rate, so it starts lower than plain SGD.
+const OptimizerSetup kOptimizers[] = {
+    { OptimizerType::SGD,         "sgd",      0.1f  },
+    { OptimizerType::SGDMomentum, "momentum", 0.01f },
+    { OptimizerType::Adam,        "adam",     0.01f },
+};
+const int kOptimizerCount = 3;
+
+struct RunResult {
+    DatasetType   dataset;
+    int           optimizer; // index into kOptimizers
+    unsigned int  seed;
+    bool          reached;
+    int           steps;
+    std::uint64_t samples;
+    double        seconds;
+    float         accuracy;  // full-dataset accuracy at the last check
+};
+
+struct Summary {
+    int    reached;
+    int    runs;
+    double medianSeconds; // over the runs that reached the target
+    double medianSteps;
+    double medianSamples;
+    float  meanAccuracy;  // over all runs
+};
+
+void printUsage()
+{
+    std::printf("Usage: TimeToAccuracyBench [--target F] [--max-steps N] [--eval-every N]\n"
+                "                           [--seeds N] [--points N] [--spread F]\n"
+                "                           [--batch N] [--features N] [--json FILE]\n");
+}
+
+RunResult runToTarget(const BenchConfig& cfg, DatasetType type, int optimizer, unsigned int seed)
+{
+    std::vector<DataPoint> dataset;
+    generateDataset(type, cfg.points, cfg.spread, dataset, seed);
+
+    Trainer trainer;
+    trainer.optimizerType = kOptimizers[optimizer].type;
+    trainer.learningRate  = kOptimizers[optimizer].learningRate;
+    trainer.batchSize     = cfg.batchSize;
+    trainer.featureSet    = cfg.featureSet;
+    trainer.deterministic = true;
+    trainer.resetForNewDataset();
+    trainer.net.resetParameters(seed);
+
+    RunResult result;
+    result.dataset   = type;
+    result.optimizer = optimizer;
+    result.seed      = seed;
+    result.reached   = false;
+    result.steps     = 0;
+    result.samples   = 0;
+    result.seconds   = 0.0;
+    result.accuracy  = 0.0f;
+
+    const std::uint64_t batchSamples = static_cast<std::uint64_t>(
+        std::min(cfg.batchSize, static_cast<int>(dataset.size())));
+
+    while (result.steps < cfg.maxSteps) {
+        const int chunk = std::min(cfg.evalEvery, cfg.maxSteps - result.steps);
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < chunk; ++i) {
+            trainer.trainOneEpoch(dataset);
+        }
+        result.seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        result.steps   += chunk;
+        result.samples += batchSamples * static_cast<std::uint64_t>(chunk);
+
+        trainer.evaluateFullDataset(dataset);
+        result.accuracy = trainer.fullAccuracy;
+        if (result.accuracy >= cfg.target) {
+            result.reached = true;
+            break;
+        }
+    }
+    return result;
+}
+
+double median(std::vector<double>& values)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const std::size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+}
+
+Summary summarize(const std::vector<RunResult>& runs, DatasetType type, int optimizer)
+{
+    Summary s = {};
+    std::vector<double> seconds;
+    std::vector<double> steps;
+    std::vector<double> samples;
+    double accuracySum = 0.0;
+    for (const RunResult& r : runs) {
+        if (r.dataset != type || r.optimizer != optimizer) {
+            continue;
+        }
+        ++s.runs;
+        accuracySum += r.accuracy;
+        if (r.reached) {
+            ++s.reached;
+            seconds.push_back(r.seconds);
+            steps.push_back(r.steps);
+            samples.push_back(static_cast<double>(r.samples));
+        }
+    }
+    s.medianSeconds = median(seconds);
+    s.medianSteps   = median(steps);
+    s.medianSamples = median(samples);
+    s.meanAccuracy  = s.runs > 0 ? static_cast<float>(accuracySum / s.runs) : 0.0f;
+    return s;
+}
+
+bool writeJson(const char* path, const BenchConfig& cfg, const std::vector<RunResult>& runs)
+{
+    std::FILE* out = std::fopen(path, "w");
+    if (!out) {
+        std::fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+
+    std::fprintf(out,
+                 "{\n  \"target\": %.4f,\n  \"max_steps\": %d,\n  \"eval_every\": %d,\n"
+                 "  \"points\": %d,\n  \"spread\": %.4f,\n  \"batch\": %d,\n  \"features\": \"%s\",\n",
+                 cfg.target, cfg.maxSteps, cfg.evalEvery, cfg.points, cfg.spread, cfg.batchSize,
+                 getFeatureSetNames()[static_cast<int>(cfg.featureSet)]);
+
+    std::fprintf(out, "  \"runs\": [\n");
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        const RunResult& r = runs[i];
+        std::fprintf(out,
+                     "    {\"dataset\": \"%s\", \"optimizer\": \"%s\", \"seed\": %u, \"reached\": %s, "
+                     "\"steps\": %d, \"samples\": %llu, \"seconds\": %.6f, \"accuracy\": %.4f}%s\n",
+                     datasetTypeToString(r.dataset),
+                     kOptimizers[r.optimizer].name,
+                     r.seed,
+                     r.reached ? "true" : "false",
+                     r.steps,
+                     static_cast<unsigned long long>(r.samples),
+                     r.seconds,
+                     r.accuracy,
+                     i + 1 < runs.size() ? "," : "");
+    }
+
+    std::fprintf(out, "  ],\n  \"summary\": [\n");
+    for (int d = 0; d < DatasetTypeCount; ++d) {
+        for (int o = 0; o < kOptimizerCount; ++o) {
+            const Summary s = summarize(runs, static_cast<DatasetType>(d), o);
+            const bool last = d == DatasetTypeCount - 1 && o == kOptimizerCount - 1;
+            std::fprintf(out,
+                         "    {\"dataset\": \"%s\", \"optimizer\": \"%s\", \"reached\": %d, \"runs\": %d, "
+                         "\"median_seconds\": %.6f, \"median_steps\": %.1f, \"median_samples\": %.0f, "
+                         "\"mean_accuracy\": %.4f}%s\n",
+                         datasetTypeToString(static_cast<DatasetType>(d)),
+                         kOptimizers[o].name,
+                         s.reached,
+                         s.runs,
+                         s.medianSeconds,
+                         s.medianSteps,
+                         s.medianSamples,
+                         s.meanAccuracy,
+                         last ? "" : ",");
+        }
+    }
+    std::fprintf(out, "  ]\n}\n");
+    std::fclose(out);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    BenchConfig cfg;
+    const char* jsonPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--target") {
+            cfg.target = static_cast<float>(std::atof(value));
+        } else if (arg == "--max-steps") {
+            cfg.maxSteps = std::atoi(value);
+        } else if (arg == "--eval-every") {
+            cfg.evalEvery = std::atoi(value);
+        } else if (arg == "--seeds") {
+            cfg.seeds = std::atoi(value);
+        } else if (arg == "--points") {
+            cfg.points = std::atoi(value);
+        } else if (arg == "--spread") {
+            cfg.spread = static_cast<float>(std::atof(value));
+        } else if (arg == "--batch") {
+            cfg.batchSize = std::atoi(value);
+        } else if (arg == "--features") {
+            const int index = std::atoi(value);
+            if (index < 0 || index >= FeatureSetCount) {
+                std::fprintf(stderr, "Feature set index out of range\n");
+                return 1;
+            }
+            cfg.featureSet = static_cast<FeatureSet>(index);
+        } else if (arg == "--json") {
+            jsonPath = value;
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+    }
+    cfg.maxSteps  = std::max(cfg.maxSteps, 1);
+    cfg.evalEvery = std::max(cfg.evalEvery, 1);
+    cfg.seeds     = std::max(cfg.seeds, 1);
+    cfg.points    = std::max(cfg.points, 4);
+    cfg.batchSize = std::min(std::max(cfg.batchSize, 1), ToyNet::MaxBatch);
+
+    std::printf("target=%.3f max-steps=%d eval-every=%d seeds=%d points=%d batch=%d features=%s\n",
+                cfg.target, cfg.maxSteps, cfg.evalEvery, cfg.seeds, cfg.points, cfg.batchSize,
+                getFeatureSetNames()[static_cast<int>(cfg.featureSet)]);
+
+    std::vector<RunResult> runs;
+    runs.reserve(static_cast<std::size_t>(DatasetTypeCount * kOptimizerCount * cfg.seeds));
+    for (int d = 0; d < DatasetTypeCount; ++d) {
+        for (int o = 0; o < kOptimizerCount; ++o) {
+            for (int s = 1; s <= cfg.seeds; ++s) {
+                runs.push_back(runToTarget(cfg, static_cast<DatasetType>(d), o,
+                                           static_cast<unsigned int>(s)));
+            }
+        }
+    }
+
+    // Medians over the runs that reached the target; "-" if none did.
+    std::printf("%-20s %-9s %8s %12s %10s %12s %9s\n",
+                "dataset", "optimizer", "reached", "seconds", "steps", "samples", "mean acc");
+    for (int d = 0; d < DatasetTypeCount; ++d) {
+        for (int o = 0; o < kOptimizerCount; ++o) {
+            const Summary s = summarize(runs, static_cast<DatasetType>(d), o);
+            std::printf("%-20s %-9s %5d/%-2d",
+                        datasetTypeToString(static_cast<DatasetType>(d)),
+                        kOptimizers[o].name,
+                        s.reached,
+                        s.runs);
+            if (s.reached > 0) {
+                std::printf(" %12.4f %10.0f %12.0f", s.medianSeconds, s.medianSteps, s.medianSamples);
+            } else {
+                std::printf(" %12s %10s %12s", "-", "-", "-");
+            }
+            std::printf(" %9.3f\n", s.meanAccuracy);
+        }
+    }
+
+    if (jsonPath && !writeJson(jsonPath, cfg, runs)) {
+        return 1;
+    }
+    return 0;
+}
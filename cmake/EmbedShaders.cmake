@@ -0,0 +1,20 @@
+# Writes a header with every shaders/*.vert and shaders/*.frag file as a
+# string constant, so the app needs no shader files at run time.
+# Script mode:
+#   cmake -DSHADER_DIR=<dir> -DOUTPUT=<header> -P EmbedShaders.cmake
+
+file(GLOB shader_files "${SHADER_DIR}/*.vert" "${SHADER_DIR}/*.frag")
+list(SORT shader_files)
+
+set(content "// Generated from shaders/ by cmake/EmbedShaders.cmake. Do not edit.\n")
+string(APPEND content "#pragma once\n\n")
+string(APPEND content "struct EmbeddedShader {\n    const char* name;\n    const char* source;\n};\n\n")
+string(APPEND content "inline constexpr EmbeddedShader kEmbeddedShaders[] = {\n")
+foreach(path ${shader_files})
+    get_filename_component(name "${path}" NAME)
+    file(READ "${path}" source)
+    string(APPEND content "    {\"${name}\", R\"nnglsl(${source})nnglsl\"},\n")
+endforeach()
+string(APPEND content "};\n")
+
+file(WRITE "${OUTPUT}" "${content}")
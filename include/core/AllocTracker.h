@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Heap allocation tracking for debug builds (CMake option
+// NNDEMO_TRACK_ALLOCATIONS, which defines NN_TRACK_ALLOCATIONS). The
+// global operator new / delete are replaced with versions that count
+// allocations per thread and for the whole process.
+//
+// NN_ASSERT_NO_ALLOC(name) checks that the rest of the enclosing scope
+// makes no allocation on the calling thread. The first AllocWarmupPasses
+// passes through each site are not checked, so buffers that size
+// themselves on first use do not trip it. Violations are logged (the first
+// few per site); with NNDEMO_ALLOC_STRICT=1 in the environment the process
+// aborts instead. NN_ALLOW_ALLOC() exempts the rest of its scope, for
+// one-off work such as regenerating a dataset inside a checked frame.
+// Without NN_TRACK_ALLOCATIONS both macros expand to nothing and the
+// counters stay at zero.
+
+struct AllocCounts {
+    std::uint64_t allocations;
+    std::uint64_t bytes;
+};
+
+constexpr int AllocWarmupPasses = 60;
+
+// True if the allocation hooks are compiled in.
+bool allocTrackingEnabled();
+
+// Allocations made by the calling thread since it started.
+AllocCounts threadAllocCounts();
+
+// Allocations made by all threads since the process started.
+AllocCounts processAllocCounts();
+
+// One NN_ASSERT_NO_ALLOC location.
+struct AllocSite {
+    const char*      name;
+    const char*      file;
+    int              line;
+    std::atomic<int> passes;
+    std::atomic<int> violations;
+
+    AllocSite(const char* siteName, const char* siteFile, int siteLine)
+        : name(siteName), file(siteFile), line(siteLine), passes(0), violations(0) {}
+};
+
+class AllocScopeCheck {
+public:
+    explicit AllocScopeCheck(AllocSite& site);
+    ~AllocScopeCheck();
+
+    AllocScopeCheck(const AllocScopeCheck&) = delete;
+    AllocScopeCheck& operator=(const AllocScopeCheck&) = delete;
+
+private:
+    AllocSite&  m_site;
+    AllocCounts m_start;
+};
+
+class AllocExemptScope {
+public:
+    AllocExemptScope();
+    ~AllocExemptScope();
+
+    AllocExemptScope(const AllocExemptScope&) = delete;
+    AllocExemptScope& operator=(const AllocExemptScope&) = delete;
+
+private:
+    AllocCounts m_start;
+};
+
+#define NN_ALLOC_CONCAT_INNER(a, b) a##b
+#define NN_ALLOC_CONCAT(a, b) NN_ALLOC_CONCAT_INNER(a, b)
+
+#ifdef NN_TRACK_ALLOCATIONS
+#define NN_ASSERT_NO_ALLOC(name)                                                          \
+    static AllocSite NN_ALLOC_CONCAT(nnAllocSite_, __LINE__)((name), __FILE__, __LINE__); \
+    AllocScopeCheck NN_ALLOC_CONCAT(nnAllocCheck_, __LINE__)(NN_ALLOC_CONCAT(nnAllocSite_, __LINE__))
+#define NN_ALLOW_ALLOC() AllocExemptScope NN_ALLOC_CONCAT(nnAllocExempt_, __LINE__)
+#else
+#define NN_ASSERT_NO_ALLOC(name) ((void)0)
+#define NN_ALLOW_ALLOC() ((void)0)
+#endif
@@ -2,48 +2,60 @@
 
 #include <vector>
 
+#include "RenderBench.h"
+
 struct GLFWwindow;
 struct UiState;
 struct DataPoint;
 class Trainer;
 class PointCloud;
+class PointGrid;
+class DatasetCache;
 class GridAxes;
 class FieldVisualizer;
 class ShaderProgram;
+struct FieldShaderSources;
 
 class App {
 public:
     App();
 
+    // Reads the --bench-render options (see RenderBench.h). Call before
+    // init(); returns false on a bad command line.
+    bool parseCommandLine(int argc, char** argv);
+
     bool init();
     int run();
 
     GLFWwindow* getWindow() const { return m_window; }
 
 private:
-    void renderLoop(GLFWwindow* window,
-                    ShaderProgram& pointShader,
-                    ShaderProgram& gridShader,
-                    ShaderProgram& fieldShader,
-                    int pointSizeLocation,
-                    int colorClass0Location,
-                    int colorClass1Location,
-                    int selectedIndexLocation,
-                    int gridColorLocation,
-                    int fieldW1Location,
-                    int fieldB1Location,
-                    int fieldW2Location,
-                    int fieldB2Location,
-                    int fieldW3Location,
-                    int fieldB3Location,
-                    UiState& ui,
-                    std::vector<DataPoint>& dataset,
-                    PointCloud& pointCloud,
-                    GridAxes& gridAxes,
-                    FieldVisualizer& fieldVis,
-                    Trainer& trainer,
-                    bool& leftMousePressedLastFrame,
-                    int maxPoints);
+    int renderLoop(GLFWwindow* window,
+                   ShaderProgram& pointShader,
+                   ShaderProgram& gridShader,
+                   ShaderProgram& fieldShader,
+                   int pointSizeLocation,
+                   int colorClass0Location,
+                   int colorClass1Location,
+                   int selectedIndexLocation,
+                   int gridColorLocation,
+                   int fieldW1Location,
+                   int fieldB1Location,
+                   int fieldW2Location,
+                   int fieldB2Location,
+                   int fieldW3Location,
+                   int fieldB3Location,
+                   FieldShaderSources& fieldSources,
+                   UiState& ui,
+                   std::vector<DataPoint>& dataset,
+                   PointCloud& pointCloud,
+                   PointGrid& pointGrid,
+                   DatasetCache& datasetCache,
+                   GridAxes& gridAxes,
+                   FieldVisualizer& fieldVis,
+                   Trainer& trainer,
+                   bool& leftMousePressedLastFrame,
+                   int maxPoints);
 
     void shutdownScene(PointCloud& pointCloud,
                        GridAxes& gridAxes,
@@ -52,4 +64,5 @@ private:
     void shutdownApp();
 
     GLFWwindow* m_window;
+    RenderBenchConfig m_bench;
 };
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// Per-sample training-time augmentation applied to raw (x, y) inputs while a
+// batch is gathered, before feature expansion. Every parameter 0 = off.
+struct AugmentConfig {
+    float jitter      = 0.0f; // uniform offset in [-jitter, jitter] on x and y
+    float maxRotation = 0.0f; // radians, uniform in [-max, max], at most MaxAugmentRotation
+    float scaleRange  = 0.0f; // uniform scale in [1 - range, 1 + range]
+    float labelNoise  = 0.0f; // probability of flipping a label
+
+    bool isActive() const {
+        return jitter > 0.0f || maxRotation > 0.0f || scaleRange > 0.0f || labelNoise > 0.0f;
+    }
+
+    bool operator==(const AugmentConfig& o) const {
+        return jitter == o.jitter && maxRotation == o.maxRotation &&
+               scaleRange == o.scaleRange && labelNoise == o.labelNoise;
+    }
+    bool operator!=(const AugmentConfig& o) const { return !(*this == o); }
+};
+
+// Largest supported rotation (about 30 degrees); the rotation uses a
+// polynomial sin/cos that is accurate to ~1e-5 in this range.
+constexpr float MaxAugmentRotation = 0.5f;
+
+// Augment `count` samples in place. Inputs are structure-of-arrays so the
+// loop is straight-line arithmetic the compiler vectorizes: random numbers
+// come from a 32-bit counter hash of (key, sample, draw) instead of a
+// sequential generator, and rotations use polynomials instead of libm.
+// Pass a different `key` for every batch.
+void augmentBatch(const AugmentConfig& config,
+                  std::uint32_t key,
+                  float* xs,
+                  float* ys,
+                  int* labels,
+                  int count);
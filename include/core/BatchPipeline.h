@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Augmentation.h"
+#include "DataPoint.h"
+#include "DatasetGenerator.h"
+#include "FeatureExpansion.h"
+#include "SpscQueue.h"
+
+// One assembled minibatch, ready for ToyNet::trainBatchFeatures.
+struct PreparedBatch {
+    std::vector<float> features; // row-major count x dim
+    std::vector<int>   labels;
+    // Streaming mode only: the samples as drawn from the stream, before
+    // augmentation (features and labels may be augmented).
+    std::vector<DataPoint> points;
+    int count = 0;
+    int dim   = 0;
+};
+
+struct BatchPipelineStats {
+    std::uint64_t produced;      // batches assembled since start()
+    std::uint64_t consumerStalls; // acquire() calls that had to wait
+};
+
+// Background batch assembly. A producer thread walks a private copy of the
+// dataset in a freshly shuffled order each pass, gathers the expanded
+// feature rows and labels of the next batches into a fixed pool of
+// buffers, and hands them to the training thread through a lock-free SPSC
+// queue; used buffers go back the same way. Up to `depth` batches are
+// prepared ahead, so batch assembly overlaps training.
+//
+// Augmentation (AugmentConfig) is applied to the raw inputs of every batch
+// on the producer thread, before feature expansion.
+//
+// In streaming mode there is no dataset: every batch is freshly sampled
+// from a DatasetType distribution (generateStreamSamples) on the producer
+// thread, so sample generation is also off the training thread.
+//
+// Neither side takes a lock to exchange batches. A side only blocks (on a
+// condition variable) when its queue is empty, e.g. the producer after it
+// has filled every buffer.
+class BatchPipeline {
+public:
+    static constexpr int MaxDepth = 8;
+
+    BatchPipeline();
+    ~BatchPipeline();
+
+    BatchPipeline(const BatchPipeline&) = delete;
+    BatchPipeline& operator=(const BatchPipeline&) = delete;
+
+    // Returns false (and does nothing) if threads are unavailable or the
+    // dataset is empty.
+    bool start(const std::vector<DataPoint>& dataset,
+               FeatureSet set,
+               int batchSize,
+               int depth,
+               unsigned int seed,
+               const AugmentConfig& augment);
+
+    // Streaming mode, starting at stream sample `firstSample`.
+    bool startStream(DatasetType type,
+                     float spread,
+                     unsigned int seed,
+                     std::uint64_t firstSample,
+                     FeatureSet set,
+                     int batchSize,
+                     int depth,
+                     const AugmentConfig& augment);
+
+    void stop();
+    bool isRunning() const;
+
+    // True if the running pipeline produces batches for this configuration.
+    bool matches(FeatureSet set, int batchSize, int datasetSize,
+                 const AugmentConfig& augment) const;
+    bool matchesStream(DatasetType type, float spread, unsigned int seed,
+                       FeatureSet set, int batchSize, const AugmentConfig& augment) const;
+
+    // Next prepared batch, waiting for the producer if none is ready yet.
+    // The batch stays valid until it is passed back to release().
+    const PreparedBatch* acquire();
+    void release(const PreparedBatch* batch);
+
+    BatchPipelineStats stats() const;
+
+private:
+    // Indices into m_buffers. Capacity leaves room for every buffer.
+    typedef SpscQueue<int, 2 * MaxDepth> IndexQueue;
+
+    bool startThread(FeatureSet set, int batchSize, int depth, const AugmentConfig& augment);
+    void producerLoop();
+    void fillBatch(PreparedBatch& batch);
+    void fillStreamBatch(PreparedBatch& batch);
+    void finishAugmentedBatch(PreparedBatch& batch);
+    void reshuffle();
+
+    static bool popOrWait(IndexQueue& queue,
+                          int& out,
+                          std::atomic<bool>& waiting,
+                          std::mutex& mutex,
+                          std::condition_variable& cv,
+                          const std::atomic<bool>& stop);
+    static void pushAndWake(IndexQueue& queue,
+                            int value,
+                            std::atomic<bool>& waiting,
+                            std::mutex& mutex,
+                            std::condition_variable& cv);
+
+    std::vector<DataPoint>     m_dataset;
+    FeatureColumns             m_columns;
+    FeatureSet                 m_set;
+    int                        m_batchSize;
+    std::vector<int>           m_order;
+    std::vector<int>           m_batchIndices;
+    int                        m_cursor;
+    std::uint64_t              m_rngState;
+
+    bool                       m_streaming;
+    DatasetType                m_streamType;
+    float                      m_streamSpread;
+    unsigned int               m_streamSeed;
+    std::uint64_t              m_streamNext;
+
+    AugmentConfig              m_augment;
+    std::uint32_t              m_augmentKey;
+    std::vector<float>         m_rawX; // raw inputs of the batch being augmented
+    std::vector<float>         m_rawY;
+
+    std::vector<PreparedBatch> m_buffers;
+    IndexQueue                 m_ready; // producer -> consumer
+    IndexQueue                 m_free;  // consumer -> producer
+
+    std::thread       m_thread;
+    std::atomic<bool> m_stop;
+
+    std::mutex              m_readyMutex;
+    std::condition_variable m_readyCv;
+    std::atomic<bool>       m_consumerWaiting;
+    std::mutex              m_freeMutex;
+    std::condition_variable m_freeCv;
+    std::atomic<bool>       m_producerWaiting;
+
+    std::atomic<std::uint64_t> m_produced;
+    std::uint64_t              m_consumerStalls;
+};
@@ -8,6 +8,7 @@ struct UiState {
     int   datasetIndex;
     int   numPoints;
     float spread;
+    unsigned int datasetSeed;
     float pointSize;
     bool  probeEnabled;
     float probeX;
@@ -15,10 +16,14 @@ struct UiState {
     bool  hasSelectedPoint;
     int   selectedPointIndex;
     int   selectedLabel;
+    bool  editPoints;  // clicks add/remove points instead of picking
+    int   editLabel;   // class of points added in edit mode
+    char  liveSegmentName[64];
 };
 
 void drawControlPanel(UiState& ui,
                       Trainer& trainer,
                       std::size_t currentPointCount,
                       bool& regenerateRequested,
-                      bool& stepTrainRequested);
+                      bool& stepTrainRequested,
+                      bool& evaluateRequested);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+
+#include "DatasetGenerator.h"
+#include "FeatureExpansion.h"
+#include "Optimizer.h"
+
+struct DataParallelConfig {
+    int           workers      = 2;     // worker processes
+    int           steps        = 2000;  // synchronous training steps
+    int           batchSize    = 64;    // samples per worker per step
+    DatasetType   dataset      = DatasetType::Spirals;
+    int           numPoints    = 4000;
+    float         spread       = 0.1f;
+    unsigned int  seed         = 1;
+    OptimizerType optimizer    = OptimizerType::Adam;
+    float         learningRate = 0.01f;
+    FeatureSet    featureSet   = FeatureSet::Raw;
+    int           logInterval  = 100;   // steps between progress lines (rank 0)
+    std::string   shmName      = "/nndemo_allreduce";
+    std::string   publishName;          // live segment for viewers; empty = off
+    int           publishInterval = 10; // steps between live updates
+};
+
+// Synchronous data-parallel training across forked worker processes (Linux).
+//
+// Every worker regenerates the same dataset from the seed and trains on its
+// own shard (points i with i % workers == rank). Each step the workers
+// compute gradients on a local minibatch, average them with a shared-memory
+// all-reduce (see ShmAllReduce) and apply the same optimizer step, so all
+// ToyNet replicas stay bit-identical. A crashed worker aborts the group
+// instead of hanging it.
+//
+// With publishName set, rank 0 also publishes its weights and loss curve
+// into a LiveShare segment that the GUI can attach to.
+//
+// Returns 0 on success, non-zero if setup failed or any worker failed.
+int runDataParallelTraining(const DataParallelConfig& cfg);
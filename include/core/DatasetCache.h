@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <vector>
+
+#include "DataPoint.h"
+#include "DatasetGenerator.h"
+#include "FeatureExpansion.h"
+#include "MemoryAccounting.h"
+#include "PointGrid.h"
+
+// Everything that determines a generated dataset.
+struct DatasetKey {
+    DatasetType  type      = DatasetType::TwoBlobs;
+    int          numPoints = 0;
+    float        spread    = 0.0f;
+    unsigned int seed      = 0;
+
+    bool operator==(const DatasetKey& o) const {
+        return type == o.type && numPoints == o.numPoints &&
+               spread == o.spread && seed == o.seed;
+    }
+};
+
+// Byte-bounded LRU cache of generated datasets and the structures derived
+// from them (picking grid, expanded feature columns), so switching back to
+// a recently used configuration skips generation and every rebuild.
+//
+// The cache tracks which dataset is active. Switching parks the active
+// dataset (moved, not copied) and moves the requested one out of the cache,
+// so no dataset is ever stored twice. A dataset that was edited after it
+// was generated no longer matches its key and is dropped instead of parked.
+class DatasetCache {
+public:
+    static constexpr std::size_t DefaultBudgetBytes = 64u * 1024u * 1024u;
+
+    explicit DatasetCache(std::size_t budgetBytes = DefaultBudgetBytes);
+
+    // Park the active dataset (points, grid, columns) and make `key` active.
+    // Returns true on a hit with the cached data moved into the arguments;
+    // on a miss the arguments are emptied and the caller generates the data.
+    bool switchTo(const DatasetKey& key,
+                  std::vector<DataPoint>& points,
+                  PointGrid& grid,
+                  FeatureColumns& columns);
+
+    // Park the active dataset without activating another (e.g. when
+    // switching to a streamed data source).
+    void park(std::vector<DataPoint>& points, PointGrid& grid, FeatureColumns& columns);
+
+    // The active dataset no longer matches its key.
+    void markActiveEdited();
+
+    void clear();
+
+    // Change the byte budget; evicts least recently used entries to fit.
+    void setBudget(std::size_t budgetBytes);
+    std::size_t budget() const { return m_budget; }
+
+    std::size_t bytesUsed() const { return m_bytes; }
+    std::size_t entryCount() const { return m_entries.size(); }
+    std::size_t hits() const { return m_hits; }
+    std::size_t misses() const { return m_misses; }
+
+private:
+    struct Entry {
+        DatasetKey             key;
+        std::vector<DataPoint> points;
+        PointGrid              grid;
+        FeatureColumns         columns;
+        std::size_t            bytes = 0;
+    };
+
+    void evictToBudget();
+
+    // Most recently used first. The cache holds a handful of datasets, so
+    // lookups are a linear scan.
+    std::list<Entry> m_entries;
+    std::size_t      m_budget;
+    std::size_t      m_bytes;
+    std::size_t      m_hits;
+    std::size_t      m_misses;
+    MemoryAccount    m_memory; // MemoryTag::DatasetCache, follows m_bytes
+
+    DatasetKey m_activeKey;
+    bool       m_hasActive;
+    bool       m_activeEdited;
+};
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "DataPoint.h"
 
+class ThreadPool;
+
 // Types of synthetic 2D datasets that can be generated for the demo.
 enum class DatasetType {
     TwoBlobs = 0,
@@ -20,10 +23,33 @@ constexpr int DatasetTypeCount = 5;
 // - numPoints: total number of points to generate.
 // - spread: used as either radial spread or noise amount depending on the dataset.
 // - out: vector that will be filled with DataPoint entries.
+// - seed: the same (type, numPoints, spread, seed) always yields the same points.
+// Generation is split across the shared ThreadPool.
+void generateDataset(DatasetType type,
+                     int numPoints,
+                     float spread,
+                     std::vector<DataPoint>& out,
+                     unsigned int seed = 1);
+
+// Same, split across `pool` instead of the shared one.
 void generateDataset(DatasetType type,
                      int numPoints,
                      float spread,
-                     std::vector<DataPoint>& out);
+                     std::vector<DataPoint>& out,
+                     unsigned int seed,
+                     ThreadPool& pool);
+
+// Unbounded stream of fresh samples from the same distributions, for
+// training without a stored dataset. Sample k of the stream for a given
+// (type, spread, seed) is a pure function of k, and the classes are
+// interleaved so every window of four samples is balanced. Fills
+// out[0, count) with samples first .. first + count - 1 on the calling thread.
+void generateStreamSamples(DatasetType type,
+                           float spread,
+                           unsigned int seed,
+                           std::uint64_t first,
+                           int count,
+                           DataPoint* out);
 
 // Return a pointer to a static array of dataset type names.
 // The length of the array is DatasetTypeCount.
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "AlignedAllocator.h"
+#include "DataPoint.h"
+
+// Optional input feature expansions applied in front of ToyNet's first layer.
+// Every set keeps the raw (x, y) as its first two features.
+enum class FeatureSet {
+    Raw = 0,       // (x, y)
+    Polynomial,    // (x, y, x^2, y^2, x*y)
+    Trig,          // (x, y, sin(pi x), cos(pi x), sin(pi y), cos(pi y))
+    RandomFourier  // (x, y, sqrt(2/D) * cos(w_d . p + b_d) for d < D)
+};
+
+// Number of feature sets defined above.
+constexpr int FeatureSetCount = 4;
+
+// Number of random Fourier features appended in FeatureSet::RandomFourier.
+constexpr int RandomFourierCount = 8;
+
+// Widest expansion; ToyNet sizes its input buffers with this so switching
+// feature sets never reallocates per-batch storage.
+constexpr int MaxFeatureDim = 2 + RandomFourierCount;
+
+// Number of features produced by the given set.
+int featureDim(FeatureSet set);
+
+// Expand a single (x, y) sample into `out`, which must hold featureDim(set) floats.
+void expandFeatures(FeatureSet set, float x, float y, float* out);
+
+// Expand `count` samples given as separate x and y arrays into a row-major
+// count x featureDim(set) block.
+void expandFeatureRows(FeatureSet set, const float* xs, const float* ys, int count, float* out);
+
+// Return a pointer to a static array of feature set names.
+// The length of the array is FeatureSetCount.
+const char* const* getFeatureSetNames();
+
+// Expanded features for a whole dataset, computed once and kept until the
+// dataset changes. Storage is column-major: each feature is a contiguous
+// column padded to a multiple of 16 floats so every column starts on a
+// 64-byte boundary.
+class FeatureColumns {
+public:
+    FeatureColumns();
+
+    void build(FeatureSet set, const std::vector<DataPoint>& dataset);
+    void invalidate();
+
+    // Incremental edits that mirror the dataset's: append a point, or
+    // remove point `index` by moving the last point into its slot. Columns
+    // keep spare capacity, so appends are amortized O(dim). No-ops while
+    // the cache is invalid.
+    void appendPoint(const DataPoint& p);
+    void removePointSwap(int index);
+
+    // True if the cache was built for `set` over a dataset of `count` points.
+    bool matches(FeatureSet set, int count) const;
+
+    int getDim() const;
+    int getCount() const;
+    const float* column(int feature) const;
+
+    // Heap bytes held by the columns.
+    std::size_t memoryBytes() const;
+
+    // Gather the rows at `indices` into `out` as a row-major count x dim block.
+    void gatherRows(const int* indices, int count, float* out) const;
+
+private:
+    FeatureSet m_set;
+    int        m_dim;
+    int        m_count;
+    int        m_stride;
+    bool       m_valid;
+    std::vector<float, AlignedAllocator<float>> m_values;
+};
+
+// Produce the field fragment shader for `set` from a template that contains a
+// "// @features-begin" ... "// @features-end" block. The block is replaced with
+// an INPUT_DIM constant and an expandFeatures(vec2, out float[]) function that
+// mirrors expandFeatures() above, including the baked random Fourier weights.
+std::string buildFieldFragmentSource(const std::string& templateSrc, FeatureSet set);
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <vector>
+#include "MemoryAccounting.h"
 
 class FieldVisualizer {
 public:
@@ -20,5 +20,5 @@ private:
     unsigned int m_vao;
     unsigned int m_vbo;
     bool m_dirty;
-    std::vector<float> m_vertexData;
+    MemoryAccount m_gpuMemory;
 };
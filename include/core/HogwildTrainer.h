@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "DataPoint.h"
+#include "Optimizer.h"
+#include "ToyNet.h"
+
+// Number of power-of-two staleness buckets: [0], [1], [2,3], [4,7], ...,
+// with the last bucket collecting everything larger.
+constexpr int HogwildStalenessBuckets = 10;
+
+struct HogwildStats {
+    std::uint64_t updates;          // parameter updates applied so far
+    double        updatesPerSecond; // since start()
+    float         meanStaleness;    // other updates applied while a gradient was computed
+    int           maxStaleness;
+    std::uint64_t stalenessHistogram[HogwildStalenessBuckets];
+    float         lastLoss;         // minibatch loss of the most recent update
+    float         lastAccuracy;
+};
+
+// Hogwild-style asynchronous SGD: each worker thread samples its own
+// minibatches from a private copy of the dataset, computes gradients on a
+// snapshot of the shared parameters and writes SGD / momentum updates back
+// element by element with relaxed atomics. There are no locks and no
+// barrier; concurrent writes may overwrite each other, which for small
+// dense models costs far less than synchronising every step.
+//
+// Staleness of an update is the number of other updates that landed between
+// the worker's parameter snapshot and its own write.
+class HogwildTrainer {
+public:
+    HogwildTrainer();
+    ~HogwildTrainer();
+
+    HogwildTrainer(const HogwildTrainer&) = delete;
+    HogwildTrainer& operator=(const HogwildTrainer&) = delete;
+
+    // Start `threadCount` workers from the current parameters of `net`.
+    // Returns false (and does nothing) if threads are unavailable or the
+    // dataset is empty. Adam is not supported; it falls back to plain SGD.
+    bool start(const ToyNet& net,
+               const std::vector<DataPoint>& dataset,
+               int threadCount,
+               int batchSize);
+
+    void stop();
+    bool isRunning() const;
+
+    // Picked up by the workers on their next update.
+    void setHyperparams(OptimizerType type, float learningRate, float momentum);
+
+    // Copy the current shared parameters into `net`, which must have the
+    // same shape as the network passed to start(). Does not allocate.
+    void readParameters(ToyNet& net);
+
+    // Counters from the current (or most recent) run.
+    HogwildStats stats() const;
+
+    // Default (and largest useful) worker count: ThreadPool::shared()'s
+    // concurrency, 0 if threads are unavailable. Workers are dedicated
+    // threads rather than pool tasks because they never return until
+    // stop(); as tasks they would hold every pool worker.
+    static int defaultThreadCount();
+
+private:
+    // Per-worker counters, each on its own cache line so workers never
+    // contend on instrumentation.
+    struct alignas(64) WorkerStats {
+        std::atomic<std::uint64_t> updates{0};
+        std::atomic<std::uint64_t> stalenessSum{0};
+        std::atomic<int>           stalenessMax{0};
+        std::atomic<std::uint64_t> histogram[HogwildStalenessBuckets] = {};
+        std::atomic<float>         lastLoss{0.0f};
+        std::atomic<float>         lastAccuracy{0.0f};
+    };
+
+    void workerLoop(int index, ToyNet localNet);
+
+    int m_paramCount;
+    std::unique_ptr<std::atomic<float>[]> m_params;
+    std::unique_ptr<std::atomic<float>[]> m_velocity;
+    std::vector<float>                    m_readScratch; // readParameters() staging, sized in start()
+
+    std::atomic<std::uint64_t> m_version;
+    std::atomic<bool>          m_stop;
+    std::atomic<int>           m_optimizer;
+    std::atomic<float>         m_learningRate;
+    std::atomic<float>         m_momentum;
+
+    std::vector<DataPoint>       m_dataset;
+    int                          m_batchSize;
+    int                          m_workerCount;
+    std::vector<std::thread>     m_threads;
+    std::unique_ptr<WorkerStats[]> m_workerStats;
+    std::atomic<int>             m_lastWorker;
+
+    std::chrono::steady_clock::time_point m_startTime;
+    std::chrono::steady_clock::time_point m_stopTime;
+};
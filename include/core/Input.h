@@ -6,6 +6,7 @@ struct GLFWwindow;
 struct Object2D;
 struct DataPoint;
 struct UiState;
+class PointGrid;
 
 struct MouseDebugState {
     bool  hasClick;
@@ -44,6 +45,32 @@ void handleMouseInput(GLFWwindow* window,
 // Clicks near dataset points will set UiState's probe position and selection.
 void handleProbeSelection(GLFWwindow* window,
                           const std::vector<DataPoint>& dataset,
+                          const PointGrid& grid,
                           UiState& ui,
                           bool& leftMousePressedLastFrame,
                           bool mouseOverGui);
+
+// A dataset edit requested with the mouse in point editing mode.
+struct PointEdit {
+    enum Kind {
+        None = 0,
+        Add,
+        Remove
+    };
+
+    Kind  kind  = None;
+    float x     = 0.0f;
+    float y     = 0.0f;
+    int   label = 0;  // Add
+    int   index = -1; // Remove: dataset index
+};
+
+// Point editing for online labeling: a click adds a point of class
+// ui.editLabel at the cursor, Shift+click removes the nearest point. The
+// caller applies the returned edit.
+PointEdit handlePointEditing(GLFWwindow* window,
+                             const std::vector<DataPoint>& dataset,
+                             const PointGrid& grid,
+                             const UiState& ui,
+                             bool& leftMousePressedLastFrame,
+                             bool mouseOverGui);
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Bump allocator for transient buffers. allocate() advances an offset in
+// the current block; nothing is freed individually. reset() releases
+// everything at once and, if the last cycle overflowed into extra blocks,
+// replaces them with one block large enough for the whole cycle, so a
+// steady workload settles on a single block and never calls malloc.
+// Capacity that stays mostly unused for a while is given back.
+//
+// Two instances are provided: frameArena() for the render thread, reset at
+// the end of every frame, and scratchArena(), one per thread, for work
+// that brackets its use with an ArenaScope. Memory from either must not be
+// kept past the reset / scope.
+class LinearArena {
+public:
+    explicit LinearArena(std::size_t blockBytes = 256 * 1024);
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void reset();
+
+    // Position to rewind to; see ArenaScope.
+    struct Mark {
+        std::size_t block;
+        std::size_t offset;
+    };
+    Mark mark() const;
+    void rewind(const Mark& m);
+
+    std::size_t bytesUsed() const;
+    std::size_t capacity() const;
+
+private:
+    struct Block {
+        unsigned char* data;
+        std::size_t    size;
+    };
+
+    void addBlock(std::size_t minBytes);
+    void freeBlocks();
+
+    std::vector<Block> m_blocks;
+    std::size_t        m_block;      // index of the block being filled
+    std::size_t        m_offset;     // bytes used in that block
+    std::size_t        m_blockBytes; // default size of a new block
+    std::size_t        m_peak;       // most bytes used in one cycle since the last resize
+    int                m_idleResets; // resets in a row that used under a quarter of capacity
+};
+
+// Render-thread arena, reset at the end of updateAndRenderFrame().
+LinearArena& frameArena();
+
+// Per-thread scratch arena. Use it inside an ArenaScope.
+LinearArena& scratchArena();
+
+// Rewinds an arena to where it was when the scope began.
+class ArenaScope {
+public:
+    explicit ArenaScope(LinearArena& arena = scratchArena())
+        : m_arena(arena), m_mark(arena.mark()) {}
+    ~ArenaScope() { m_arena.rewind(m_mark); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    LinearArena& arena() const { return m_arena; }
+
+private:
+    LinearArena&      m_arena;
+    LinearArena::Mark m_mark;
+};
+
+// STL allocator over a LinearArena; deallocate() is a no-op.
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    explicit ArenaAllocator(LinearArena& arena) noexcept : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(std::size_t n) { return arena->allocateArray<T>(n); }
+    void deallocate(T*, std::size_t) noexcept {}
+
+    LinearArena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return a.arena != b.arena;
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FeatureExpansion.h"
+#include "ToyNet.h"
+
+// Largest flattened ToyNet (widest feature set).
+constexpr int LiveMaxParams = ToyNet::Hidden1 * ToyNet::MaxInputDim + ToyNet::Hidden1 +
+                              ToyNet::Hidden2 * ToyNet::Hidden1 + ToyNet::Hidden2 +
+                              ToyNet::OutputDim * ToyNet::Hidden2 + ToyNet::OutputDim;
+
+// Loss/accuracy points kept in the shared ring.
+constexpr int LiveHistorySize = 4096;
+
+// Dataset description published alongside the weights, so a viewer can
+// regenerate exactly the points the trainer uses (generation is
+// deterministic per seed).
+struct LiveDatasetInfo {
+    int          datasetIndex = 0;
+    int          numPoints    = 0;
+    float        spread       = 0.0f;
+    unsigned int seed         = 0;
+
+    bool operator==(const LiveDatasetInfo& o) const {
+        return datasetIndex == o.datasetIndex && numPoints == o.numPoints &&
+               spread == o.spread && seed == o.seed;
+    }
+    bool operator!=(const LiveDatasetInfo& o) const { return !(*this == o); }
+};
+
+// Shared-memory layout; defined in LiveShare.cpp.
+struct LiveSegment;
+
+// Reader-side view of a live segment. read() updates it incrementally:
+// the history is not mirrored here, only the points published since the
+// previous read, for the caller to append to its own.
+struct LiveSnapshot {
+    int             writerPid  = 0;
+    bool            finished   = false;
+    int             step       = 0;
+    float           loss       = 0.0f;
+    float           accuracy   = 0.0f;
+    FeatureSet      featureSet = FeatureSet::Raw;
+    LiveDatasetInfo dataset;
+    std::vector<float> params;
+
+    // History points ever published; only grows.
+    int historyTotal = 0;
+
+    // The points published since the previous read(), oldest first: the
+    // last newLoss.size() of historyTotal. At most LiveHistorySize, so
+    // points can be missed if reads are further apart than that.
+    std::vector<float> newLoss;
+    std::vector<float> newAccuracy;
+};
+
+// Publishes a training run into a POSIX shared-memory segment (Linux).
+//
+// The segment is guarded by a seqlock: the single writer bumps a sequence
+// number to odd, writes, and bumps it to even. It never waits for readers,
+// so attaching a viewer cannot slow training down; readers retry if the
+// sequence changed while they were copying.
+class LivePublisher {
+public:
+    LivePublisher();
+    ~LivePublisher();
+
+    LivePublisher(const LivePublisher&) = delete;
+    LivePublisher& operator=(const LivePublisher&) = delete;
+
+    bool create(const std::string& name, const LiveDatasetInfo& dataset);
+    void destroy();
+
+    // Publish the current weights and one history point. Cost is a copy of
+    // the parameters plus two floats, independent of the history length.
+    void publish(const ToyNet& net, int step, float loss, float accuracy);
+
+    // Flag the run as complete (the last published state stays readable).
+    void finish();
+
+private:
+    void beginWrite();
+    void endWrite();
+
+    LiveSegment*  m_segment;
+    std::uint32_t m_sequence;
+    std::string   m_name;
+};
+
+// Maps a segment created by LivePublisher read-only.
+class LiveSubscriber {
+public:
+    LiveSubscriber();
+    ~LiveSubscriber();
+
+    LiveSubscriber(const LiveSubscriber&) = delete;
+    LiveSubscriber& operator=(const LiveSubscriber&) = delete;
+
+    bool attach(const std::string& name);
+    void detach();
+    bool isAttached() const;
+
+    // Bring `out` up to date. Returns true if anything changed since the
+    // previous call. Only history points added since then are copied, so
+    // the cost does not grow with the history.
+    bool read(LiveSnapshot& out);
+
+private:
+    const LiveSegment* m_segment;
+    std::uint32_t      m_lastSequence;
+    int                m_historyRead;
+    std::vector<float> m_scratchParams;
+    std::vector<float> m_scratchLoss;
+    std::vector<float> m_scratchAccuracy;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+// Leveled, asynchronous logging for runtime paths.
+//
+// NN_LOG_INFO("[Pick] Selected %s", name) formats into a fixed-size record
+// in a ring buffer owned by the calling thread; nothing is locked, flushed
+// or allocated on the way (the ring itself is allocated on a thread's
+// first message). A background thread drains all rings every few
+// milliseconds, orders the records by time and writes them to stderr, or
+// to the file named by NNDEMO_LOG_FILE. When a ring is full the message is
+// dropped and counted, and the flusher reports the count.
+//
+// Levels below NN_LOG_MIN_LEVEL (Debug in debug builds, Info otherwise)
+// are compiled out; NNDEMO_LOG_LEVEL (debug, info, warn, error, off)
+// raises the threshold at run time. Errors wake the flusher immediately,
+// and logFlush() writes everything logged so far before returning.
+//
+// Without thread support (WebAssembly builds without pthreads) messages
+// are written synchronously.
+
+enum class LogLevel {
+    Debug = 0,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+#ifndef NN_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define NN_LOG_MIN_LEVEL 1
+#else
+#define NN_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NN_LOG_PRINTF_FORMAT(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+#define NN_LOG_PRINTF_FORMAT(fmt, args)
+#endif
+
+// Longest message kept, including the terminator; longer ones are cut.
+constexpr int LogMessageBytes = 1000;
+
+// Records per thread ring.
+constexpr int LogRingRecords = 64;
+
+bool logEnabled(LogLevel level);
+void setLogLevel(LogLevel level);
+LogLevel logLevel();
+
+void logMessage(LogLevel level, const char* format, ...) NN_LOG_PRINTF_FORMAT(2, 3);
+
+// Write every message logged so far (by any thread) before returning.
+void logFlush();
+
+#define NN_LOG(level, ...)                                          \
+    do {                                                            \
+        if constexpr (static_cast<int>(level) >= NN_LOG_MIN_LEVEL) { \
+            if (logEnabled(level)) {                                \
+                logMessage((level), __VA_ARGS__);                   \
+            }                                                       \
+        }                                                           \
+    } while (0)
+
+#define NN_LOG_DEBUG(...) NN_LOG(LogLevel::Debug, __VA_ARGS__)
+#define NN_LOG_INFO(...)  NN_LOG(LogLevel::Info, __VA_ARGS__)
+#define NN_LOG_WARN(...)  NN_LOG(LogLevel::Warn, __VA_ARGS__)
+#define NN_LOG_ERROR(...) NN_LOG(LogLevel::Error, __VA_ARGS__)
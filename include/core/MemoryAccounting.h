@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+
+// What a block of memory is spent on.
+enum class MemoryTag {
+    Datasets,       // active points and their picking grid
+    DatasetCache,   // parked datasets (DatasetCache)
+    TrainingData,   // trainer's copies: feature columns, quantized points, reservoir
+    Model,          // parameters, gradients and activation buffers
+    OptimizerState, // momentum / Adam moments
+    Histories,      // loss and accuracy history
+    GpuBuffers,     // vertex buffers, estimated from their allocated size
+    FrameArena,     // transient per-frame staging
+    Count
+};
+
+constexpr int MemoryTagCount = static_cast<int>(MemoryTag::Count);
+
+// Process-wide tally of bytes per tag, fed by MemoryAccounts. Budgets are
+// optional (0 = none); subsystems that can give memory back check
+// overBudget() and evict (see enforceMemoryBudgets in Scene.cpp), the
+// others are only flagged in the HUD and dump.
+//
+// Budgets can be set from the environment, e.g.
+//   NNDEMO_MEMORY_BUDGETS=cache=32M,histories=64K
+// with the tag names from tagKey() and K/M/G suffixes.
+class MemoryRegistry {
+public:
+    static MemoryRegistry& shared();
+
+    std::size_t bytes(MemoryTag tag) const;
+    std::size_t totalBytes() const;
+    int accountCount(MemoryTag tag) const;
+
+    void setBudget(MemoryTag tag, std::size_t bytes);
+    std::size_t budget(MemoryTag tag) const;
+    bool overBudget(MemoryTag tag) const;
+
+    // Table of every tag with its bytes, accounts and budget.
+    void dump(std::ostream& os) const;
+
+    static const char* tagName(MemoryTag tag);
+    static const char* tagKey(MemoryTag tag);
+
+private:
+    friend class MemoryAccount;
+
+    MemoryRegistry();
+    void loadBudgetsFromEnv();
+
+    std::atomic<std::size_t> m_bytes[MemoryTagCount];
+    std::atomic<int>         m_accounts[MemoryTagCount];
+    std::atomic<std::size_t> m_budgets[MemoryTagCount];
+};
+
+// One subsystem's share of a tag. The owner calls set() whenever its size
+// changes (or once per frame); the registry total follows and the share is
+// removed when the account is destroyed.
+class MemoryAccount {
+public:
+    explicit MemoryAccount(MemoryTag tag);
+    ~MemoryAccount();
+
+    MemoryAccount(const MemoryAccount&) = delete;
+    MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+    void set(std::size_t bytes);
+    std::size_t bytes() const { return m_bytes; }
+
+private:
+    MemoryRegistry& m_registry;
+    MemoryTag       m_tag;
+    std::size_t     m_bytes;
+};
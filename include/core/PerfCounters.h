@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Event counts accumulated over a frame.
+enum class PerfCounter {
+    UploadBytes,   // buffer data and uniforms sent to the GPU
+    TrainSteps,    // optimizer steps (minibatches)
+    TrainSamples,  // samples those steps consumed
+    Allocations,   // heap allocations, all threads (allocation-tracking builds)
+    AllocBytes,
+    Count
+};
+
+// CPU time spent per subsystem in a frame.
+enum class PerfSection {
+    Ui,           // ImGui frame, input and draw-data submission
+    Training,     // stepping, auto-train and evaluation
+    Dataset,      // regeneration / cache switch and point upload
+    FieldUpdate,  // decision-field state update
+    Render,       // scene draw calls
+    Present,      // buffer swap and event polling
+    Count
+};
+
+constexpr int PerfCounterCount = static_cast<int>(PerfCounter::Count);
+constexpr int PerfSectionCount = static_cast<int>(PerfSection::Count);
+
+// Frames of history kept for the HUD, about four seconds at 60 Hz.
+constexpr int PerfHistoryFrames = 240;
+
+// Aggregate over the frames currently in the history.
+struct PerfSummary {
+    int    frames;
+    double seconds;
+    float  meanFrameMs;
+    float  p50FrameMs;
+    float  p95FrameMs;
+    float  p99FrameMs;
+    float  maxFrameMs;
+    double perSecond[PerfCounterCount];
+    double perFrame[PerfCounterCount];
+    double lastFrame[PerfCounterCount];
+    float  sectionMs[PerfSectionCount]; // mean per frame
+};
+
+// Central registry of per-frame performance counters. Counters may be
+// bumped from any thread (relaxed atomics); sections are timed on the
+// render thread, which calls endFrame() once per frame to close the
+// frame and push it into a fixed ring of history.
+class PerfRegistry {
+public:
+    PerfRegistry();
+
+    PerfRegistry(const PerfRegistry&) = delete;
+    PerfRegistry& operator=(const PerfRegistry&) = delete;
+
+    // Process-wide registry.
+    static PerfRegistry& shared();
+
+    void add(PerfCounter counter, std::uint64_t amount) {
+        m_counters[static_cast<int>(counter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void addTime(PerfSection section, double ms);
+
+    void endFrame();
+
+    // Frame times in ring order; pass historyOffset() as the plot offset
+    // to draw them oldest first.
+    const float* frameTimes() const { return m_frameMs; }
+    int historyCount() const { return m_count; }
+    int historyOffset() const { return m_count < PerfHistoryFrames ? 0 : m_next; }
+
+    // Distribution of frame times: bucket i counts frames in
+    // [i * bucketMs, (i + 1) * bucketMs); the last bucket is open-ended.
+    void frameTimeHistogram(float* buckets, int bucketCount, float bucketMs) const;
+
+    PerfSummary summarize() const;
+
+    // Duration of the last frame that touched the dataset section.
+    float lastDatasetMs() const { return m_lastDatasetMs; }
+
+    static const char* sectionName(PerfSection section);
+
+private:
+    std::atomic<std::uint64_t> m_counters[PerfCounterCount];
+    double m_sectionMs[PerfSectionCount];
+
+    float         m_frameMs[PerfHistoryFrames];
+    float         m_historySectionMs[PerfHistoryFrames][PerfSectionCount];
+    std::uint64_t m_historyCounters[PerfHistoryFrames][PerfCounterCount];
+    int           m_next;
+    int           m_count;
+    float         m_lastDatasetMs;
+    bool          m_started;
+    std::uint64_t m_allocations;
+    std::uint64_t m_allocBytes;
+
+    std::chrono::steady_clock::time_point m_frameStart;
+};
+
+// Splits a frame into consecutive sections: lap() charges the time since
+// the previous lap (or construction) to a section and restarts the clock.
+class PerfLapTimer {
+public:
+    PerfLapTimer()
+        : m_start(std::chrono::steady_clock::now()) {}
+
+    void lap(PerfSection section) {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const std::chrono::duration<double, std::milli> elapsed = now - m_start;
+        PerfRegistry::shared().addTime(section, elapsed.count());
+        m_start = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Time spent in each phase of a training step (CMake option
+// NNDEMO_PHASE_TIMING, which defines NN_PHASE_TIMING). ToyNet splits
+// trainBatch and the optimizer update with TrainPhaseTimer laps; the time
+// is summed per phase for the whole process.
+//
+// Forward, loss and backward are timed per sample chunk on whichever
+// thread runs the chunk, so with a thread pool they add up CPU time across
+// threads rather than wall time. Input, reduce and optimizer run on the
+// calling thread. Without NN_PHASE_TIMING the laps compile to nothing and
+// the totals stay at zero.
+
+enum class TrainPhase {
+    Input,      // feature expansion / copy into the input activations
+    Forward,    // hidden layers and logits
+    Loss,       // softmax, loss and accuracy
+    Backward,   // gradients into the per-thread partials
+    Reduce,     // zeroing, summing and averaging the partials
+    Optimizer,  // optimizerApplyUpdate
+    Count
+};
+
+constexpr int TrainPhaseCount = static_cast<int>(TrainPhase::Count);
+
+struct TrainPhaseTimes {
+    std::uint64_t ns[TrainPhaseCount];
+    std::uint64_t steps; // optimizer updates over the same span
+};
+
+// True if the phase laps are compiled in.
+bool phaseTimingEnabled();
+
+// Totals since the process started.
+TrainPhaseTimes trainPhaseTotals();
+
+// `later` minus `earlier`, e.g. to time a span between two snapshots.
+TrainPhaseTimes trainPhaseDelta(const TrainPhaseTimes& later, const TrainPhaseTimes& earlier);
+
+void addTrainPhaseTime(TrainPhase phase, std::uint64_t ns);
+void countTrainPhaseStep();
+
+const char* trainPhaseName(TrainPhase phase);
+
+// Like PerfLapTimer: lap() charges the time since the previous lap (or
+// construction, or restart()) to a phase.
+class TrainPhaseTimer {
+public:
+#ifdef NN_PHASE_TIMING
+    TrainPhaseTimer()
+        : m_start(std::chrono::steady_clock::now()) {}
+
+    void lap(TrainPhase phase) {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        addTrainPhaseTime(phase, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count()));
+        m_start = now;
+    }
+
+    void restart() { m_start = std::chrono::steady_clock::now(); }
+
+    // One optimizer update finished; the per-step means divide by these.
+    void countStep() { countTrainPhaseStep(); }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+#else
+    void lap(TrainPhase) {}
+    void restart() {}
+    void countStep() {}
+#endif
+};
@@ -5,20 +5,41 @@
 #include <vector>
 
 #include "DataPoint.h"
+#include "MemoryAccounting.h"
+
+// Vertex layout of PointCloud's buffer.
+enum class PointVertexFormat {
+    Float = 0, // float x, y, label: 12 bytes per point
+    Packed     // normalized short x, y, byte label: 8 bytes per point
+};
+
+// Positions are stored divided by this, so the normalized shorts of the
+// packed format cover [-2, 2]; point.vert scales them back.
+constexpr float PointPositionExtent = 2.0f;
 
 class PointCloud {
 public:
     PointCloud();
 
-    void init(int maxPoints);
+    void init(int maxPoints, PointVertexFormat format = PointVertexFormat::Packed);
     void upload(const std::vector<DataPoint>& data);
+
+    // Re-upload only points [first, first + count) (e.g. after appending
+    // or removing a single point).
+    void uploadRange(const std::vector<DataPoint>& data, std::size_t first, std::size_t count);
     void draw(std::size_t pointCount) const;
     void shutdown();
 
+    PointVertexFormat getFormat() const { return m_format; }
+
 private:
-    unsigned int m_vao;
-    unsigned int m_vbo;
-    int          m_maxPoints;
+    std::size_t vertexSize() const;
+
+    unsigned int      m_vao;
+    unsigned int      m_vbo;
+    int               m_maxPoints;
+    PointVertexFormat m_format;
+    MemoryAccount     m_gpuMemory;
 };
 
 class GridAxes {
@@ -41,4 +62,6 @@ private:
 
     std::size_t m_gridVertexCount; // number of vec2 vertices
     std::size_t m_axisVertexCount; // number of vec2 vertices
+
+    MemoryAccount m_gpuMemory;
 };
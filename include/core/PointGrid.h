@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "DataPoint.h"
+
+// Uniform grid over the [-1, 1] x [-1, 1] plot area for picking points
+// near the cursor without scanning the whole dataset. Points outside the
+// plot area go into the border cells.
+//
+// The grid stores dataset indices and supports the same edits as the
+// dataset itself: append, and removal by moving the last point into the
+// freed slot, so both stay in step without a rebuild.
+class PointGrid {
+public:
+    static constexpr int CellsPerSide = 32;
+
+    PointGrid();
+
+    void build(const std::vector<DataPoint>& points);
+    void clear();
+
+    // Point `index` was appended at (x, y).
+    void insert(int index, float x, float y);
+
+    // Drop point `index` at (x, y) from the grid without renumbering any
+    // other point, e.g. before re-inserting it at a new position.
+    void remove(int index, float x, float y);
+
+    // Point `index` at (x, y) was removed and the last point (`lastIndex`,
+    // at lastX, lastY) moved into its slot. Pass lastIndex == index when the
+    // removed point was the last one.
+    void removeSwap(int index, float x, float y, int lastIndex, float lastX, float lastY);
+
+    // Index of the point in `points` closest to (x, y) within `radius`, or -1.
+    int nearest(const std::vector<DataPoint>& points, float x, float y, float radius) const;
+
+    // Heap bytes held by the cell lists.
+    std::size_t memoryBytes() const;
+
+private:
+    static int cellCoord(float v);
+    static int cellOf(float x, float y);
+
+    std::vector<std::vector<int>> m_cells;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+
+struct FrameContext;
+
+// Scripted render benchmark (NeuralNetDemo --bench-render).
+//
+// Runs a fixed scene for a fixed number of frames with vsync off: the
+// chosen dataset and point count, auto-train on or off, and a probe that
+// sweeps a fixed path and selects the nearest point, as a click would. The
+// window is hidden unless --show is given, and the ImGui layout is not
+// loaded from or saved to imgui.ini, so runs are comparable. After a
+// warm-up, frame times (CPU wall time per frame, swap included) and GPU
+// time per render pass (GpuTimers.h) are recorded; p50/p95/p99 frame
+// times and mean/max pass times are printed, and optionally written as
+// JSON.
+//
+// For machines without a GPU, run under Mesa's software rasterizer, e.g.
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./NeuralNetDemo --bench-render
+// --egl creates the context through EGL instead of GLX.
+//
+// Desktop builds only.
+
+struct RenderBenchConfig {
+    bool        enabled      = false;
+    int         frames       = 600;
+    int         warmupFrames = 60;
+    int         width        = 1280;
+    int         height       = 720;
+    int         datasetIndex = 4; // DatasetType::Spirals
+    int         numPoints    = 2000;
+    bool        autoTrain    = true;
+    bool        moveProbe    = true;
+    bool        showWindow   = false;
+    bool        egl          = false;
+    std::string jsonPath;
+};
+
+// Parse the command line. `config.enabled` is set by --bench-render; the
+// other options require it. Returns false (after printing usage) on an
+// unknown or malformed option.
+bool parseRenderBenchArgs(int argc, char** argv, RenderBenchConfig& config);
+
+// Run the benchmark on the initialized scene. Returns the process exit code.
+int runRenderBench(const RenderBenchConfig& config, FrameContext& ctx);
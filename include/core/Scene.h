@@ -1,18 +1,30 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
+#include "DatasetCache.h"
 #include "DatasetGenerator.h"
+#include "FeatureExpansion.h"
 #include "ControlPanel.h"
 #include "PlotGeometry.h"
 #include "FieldVisualizer.h"
 #include "Trainer.h"
 #include "DataPoint.h"
 #include "Input.h"
+#include "PointGrid.h"
 
 struct GLFWwindow;
 class ShaderProgram;
 
+// GLSL sources kept after startup so the field shader can be regenerated
+// when the network's input feature set changes.
+struct FieldShaderSources {
+    std::string vertexSrc;
+    std::string fragmentTemplate;
+    FeatureSet  featureSet = FeatureSet::Raw;
+};
+
 struct FrameContext {
     GLFWwindow* window;
     ShaderProgram& pointShader;
@@ -23,15 +35,18 @@ struct FrameContext {
     int colorClass1Location;
     int selectedIndexLocation;
     int gridColorLocation;
-    int fieldW1Location;
-    int fieldB1Location;
-    int fieldW2Location;
-    int fieldB2Location;
-    int fieldW3Location;
-    int fieldB3Location;
+    int& fieldW1Location;
+    int& fieldB1Location;
+    int& fieldW2Location;
+    int& fieldB2Location;
+    int& fieldW3Location;
+    int& fieldB3Location;
+    FieldShaderSources& fieldSources;
     UiState& ui;
     std::vector<DataPoint>& dataset;
     PointCloud& pointCloud;
+    PointGrid& pointGrid;
+    DatasetCache& datasetCache;
     GridAxes& gridAxes;
     FieldVisualizer& fieldVis;
     Trainer& trainer;
@@ -44,8 +59,28 @@ void initSceneCommon(DatasetType currentDataset,
                      int& maxPoints,
                      std::vector<DataPoint>& dataset,
                      PointCloud& pointCloud,
+                     PointGrid& pointGrid,
+                     DatasetCache& datasetCache,
                      GridAxes& gridAxes,
                      FieldVisualizer& fieldVis,
                      bool& leftMousePressedLastFrame);
 
+// Make `key` the active dataset: restore it and its derived structures from
+// the cache if it was used recently, otherwise generate it. Resets the
+// trainer for the new data. The caller uploads the points for drawing.
+void activateDataset(const DatasetKey& key,
+                     std::vector<DataPoint>& dataset,
+                     PointGrid& pointGrid,
+                     DatasetCache& datasetCache,
+                     Trainer& trainer);
+
+// Look up the field shader's weight/bias uniform locations.
+void queryFieldUniformLocations(const ShaderProgram& fieldShader,
+                                int& fieldW1Location,
+                                int& fieldB1Location,
+                                int& fieldW2Location,
+                                int& fieldB2Location,
+                                int& fieldW3Location,
+                                int& fieldB3Location);
+
 void updateAndRenderFrame(FrameContext& ctx);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Sum all-reduce of a float vector across cooperating processes through a
+// POSIX shared-memory segment (Linux only).
+//
+// Each call is a reduce-scatter followed by an all-gather: every rank copies
+// its vector into its own slot, then sums one contiguous chunk across all
+// slots (always in rank order, so the result is identical on every rank and
+// run), then copies the full result back. Phases are separated by a
+// process-shared futex barrier.
+//
+// The launcher creates the segment before fork(); children inherit the
+// mapping and call setRank(). If a worker dies, the launcher calls abort()
+// so the survivors fail out of allReduceSum() instead of waiting forever.
+class ShmAllReduce {
+public:
+    ShmAllReduce();
+    ~ShmAllReduce();
+
+    ShmAllReduce(const ShmAllReduce&) = delete;
+    ShmAllReduce& operator=(const ShmAllReduce&) = delete;
+
+    // Create and map a segment for `ranks` processes reducing `count` floats.
+    bool create(const std::string& name, int ranks, int count);
+
+    // Unmap, and unlink the segment if this process created it.
+    void destroy();
+
+    void setRank(int rank);
+    int  getRank() const;
+    int  getRanks() const;
+
+    // Replace data[0, count) with its sum over all ranks. Returns false if
+    // the group was aborted.
+    bool allReduceSum(float* data);
+
+    // Mark the group failed and wake every waiting rank.
+    void abort();
+    bool isAborted() const;
+
+private:
+    struct Header;
+
+    bool barrier();
+
+    Header*     m_header;
+    float*      m_slots;     // ranks x stride
+    float*      m_results;   // 2 x stride, alternating between calls
+    int         m_ranks;
+    int         m_count;
+    int         m_stride;
+    int         m_rank;
+    unsigned    m_calls;
+    std::size_t m_mappedSize;
+    std::string m_name;
+    bool        m_owner;
+    int         m_ownerPid;
+};
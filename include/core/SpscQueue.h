@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Capacity must be a power of two; one slot is never used, so at
+// most Capacity - 1 items are queued.
+//
+// The head (written by the consumer) and tail (written by the producer)
+// live on separate cache lines, and each side caches the other's index so
+// the common case touches only its own line.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue()
+        : m_tail(0)
+        , m_cachedHead(0)
+        , m_head(0)
+        , m_cachedTail(0)
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side. Returns false if the queue is full.
+    bool tryPush(const T& value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t next = (tail + 1) & kMask;
+        if (next == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (next == m_cachedHead) {
+                return false;
+            }
+        }
+        m_items[tail] = value;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty.
+    bool tryPop(T& out)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+        out = m_items[head];
+        m_head.store((head + 1) & kMask, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently; exact once both sides are idle.
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    // Only valid while neither side is running.
+    void clear()
+    {
+        m_tail.store(0, std::memory_order_relaxed);
+        m_head.store(0, std::memory_order_relaxed);
+        m_cachedHead = 0;
+        m_cachedTail = 0;
+    }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+
+    alignas(64) std::atomic<std::size_t> m_tail;
+    std::size_t m_cachedHead;
+
+    alignas(64) std::atomic<std::size_t> m_head;
+    std::size_t m_cachedTail;
+
+    alignas(64) T m_items[Capacity];
+};
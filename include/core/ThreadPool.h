@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskGroup;
+
+// Persistent work-stealing thread pool shared by every CPU subsystem
+// (dataset generation, training, evaluation). Each worker
+// owns a deque: it pushes and pops its own work at the back while idle
+// workers steal from the front of other deques. Threads that are not part
+// of the pool (e.g. the render thread) help execute tasks while they wait,
+// so the pool never needs more workers than cores.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // workerCount may be 0, in which case all work runs inline on the caller.
+    explicit ThreadPool(int workerCount, bool pinThreads = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool. Uses NNDEMO_THREADS workers if that environment
+    // variable is set, otherwise hardware_concurrency() - 1 (the calling
+    // thread is the remaining worker). NNDEMO_PIN_THREADS=1 pins worker i
+    // to core i + 1 on Linux.
+    static ThreadPool& shared();
+
+    int workerCount() const;
+
+    // Threads that can run tasks at once: the workers plus the caller.
+    int concurrency() const;
+
+    // Index of the calling thread in [0, workerCount()), or -1 if the
+    // caller is not one of this pool's workers.
+    int currentWorkerIndex() const;
+
+    // Split [begin, end) into chunks of at most `grain` items and call
+    // fn(chunkBegin, chunkEnd) for each one, returning once all chunks are
+    // done. The calling thread processes chunks too. Chunks may run in any
+    // order and on any thread.
+    template <typename Fn>
+    void parallelFor(int begin, int end, int grain, Fn&& fn);
+
+private:
+    friend class TaskGroup;
+
+    struct TaskItem {
+        Task       fn;
+        TaskGroup* group;
+    };
+
+    struct Worker {
+        std::mutex           mutex;
+        std::deque<TaskItem> tasks;
+        std::thread          thread;
+    };
+
+    void submit(Task task, TaskGroup* group);
+    bool tryRunOne(TaskGroup* group);
+    bool popTask(int selfIndex, TaskItem& out);
+    bool popGroupTask(int selfIndex, TaskGroup* group, TaskItem& out);
+    void runTask(TaskItem& item);
+    void workerLoop(int index);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex              m_sleepMutex;
+    std::condition_variable m_sleepCv;
+    std::atomic<int>        m_queued;
+    std::atomic<unsigned>   m_nextQueue;
+    bool                    m_stop;
+};
+
+// A set of tasks that can be waited on together. wait() (and the
+// destructor) run the group's own queued tasks on the calling thread
+// instead of blocking, which keeps nested parallelism deadlock-free. They
+// never pick up another group's tasks, so a waiting caller only ever runs
+// work it submitted itself.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::shared());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(ThreadPool::Task task);
+    void wait();
+
+private:
+    friend class ThreadPool;
+
+    ThreadPool&      m_pool;
+    std::atomic<int> m_pending;
+};
+
+template <typename Fn>
+void ThreadPool::parallelFor(int begin, int end, int grain, Fn&& fn)
+{
+    if (end <= begin) {
+        return;
+    }
+    if (grain < 1) {
+        grain = 1;
+    }
+    if (m_workers.empty() || end - begin <= grain) {
+        fn(begin, end);
+        return;
+    }
+
+    TaskGroup group(*this);
+    for (int b = begin + grain; b < end; b += grain) {
+        const int e = std::min(b + grain, end);
+        group.run([&fn, b, e] { fn(b, e); });
+    }
+    fn(begin, std::min(begin + grain, end));
+    group.wait();
+}
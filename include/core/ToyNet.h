@@ -3,8 +3,11 @@
 #include <vector>
 
 #include "DataPoint.h"
+#include "FeatureExpansion.h"
 #include "Optimizer.h"
 
+class ThreadPool;
+
 enum class InitMode {
     Zero = 0,
     HeUniform = 1,
@@ -13,18 +16,36 @@ enum class InitMode {
 
 struct ToyNet {
 public:
-    static constexpr int InputDim  = 2;
-    static constexpr int Hidden1   = 4;
-    static constexpr int Hidden2   = 8;
-    static constexpr int OutputDim = 2;
-    static constexpr int MaxBatch  = 256;
+    static constexpr int InputDim    = 2;              // raw (x, y) input
+    static constexpr int MaxInputDim = MaxFeatureDim;  // widest expanded input
+    static constexpr int Hidden1     = 4;
+    static constexpr int Hidden2     = 8;
+    static constexpr int OutputDim   = 2;
+    static constexpr int MaxBatch    = 256;
+
+    // Samples per block in deterministic reduction mode.
+    static constexpr int DeterministicBlock = 16;
 
     ToyNet();
 
+    // Train on `pool` instead of ThreadPool::shared().
+    explicit ToyNet(ThreadPool& pool);
+
     void resetParameters(unsigned int seed = 1);
 
     float trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy);
 
+    // Train on already-expanded inputs: `features` is a row-major
+    // count x getInputDim() block (e.g. gathered from FeatureColumns).
+    float trainBatchFeatures(const float* features,
+                             const int* labels,
+                             int count,
+                             float& outAccuracy);
+
+    // Forward and backward pass only: leaves the batch-averaged gradients
+    // in place (see copyGradientsTo) without updating any parameters.
+    float computeGradients(const std::vector<DataPoint>& batch, float& outAccuracy);
+
     void forwardSingleWithActivations(float x, float y,
                                       float& p0, float& p1,
                                       float* outA1,
@@ -38,9 +59,48 @@ public:
     void setInitMode(InitMode mode);
     InitMode getInitMode() const;
 
+    // Select the input expansion. This reshapes W1, so call
+    // resetParameters() afterwards.
+    void setFeatureSet(FeatureSet set);
+    FeatureSet getFeatureSet() const;
+    int getInputDim() const;
+
     void setOptimizer(OptimizerType type);
     void setOptimizerHyperparams(float momentum, float beta1, float beta2, float eps);
 
+    // Split large batches across ThreadPool::shared() (default on). Turned
+    // off for networks that already run on their own dedicated thread.
+    // Only one thread outside the pool may train a given network at a time.
+    void setParallelTraining(bool enabled);
+
+    // Deterministic mode sums gradients over fixed DeterministicBlock-sample
+    // blocks in a fixed tree order, so a training step is bit-identical for
+    // any number of threads. The default (fast) mode reduces one partial per
+    // thread, and its rounding depends on scheduling.
+    void setDeterministicReduction(bool enabled);
+    bool getDeterministicReduction() const;
+
+    // Pool used for parallel training (ThreadPool::shared() by default).
+    void setThreadPool(ThreadPool& pool);
+
+    // All parameters flattened in W1, b1, W2, b2, W3, b3 order.
+    static int parameterCountFor(FeatureSet set);
+    int  getParameterCount() const;
+    void copyParametersTo(float* out) const;
+    void copyParametersFrom(const float* in);
+
+    // Gradients from the last training step, in the same flattened order.
+    void copyGradientsTo(float* out) const;
+
+    // Run one optimizer step with externally supplied (e.g. all-reduced)
+    // gradients in the flattened order above.
+    void applyGradients(const float* grads);
+
+    // Heap bytes of parameters, gradients, per-thread gradient slots and
+    // the MaxBatch-sized activation buffers; and of the optimizer moments.
+    std::size_t modelMemoryBytes() const;
+    std::size_t optimizerMemoryBytes() const;
+
     const std::vector<float>& getW1() const;
     const std::vector<float>& getB1() const;
     const std::vector<float>& getW2() const;
@@ -49,9 +109,35 @@ public:
     const std::vector<float>& getB3() const;
 
 private:
+    // Gradient and loss partials accumulated by one thread during trainBatch.
+    struct GradientSlot {
+        std::vector<float> dW1;
+        std::vector<float> db1;
+        std::vector<float> dW2;
+        std::vector<float> db2;
+        std::vector<float> dW3;
+        std::vector<float> db3;
+        float lossSum = 0.0f;
+        int   correct = 0;
+    };
+
+    float trainFromInputs(int batchSize, float& outAccuracy);
+    float gradientsFromInputs(int batchSize, float& outAccuracy);
+    void  applyOptimizerStep();
+    void  forwardBackwardRange(int begin, int end, GradientSlot& g);
+
+    const GradientSlot& accumulateFast(int batchSize);
+    const GradientSlot& accumulateDeterministic(int batchSize);
+    void resizeSlot(GradientSlot& slot) const;
+    static void zeroSlot(GradientSlot& slot);
+    static void addSlot(GradientSlot& dst, const GradientSlot& src);
+
     InitMode     m_initMode;
     float         m_learningRate;
 
+    FeatureSet    m_featureSet;
+    int           m_inputDim;
+
     OptimizerType m_optimizerType;
     float         m_momentum;
     float         m_adamBeta1;
@@ -59,6 +145,10 @@ private:
     float         m_adamEps;
     int           m_adamStep;
 
+    bool          m_parallelTraining;
+    bool          m_deterministic;
+    ThreadPool*   m_pool;
+
     std::vector<float> m_W1;
     std::vector<float> m_b1;
     std::vector<float> m_W2;
@@ -67,6 +157,7 @@ private:
     std::vector<float> m_b3;
 
     std::vector<float> m_a0;
+    std::vector<int>   m_labels;
     std::vector<float> m_z1;
     std::vector<float> m_a1;
     std::vector<float> m_z2;
@@ -81,6 +172,9 @@ private:
     std::vector<float> m_dW3;
     std::vector<float> m_db3;
 
+    std::vector<GradientSlot> m_gradSlots;   // one per pool thread (fast mode)
+    std::vector<GradientSlot> m_blockSlots;  // one per sample block (deterministic mode)
+
     std::vector<float> m_mW1;
     std::vector<float> m_mb1;
     std::vector<float> m_mW2;
@@ -1,8 +1,19 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
+#include "Augmentation.h"
+#include "BatchPipeline.h"
 #include "DataPoint.h"
+#include "DatasetGenerator.h"
+#include "FeatureExpansion.h"
+#include "HogwildTrainer.h"
+#include "LiveShare.h"
+#include "MemoryAccounting.h"
+#include "PhaseTimer.h"
+#include "QuantizedPoints.h"
 #include "ToyNet.h"
 
 struct Trainer {
@@ -23,10 +34,51 @@ struct Trainer {
 
     InitMode initMode;
 
+    // Input expansion fed to the first layer. Changing it requires
+    // resetForNewDataset() because the first layer changes shape.
+    FeatureSet featureSet;
+
+    // Reduce gradients in a fixed order so results do not depend on the
+    // number of threads (see ToyNet::setDeterministicReduction).
+    bool deterministic;
+
+    // Auto-train with lock-free asynchronous workers instead of one
+    // synchronous batch per frame. epochCount then counts worker updates.
+    bool hogwild;
+    int  hogwildThreads;
+
+    // Assemble batches ahead of time on a producer thread (BatchPipeline).
+    // Points are then visited in a reshuffled order on every pass instead
+    // of sequentially.
+    bool prefetch;
+
+    // Train on fresh samples drawn for every batch from the source set with
+    // setStreamSource() instead of on a stored dataset. The points shown are
+    // a reservoir sample of the stream (streamReservoir()).
+    bool streaming;
+
+    // Train from a quantized copy of the dataset (QuantizedPoints, ~4 bytes
+    // per point) instead of cached expanded feature columns; features are
+    // expanded per batch. Coordinates are rounded to 16 bits.
+    bool compactStorage;
+
+    // Training-time augmentation of the raw inputs of every batch
+    // (jitter, rotation, scaling, label noise). Evaluation is never augmented.
+    AugmentConfig augment;
+
     int   epochCount;
     float lastLoss;
     float lastAccuracy;
 
+    // Loss/accuracy over the whole dataset from the last evaluateFullDataset().
+    float fullLoss;
+    float fullAccuracy;
+    int   fullEvalEpoch; // epochCount at that evaluation, -1 if never run
+
+    // Histories hold at most HistorySize points (or the lower
+    // setHistoryLimit()). When full, every other point is dropped and later
+    // epochs are recorded at twice the stride, so the plots always span the
+    // whole run without growing.
     static constexpr int HistorySize = 4096;
     std::vector<float> lossHistory;
     std::vector<float> accuracyHistory;
@@ -36,13 +88,149 @@ struct Trainer {
 
     void resetForNewDataset();
 
+    // Drop the cached feature columns; call whenever the dataset contents change.
+    void invalidateFeatureCache();
+
+    // Incremental dataset edits (online labeling). Call after the caller has
+    // appended a point, or removed point `index` by moving the last point
+    // into its slot. Training continues from the current weights; the
+    // feature cache is patched in place instead of rebuilt.
+    void pointAppended(const std::vector<DataPoint>& dataset);
+    void pointRemoved(const std::vector<DataPoint>& dataset, int index);
+
+    // Exchange the feature cache with `columns`, e.g. to park it alongside
+    // its dataset in a DatasetCache and adopt the one of a restored dataset.
+    void swapFeatureColumns(FeatureColumns& columns);
+
+    // Bytes held by the trainer's copy of the dataset (expanded feature
+    // columns, or the quantized points with compactStorage).
+    std::size_t trainingCopyBytes() const;
+
+    // Publish the model, optimizer, training copy and history sizes to
+    // the MemoryRegistry. Cheap; called once per frame.
+    void reportMemory();
+
+    // Cap the histories at `points` (clamped to 16..HistorySize), e.g. to
+    // meet a memory budget. Longer histories are decimated and their
+    // storage released right away.
+    void setHistoryLimit(int points);
+    int  historyLimit() const;
+
+    // Time per training phase since the last resetForNewDataset() or
+    // resetPhaseTimes(), summed over every network in the process (Hogwild
+    // workers included). All zero unless built with NNDEMO_PHASE_TIMING.
+    TrainPhaseTimes phaseTimes() const;
+    void resetPhaseTimes();
+
     void trainOneEpoch(const std::vector<DataPoint>& dataset);
 
     bool autoTrainEpochs(const std::vector<DataPoint>& dataset);
 
+    // Evaluate the current network on every point, split across the shared
+    // ThreadPool. Chunk partials are summed in a fixed order, so the result
+    // does not depend on the number of threads.
+    void evaluateFullDataset(const std::vector<DataPoint>& dataset);
+
+    bool isHogwildRunning() const;
+    HogwildStats hogwildStats() const;
+
+    bool isPrefetchRunning() const;
+    BatchPipelineStats prefetchStats() const;
+
+    // Distribution for streaming mode; `reservoirSize` caps the points kept
+    // for display. A change restarts the stream and empties the reservoir.
+    void setStreamSource(DatasetType type, float spread, unsigned int seed, int reservoirSize);
+    const std::vector<DataPoint>& streamReservoir() const;
+    std::uint64_t streamSampleCount() const;
+
+    // Reservoir changes since the last clearReservoirChanges(), for keeping
+    // a mirror of it in step. After a reset (the stream restarted) the
+    // mirror must be rebuilt from streamReservoir(); otherwise only the
+    // listed slots were written, each listed once. Appended slots are
+    // listed too, and are always past the end of the mirror.
+    bool reservoirWasReset() const;
+    const std::vector<int>& reservoirChangedSlots() const;
+    void clearReservoirChanges();
+
+    // Live attach: mirror a run published by another process (see
+    // LivePublisher) instead of training locally. While attached,
+    // autoTrainEpochs() pulls the latest weights and history and local
+    // training is disabled.
+    bool attachLive(const std::string& segmentName);
+    void detachLive();
+    bool isLiveAttached() const;
+    const LiveSnapshot& liveSnapshot() const;
+
 private:
     std::vector<DataPoint> m_batch;
     int m_dataCursor;
 
+    FeatureColumns     m_featureColumns;
+    QuantizedPoints    m_quantized;
+    std::vector<int>   m_batchIndices;
+    std::vector<float> m_batchFeatures;
+    std::vector<int>   m_batchLabels;
+    std::vector<float> m_batchX;
+    std::vector<float> m_batchY;
+    std::uint32_t      m_augmentKey;
+
+    struct EvalPartial {
+        float lossSum;
+        int   correct;
+    };
+
+    HogwildTrainer m_hogwild;
+    int            m_hogwildBaseEpoch;
+
+    BatchPipeline m_pipeline;
+
+    // Streaming mode
+    DatasetType            m_streamType;
+    float                  m_streamSpread;
+    unsigned int           m_streamSeed;
+    std::vector<DataPoint> m_reservoir;
+    int                    m_reservoirSize;
+    std::uint64_t          m_streamSamples; // samples trained on so far
+    std::uint64_t          m_reservoirRng;
+    bool                   m_reservoirReset;
+    std::vector<int>       m_reservoirChangedSlots;
+    std::vector<char>      m_reservoirSlotChanged; // per slot: in the list above
+
+    int m_historyStride;
+    int m_historySkip;
+    int m_historyLimit;
+
+    TrainPhaseTimes m_phaseBaseline;
+
+    MemoryAccount m_modelMemory;
+    MemoryAccount m_optimizerMemory;
+    MemoryAccount m_trainingMemory;
+    MemoryAccount m_historyMemory;
+
+    LiveSubscriber m_liveSubscriber;
+    LiveSnapshot   m_liveSnapshot;
+
+    bool pullLive();
+    void applyLiveSnapshot();
+
+    bool autoTrainHogwild(const std::vector<DataPoint>& dataset);
+    void stopHogwild();
+    void recordHogwildProgress(const HogwildStats& stats);
+    void recordHistory();
+    void appendHistoryPoint(float loss, float accuracy);
+    void clearHistory();
+    void halveHistory();
+
+    const PreparedBatch* acquirePrefetched(const std::vector<DataPoint>& dataset);
+    const PreparedBatch* acquireStreamed();
+    void sampleIntoReservoir(const PreparedBatch& batch);
+    void markReservoirSlot(std::size_t slot);
+    void resetStream();
+
+    void datasetEdited(const std::vector<DataPoint>& dataset);
+
     void makeBatch(const std::vector<DataPoint>& dataset);
+    void makeFeatureBatch(const std::vector<DataPoint>& dataset);
+    int  makeAugmentedBatch(const std::vector<DataPoint>& dataset);
+    int  makeCompactBatch(const std::vector<DataPoint>& dataset);
 };
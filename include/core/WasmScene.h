@@ -7,10 +7,13 @@
 
 #include "ControlPanel.h"
 #include "PlotGeometry.h"
+#include "PointGrid.h"
 #include "FieldVisualizer.h"
 #include "Trainer.h"
 #include "DataPoint.h"
+#include "DatasetCache.h"
 #include "DatasetGenerator.h"
+#include "Scene.h"
 
 class ShaderProgram;
 
@@ -19,6 +22,8 @@ struct WasmSceneState {
     UiState ui;
     std::vector<DataPoint> dataset;
     PointCloud pointCloud;
+    PointGrid pointGrid;
+    DatasetCache datasetCache;
     GridAxes gridAxes;
     FieldVisualizer fieldVis;
     Trainer trainer;
@@ -43,6 +48,8 @@ struct WasmSceneState {
     int fieldB2Location = -1;
     int fieldW3Location = -1;
     int fieldB3Location = -1;
+
+    FieldShaderSources fieldSources;
 };
 
 extern WasmSceneState g_wasmState;
@@ -82,6 +89,8 @@ void nn_set_adam_beta1(float value);
 void nn_set_adam_beta2(float value);
 void nn_set_adam_eps(float value);
 void nn_set_init_mode(int initMode);
+void nn_set_feature_set(int featureSet);
+void nn_set_deterministic(int enabled);
 void nn_set_probe_enabled(int enabled);
 void nn_set_probe_position(float x, float y);
 
@@ -94,6 +103,8 @@ float nn_get_adam_beta1();
 float nn_get_adam_beta2();
 float nn_get_adam_eps();
 int   nn_get_init_mode();
+int   nn_get_feature_set();
+int   nn_get_deterministic();
 int   nn_get_probe_enabled();
 float nn_get_probe_x();
 float nn_get_probe_y();
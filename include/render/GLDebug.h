@@ -0,0 +1,45 @@
+#pragma once
+
+// OpenGL debug output, object labels and debug groups through KHR_debug.
+//
+// initGLDebug() loads the KHR_debug entry points when the desktop context
+// has them (GL 4.3, or the extension) and installs an asynchronous message
+// callback, so errors are reported without polling glGetError. Labels and
+// groups show up in GPU captures (RenderDoc, Nsight, apitrace). WebGL has
+// no equivalent; there, and on drivers without the extension, labels and
+// groups are no-ops and check_gl_error() falls back to glGetError in debug
+// builds.
+//
+// Messages below a severity threshold are dropped by the driver. The
+// threshold comes from NNDEMO_GL_DEBUG (off, high, medium, low, all) and
+// defaults to low in debug builds and high in release builds.
+
+enum class GLObjectType : unsigned int {
+    Buffer      = 0x82E0, // GL_BUFFER
+    Shader      = 0x82E1, // GL_SHADER
+    Program     = 0x82E2, // GL_PROGRAM
+    VertexArray = 0x8074  // GL_VERTEX_ARRAY
+};
+
+// Call once with the context current, after the GL loader. Returns true if
+// the debug callback was installed.
+bool initGLDebug();
+
+// True when GL errors arrive through the debug callback.
+bool glDebugOutputActive();
+
+// Name a GL object for debug messages and captures. `name` 0 is ignored.
+void labelGLObject(GLObjectType type, unsigned int name, const char* label);
+
+// Marks the commands issued during its lifetime as one group in captures.
+class GLDebugGroup {
+public:
+    explicit GLDebugGroup(const char* name);
+    ~GLDebugGroup();
+
+    GLDebugGroup(const GLDebugGroup&) = delete;
+    GLDebugGroup& operator=(const GLDebugGroup&) = delete;
+
+private:
+    bool m_pushed;
+};
@@ -8,7 +8,10 @@ struct GLFWwindow;
 // GLFW will call this when something goes wrong at the windowing/OS level
 void glfw_error_callback(int error, const char* description);
 
-// Helper to dump OpenGL errors with a label so you can see *where* they came from
+// Report pending OpenGL errors with a label so you can see *where* they came
+// from. Only debug builds without KHR_debug output poll glGetError (at most
+// every 250 ms, since a poll stalls the pipeline); otherwise errors arrive
+// through the callback from initGLDebug() and this does nothing.
 void check_gl_error(const char* label);
 
 // Helper function to resize the viewport if the user resizes the window
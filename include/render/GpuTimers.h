@@ -0,0 +1,82 @@
+#pragma once
+
+// GPU time per render pass through GL_TIME_ELAPSED queries.
+//
+// Off unless init() is called (the render benchmark does). Each pass of a
+// frame is wrapped in a GpuPassScope; results are read back
+// GpuTimerLatency frames later so the CPU does not wait on the GPU, and
+// added to per-pass totals. WebGL has no timer queries in core, so on
+// Emscripten init() fails and the scopes are no-ops.
+
+enum class GpuPass {
+    Field,       // decision field
+    GridAxes,
+    Points,
+    ImGui,
+    Count
+};
+
+constexpr int GpuPassCount = static_cast<int>(GpuPass::Count);
+
+// Frames in flight before a pass's query is read back.
+constexpr int GpuTimerLatency = 4;
+
+struct GpuPassStats {
+    double totalMs;
+    double maxMs;
+    int    frames; // frames in which the pass ran
+};
+
+class GpuPassTimers {
+public:
+    GpuPassTimers();
+
+    GpuPassTimers(const GpuPassTimers&) = delete;
+    GpuPassTimers& operator=(const GpuPassTimers&) = delete;
+
+    static GpuPassTimers& shared();
+
+    // Create the queries; needs a current context. Returns false if timer
+    // queries are not available.
+    bool init();
+    void shutdown();
+    bool active() const { return m_active; }
+
+    void begin(GpuPass pass);
+    void end(GpuPass pass);
+
+    // Once per frame, after the last pass: reads back the frame issued
+    // GpuTimerLatency - 1 frames ago.
+    void endFrame();
+
+    // Read back every frame still in flight (waits for the GPU).
+    void finish();
+
+    void resetStats();
+    const GpuPassStats& stats(GpuPass pass) const { return m_stats[static_cast<int>(pass)]; }
+
+    static const char* passName(GpuPass pass);
+
+private:
+    void collect(int slot);
+
+    unsigned int m_queries[GpuTimerLatency][GpuPassCount];
+    bool         m_issued[GpuTimerLatency][GpuPassCount];
+    int          m_slot;
+    bool         m_active;
+    GpuPassStats m_stats[GpuPassCount];
+};
+
+// Times the GL commands issued during its lifetime as one pass.
+class GpuPassScope {
+public:
+    explicit GpuPassScope(GpuPass pass);
+    ~GpuPassScope();
+
+    GpuPassScope(const GpuPassScope&) = delete;
+    GpuPassScope& operator=(const GpuPassScope&) = delete;
+
+private:
+    GpuPass m_pass;
+    bool    m_timing;
+};
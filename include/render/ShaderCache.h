@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// On-disk cache of linked program binaries (glGetProgramBinary /
+// glProgramBinary) plus KHR_parallel_shader_compile setup. Create it after
+// the GL context is current and pass it to ShaderProgram.
+//
+// Entries are keyed by a hash of both shader sources and the driver
+// (vendor, renderer, version), so editing a shader or updating the driver
+// simply misses. A binary the driver rejects falls back to compiling from
+// source. Program binaries are not available in WebGL; there the cache only
+// enables parallel compilation.
+class ShaderCache {
+public:
+    explicit ShaderCache(const std::string& directory = "shader_cache");
+
+    bool binariesSupported() const { return m_binariesSupported; }
+    bool parallelCompileSupported() const { return m_parallelCompile; }
+
+    std::string makeKey(const char* vertexSrc, const char* fragmentSrc) const;
+
+    // Link `program` from the binary stored under `key`. Returns false if
+    // there is none or the driver rejects it.
+    bool load(unsigned int program, const std::string& key);
+
+    // Call before linking a program that will be stored.
+    void prepareForStore(unsigned int program) const;
+
+    // Save the binary of the linked `program` under `key`.
+    void store(unsigned int program, const std::string& key);
+
+    std::size_t hits() const { return m_hits; }
+    std::size_t misses() const { return m_misses; }
+
+private:
+    std::string pathFor(const std::string& key) const;
+
+    std::string m_directory;
+    std::string m_driver;
+    bool        m_binariesSupported;
+    bool        m_parallelCompile;
+    std::size_t m_hits;
+    std::size_t m_misses;
+};
@@ -2,11 +2,24 @@
 
 #include <string>
 
+class ShaderCache;
+
 class ShaderProgram {
 public:
+    // Compile and link, blocking until the program is ready.
     ShaderProgram(const char* vertexSrc, const char* fragmentSrc);
+
+    // Load the program from `cache`, or start compiling and linking it
+    // without waiting for the result, so several programs can compile in
+    // parallel (KHR_parallel_shader_compile). Call finish() before use.
+    ShaderProgram(const char* vertexSrc, const char* fragmentSrc, ShaderCache* cache);
     ~ShaderProgram();
 
+    // Wait for a pending build, log any errors and store the binary in the
+    // cache. Returns true if the program linked.
+    bool finish();
+    bool loadedFromCache() const { return m_fromCache; }
+
     void use() const;
     unsigned int getId() const { return m_id; }
 
@@ -23,5 +36,15 @@ public:
     ShaderProgram& operator=(ShaderProgram&& other) noexcept;
 
 private:
+    void startBuild(const char* vertexSrc, const char* fragmentSrc);
+    void releaseShaders();
+
     unsigned int m_id;
+    unsigned int m_vertexShader;
+    unsigned int m_fragmentShader;
+    bool         m_pending;
+    bool         m_linked;
+    bool         m_fromCache;
+    ShaderCache* m_cache;
+    std::string  m_cacheKey;
 };
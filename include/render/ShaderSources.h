@@ -0,0 +1,14 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+// Environment variable naming a directory of shader files that take
+// precedence over the copies embedded at build time, so shaders can be
+// edited without rebuilding (desktop only).
+constexpr const char* ShaderOverrideEnv = "NNDEMO_SHADER_DIR";
+
+// Source of shader `name` (e.g. "point.vert") for this build's GL flavour.
+// Shaders are written once as GLSL 330; the Emscripten build swaps the
+// #version line for the GLSL ES 300 header with highp defaults.
+std::optional<std::string> loadShaderSource(const char* name);
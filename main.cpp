@@ -1,7 +1,10 @@
  #include "App.h"
 
-int main() {
+int main(int argc, char** argv) {
     App app;
+    if (!app.parseCommandLine(argc, argv)) {
+        return 1;
+    }
     if (!app.init()) {
         return -1;
     }
@@ -1,7 +1,14 @@
 #version 330 core
 in vec2 vPos;
 out vec4 FragColor;
+// @features-begin
 const int INPUT_DIM  = 2;
+void expandFeatures(vec2 p, out float a0[INPUT_DIM])
+{
+    a0[0] = p.x;
+    a0[1] = p.y;
+}
+// @features-end
 const int HIDDEN1    = 4;
 const int HIDDEN2    = 8;
 const int OUTPUT_DIM = 2;
@@ -14,8 +21,7 @@ uniform float u_b3[OUTPUT_DIM];
 void main()
 {
     float a0[INPUT_DIM];
-    a0[0] = vPos.x;
-    a0[1] = vPos.y;
+    expandFeatures(vPos, a0);
     float a1[HIDDEN1];
     for (int j = 0; j < HIDDEN1; ++j) {
         float sum = u_b1[j];
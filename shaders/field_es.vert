@@ -1,10 +0,0 @@
-#version 300 es
-precision highp float;
-precision highp int;
-layout (location = 0) in vec2 aPos;
-out vec2 vPos;
-void main()
-{
-    vPos = aPos;
-    gl_Position = vec4(aPos, 0.0, 1.0);
-}
@@ -1,9 +0,0 @@
-#version 300 es
-precision highp float;
-precision highp int;
-out vec4 FragColor;
-uniform vec3 uColor;
-void main()
-{
-    FragColor = vec4(uColor, 1.0);
-}
@@ -1,8 +0,0 @@
-#version 300 es
-precision highp float;
-precision highp int;
-layout (location = 0) in vec2 aPos;
-void main()
-{
-    gl_Position = vec4(aPos, 0.0, 1.0);
-}
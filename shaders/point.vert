@@ -1,4 +1,6 @@
 #version 330 core
+// aPos is the position divided by 2 (PointPositionExtent), as floats or
+// normalized shorts; aLabel is 0 or 1, as a float or an unsigned byte.
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in float aLabel;
 flat out int vLabel;
@@ -6,7 +8,7 @@ flat out int vIndex;
 uniform float uPointSize;
 void main()
 {
-    gl_Position = vec4(aPos, 0.0, 1.0);
+    gl_Position = vec4(aPos * 2.0, 0.0, 1.0);
     vLabel = int(aLabel + 0.5);
     vIndex = gl_VertexID;
     gl_PointSize = uPointSize;
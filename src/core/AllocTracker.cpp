@@ -0,0 +1,233 @@
+#include "AllocTracker.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+// Violations logged per site before it goes quiet.
+const int kMaxReportsPerSite = 5;
+
+#ifdef NN_TRACK_ALLOCATIONS
+// Plain integers so they need no dynamic initialization; operator new can
+// run before main() and on threads that are being torn down.
+thread_local std::uint64_t t_allocations = 0;
+thread_local std::uint64_t t_bytes       = 0;
+
+// Allocations made inside outermost AllocExemptScopes, which checks ignore.
+thread_local std::uint64_t t_exemptAllocations = 0;
+thread_local std::uint64_t t_exemptBytes       = 0;
+thread_local int           t_exemptDepth       = 0;
+
+std::atomic<std::uint64_t> g_allocations(0);
+std::atomic<std::uint64_t> g_bytes(0);
+
+void noteAllocation(std::size_t size)
+{
+    ++t_allocations;
+    t_bytes += size;
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void* countedAlloc(std::size_t size)
+{
+    noteAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t alignment)
+{
+    noteAllocation(size);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, size ? size : 1) != 0) {
+        return nullptr;
+    }
+    return p;
+#endif
+}
+
+void alignedFree(void* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+#endif
+
+// Allocations that count against NN_ASSERT_NO_ALLOC on this thread.
+AllocCounts checkedCounts()
+{
+#ifdef NN_TRACK_ALLOCATIONS
+    return AllocCounts{t_allocations - t_exemptAllocations, t_bytes - t_exemptBytes};
+#else
+    return AllocCounts{0, 0};
+#endif
+}
+
+bool strictMode()
+{
+    static const bool strict = [] {
+        const char* env = std::getenv("NNDEMO_ALLOC_STRICT");
+        return env && std::strcmp(env, "0") != 0;
+    }();
+    return strict;
+}
+
+} // namespace
+
+bool allocTrackingEnabled()
+{
+#ifdef NN_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocCounts threadAllocCounts()
+{
+#ifdef NN_TRACK_ALLOCATIONS
+    return AllocCounts{t_allocations, t_bytes};
+#else
+    return AllocCounts{0, 0};
+#endif
+}
+
+AllocCounts processAllocCounts()
+{
+#ifdef NN_TRACK_ALLOCATIONS
+    return AllocCounts{g_allocations.load(std::memory_order_relaxed),
+                       g_bytes.load(std::memory_order_relaxed)};
+#else
+    return AllocCounts{0, 0};
+#endif
+}
+
+AllocScopeCheck::AllocScopeCheck(AllocSite& site)
+    : m_site(site)
+    , m_start(checkedCounts())
+{
+}
+
+AllocScopeCheck::~AllocScopeCheck()
+{
+    const AllocCounts end = checkedCounts();
+    const std::uint64_t allocations = end.allocations - m_start.allocations;
+    const int pass = m_site.passes.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (allocations == 0 || pass <= AllocWarmupPasses) {
+        return;
+    }
+
+    const int violation = m_site.violations.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (violation <= kMaxReportsPerSite || strictMode()) {
+        // fprintf rather than iostreams: it does not allocate on the way.
+        std::fprintf(stderr,
+                     "[Alloc] %s (%s:%d) allocated %llu times (%llu bytes) on pass %d%s\n",
+                     m_site.name,
+                     m_site.file,
+                     m_site.line,
+                     static_cast<unsigned long long>(allocations),
+                     static_cast<unsigned long long>(end.bytes - m_start.bytes),
+                     pass,
+                     violation == kMaxReportsPerSite ? "; further reports suppressed" : "");
+    }
+    if (strictMode()) {
+        std::abort();
+    }
+}
+
+AllocExemptScope::AllocExemptScope()
+    : m_start(threadAllocCounts())
+{
+#ifdef NN_TRACK_ALLOCATIONS
+    ++t_exemptDepth;
+#endif
+}
+
+AllocExemptScope::~AllocExemptScope()
+{
+#ifdef NN_TRACK_ALLOCATIONS
+    // Nested scopes are already covered by the outermost one.
+    if (--t_exemptDepth == 0) {
+        const AllocCounts end = threadAllocCounts();
+        t_exemptAllocations += end.allocations - m_start.allocations;
+        t_exemptBytes       += end.bytes - m_start.bytes;
+    }
+#endif
+}
+
+#ifdef NN_TRACK_ALLOCATIONS
+// Replacement global allocation functions. Defined in this translation unit
+// so they are linked whenever NN_ASSERT_NO_ALLOC is used.
+
+void* operator new(std::size_t size)
+{
+    void* p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* p = countedAlignedAlloc(size, alignment);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+#endif
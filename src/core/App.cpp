@@ -13,11 +13,13 @@
 #include <GLFW/glfw3.h>
 #endif
 
+#include <chrono>
 #include <iostream>
 #include <cmath>
 #include <vector>
 #include <optional>
 #include <memory>
+#include <string>
 
 #include "imgui.h"
 #include "backends/imgui_impl_glfw.h"
@@ -25,14 +27,22 @@
 
 #include "App.h"
 #include "ShaderProgram.h"
+#include "ShaderCache.h"
+#include "ShaderSources.h"
+#include "GLDebug.h"
 #include "GLUtils.h"
 #include "DataPoint.h"
+#include "DatasetCache.h"
 #include "DatasetGenerator.h"
+#include "FeatureExpansion.h"
 #include "FieldVisualizer.h"
 #include "PlotGeometry.h"
+#include "PointGrid.h"
 #include "Trainer.h"
 #include "ControlPanel.h"
 #include "Input.h"
+#include "Logger.h"
+#include "RenderBench.h"
 #include "Scene.h"
 
 #ifdef __EMSCRIPTEN__
@@ -77,17 +87,58 @@ extern "C" void nn_shutdown() {
 // ==========================================
 // 1. THE SHADER SOURCE CODE (The "Recipe")
 // ==========================================
-// Shader programs are loaded from external text files in the shaders/ directory.
-// See shaders/*.vert and shaders/*.frag for the GLSL source.
+// Shader sources live in shaders/*.vert and shaders/*.frag and are embedded
+// into the binary at build time (see ShaderSources.h).
 
 // Geometry-related helpers such as worldToLocal, pointInTriangle, and
 // pointInUnitSquare are provided by GeometryUtils.h/.cpp.
 
+// Startup timing: every phase is reported relative to App::init().
+using StartupClock = std::chrono::steady_clock;
+static StartupClock::time_point s_startupBegin;
+
+static double millisecondsSince(StartupClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(StartupClock::now() - start).count();
+}
+
+static void reportFirstFrame() {
+    static bool reported = false;
+    if (!reported) {
+        reported = true;
+        NN_LOG_INFO("[Startup] First frame after %g ms", millisecondsSince(s_startupBegin));
+    }
+}
+
+// Report the shader phase of startup: reading sources, issuing the
+// compiles/links (or binary loads), and waiting for the driver.
+static void reportShaderTiming(const ShaderCache& cache,
+                               double loadMs,
+                               double issueMs,
+                               double waitMs) {
+    std::cout << "[Startup] Shaders: sources " << loadMs << " ms, compile/link issue "
+              << issueMs << " ms, wait " << waitMs << " ms ("
+              << cache.hits() << "/3 from binary cache"
+              << (cache.parallelCompileSupported() ? ", parallel compile" : "") << ")" << std::endl;
+}
+
 App::App()
     : m_window(nullptr) {
 }
 
+bool App::parseCommandLine(int argc, char** argv) {
+#ifdef __EMSCRIPTEN__
+    // The page drives the wasm build through the C API.
+    (void)argc;
+    (void)argv;
+    return true;
+#else
+    return parseRenderBenchArgs(argc, argv, m_bench);
+#endif
+}
+
 bool App::init() {
+    s_startupBegin = StartupClock::now();
+
     // ==========================================
     // 2. INITIALIZATION (The OS Layer)
     // ==========================================
@@ -105,10 +156,27 @@ bool App::init() {
     // macOS requires this for forward-compatible core profiles 3.2+
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
+#ifndef NDEBUG
+    // Debug contexts report more through KHR_debug (see GLDebug.h).
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
+
+    int windowWidth  = 1024;
+    int windowHeight = 768;
+    if (m_bench.enabled) {
+        // Same size every run; hidden so nothing else draws over it.
+        windowWidth  = m_bench.width;
+        windowHeight = m_bench.height;
+        glfwWindowHint(GLFW_VISIBLE, m_bench.showWindow ? GLFW_TRUE : GLFW_FALSE);
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+        if (m_bench.egl) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        }
+    }
 
     // Create a Window
-    std::cout << "[Init] Creating window 1024x768..." << std::endl;
-    m_window = glfwCreateWindow(1024, 768, "Neural Net Demo", NULL, NULL);
+    std::cout << "[Init] Creating window " << windowWidth << "x" << windowHeight << "..." << std::endl;
+    m_window = glfwCreateWindow(windowWidth, windowHeight, "Neural Net Demo", NULL, NULL);
     if (m_window == NULL) {
         std::cerr << "[Init] Failed to create GLFW window" << std::endl;
         glfwTerminate();
@@ -117,6 +185,10 @@ bool App::init() {
     std::cout << "[Init] Window created" << std::endl;
     glfwMakeContextCurrent(m_window);
     glfwSetFramebufferSizeCallback(m_window, framebuffer_size_callback);
+    if (m_bench.enabled) {
+        // Frame times must not be paced by the display.
+        glfwSwapInterval(0);
+    }
 
     std::cout << "[Init] OpenGL context is now current" << std::endl;
 
@@ -129,6 +201,7 @@ bool App::init() {
 
     glEnable(GL_PROGRAM_POINT_SIZE);
 #endif
+    initGLDebug();
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
@@ -153,12 +226,18 @@ bool App::init() {
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
 #endif
     ImGui::StyleColorsDark();
+    if (m_bench.enabled) {
+        // Default window layout, whatever a previous session saved.
+        ImGui::GetIO().IniFilename = nullptr;
+    }
     ImGui_ImplGlfw_InitForOpenGL(m_window, true);
 #ifdef __EMSCRIPTEN__
     ImGui_ImplOpenGL3_Init("#version 300 es");
 #else
     ImGui_ImplOpenGL3_Init("#version 330");  // matches your GL version
 #endif
+    std::cout << "[Startup] Window, GL context and ImGui ready after "
+              << millisecondsSince(s_startupBegin) << " ms" << std::endl;
     return true;
 }
 
@@ -181,13 +260,51 @@ void App::shutdownApp() {
 
 #ifdef __EMSCRIPTEN__
 static bool initShadersWasm(WasmSceneState& state) {
-    auto pointVertexSrc   = loadTextFile("shaders/point_es.vert");
-    auto pointFragmentSrc = loadTextFile("shaders/point_es.frag");
+    const StartupClock::time_point loadStart = StartupClock::now();
+
+    auto pointVertexSrc   = loadShaderSource("point.vert");
+    auto pointFragmentSrc = loadShaderSource("point.frag");
     if (!pointVertexSrc || !pointFragmentSrc) {
         std::cerr << "[Init] Failed to load point shader sources" << std::endl;
         return false;
     }
-    state.pointShader = std::make_unique<ShaderProgram>(pointVertexSrc->c_str(), pointFragmentSrc->c_str());
+    auto gridVertexSrc   = loadShaderSource("grid.vert");
+    auto gridFragmentSrc = loadShaderSource("grid.frag");
+    if (!gridVertexSrc || !gridFragmentSrc) {
+        std::cerr << "[Init] Failed to load grid shader sources" << std::endl;
+        return false;
+    }
+    auto fieldVertexSrc   = loadShaderSource("field.vert");
+    auto fieldFragmentSrc = loadShaderSource("field.frag");
+    if (!fieldVertexSrc || !fieldFragmentSrc) {
+        std::cerr << "[Init] Failed to load field shader sources" << std::endl;
+        return false;
+    }
+    state.fieldSources.vertexSrc        = *fieldVertexSrc;
+    state.fieldSources.fragmentTemplate = *fieldFragmentSrc;
+    state.fieldSources.featureSet       = state.trainer.net.getFeatureSet();
+    const std::string fieldFragment =
+        buildFieldFragmentSource(state.fieldSources.fragmentTemplate, state.fieldSources.featureSet);
+    const double loadMs = millisecondsSince(loadStart);
+
+    // Issue all three builds before waiting on any, so the browser can
+    // compile them in parallel.
+    ShaderCache cache;
+    const StartupClock::time_point issueStart = StartupClock::now();
+    state.pointShader = std::make_unique<ShaderProgram>(pointVertexSrc->c_str(), pointFragmentSrc->c_str(), &cache);
+    state.gridShader  = std::make_unique<ShaderProgram>(gridVertexSrc->c_str(), gridFragmentSrc->c_str(), &cache);
+    state.fieldShader = std::make_unique<ShaderProgram>(fieldVertexSrc->c_str(), fieldFragment.c_str(), &cache);
+    const double issueMs = millisecondsSince(issueStart);
+
+    const StartupClock::time_point waitStart = StartupClock::now();
+    state.pointShader->finish();
+    state.gridShader->finish();
+    state.fieldShader->finish();
+    reportShaderTiming(cache, loadMs, issueMs, millisecondsSince(waitStart));
+
+    labelGLObject(GLObjectType::Program, state.pointShader->getId(), "point program");
+    labelGLObject(GLObjectType::Program, state.gridShader->getId(), "grid program");
+    labelGLObject(GLObjectType::Program, state.fieldShader->getId(), "field program");
 
     check_gl_error("After point shader program link");
 
@@ -196,28 +313,15 @@ static bool initShadersWasm(WasmSceneState& state) {
     state.colorClass1Location   = glGetUniformLocation(state.pointShader->getId(), "uColorClass1");
     state.selectedIndexLocation = glGetUniformLocation(state.pointShader->getId(), "uSelectedIndex");
 
-    auto gridVertexSrc   = loadTextFile("shaders/grid_es.vert");
-    auto gridFragmentSrc = loadTextFile("shaders/grid_es.frag");
-    if (!gridVertexSrc || !gridFragmentSrc) {
-        std::cerr << "[Init] Failed to load grid shader sources" << std::endl;
-        return false;
-    }
-    state.gridShader = std::make_unique<ShaderProgram>(gridVertexSrc->c_str(), gridFragmentSrc->c_str());
     state.gridColorLocation = glGetUniformLocation(state.gridShader->getId(), "uColor");
 
-    auto fieldVertexSrc   = loadTextFile("shaders/field_es.vert");
-    auto fieldFragmentSrc = loadTextFile("shaders/field_es.frag");
-    if (!fieldVertexSrc || !fieldFragmentSrc) {
-        std::cerr << "[Init] Failed to load field shader sources" << std::endl;
-        return false;
-    }
-    state.fieldShader = std::make_unique<ShaderProgram>(fieldVertexSrc->c_str(), fieldFragmentSrc->c_str());
-    state.fieldW1Location = glGetUniformLocation(state.fieldShader->getId(), "u_W1");
-    state.fieldB1Location = glGetUniformLocation(state.fieldShader->getId(), "u_b1");
-    state.fieldW2Location = glGetUniformLocation(state.fieldShader->getId(), "u_W2");
-    state.fieldB2Location = glGetUniformLocation(state.fieldShader->getId(), "u_b2");
-    state.fieldW3Location = glGetUniformLocation(state.fieldShader->getId(), "u_W3");
-    state.fieldB3Location = glGetUniformLocation(state.fieldShader->getId(), "u_b3");
+    queryFieldUniformLocations(*state.fieldShader,
+                               state.fieldW1Location,
+                               state.fieldB1Location,
+                               state.fieldW2Location,
+                               state.fieldB2Location,
+                               state.fieldW3Location,
+                               state.fieldB3Location);
 
     return true;
 }
@@ -235,14 +339,52 @@ static bool initShadersDesktop(std::unique_ptr<ShaderProgram>& pointShader,
                                int& fieldW2Location,
                                int& fieldB2Location,
                                int& fieldW3Location,
-                               int& fieldB3Location) {
-    auto pointVertexSrc   = loadTextFile("shaders/point.vert");
-    auto pointFragmentSrc = loadTextFile("shaders/point.frag");
+                               int& fieldB3Location,
+                               FieldShaderSources& fieldSources) {
+    const StartupClock::time_point loadStart = StartupClock::now();
+
+    auto pointVertexSrc   = loadShaderSource("point.vert");
+    auto pointFragmentSrc = loadShaderSource("point.frag");
     if (!pointVertexSrc || !pointFragmentSrc) {
         std::cerr << "[Init] Failed to load point shader sources" << std::endl;
         return false;
     }
-    pointShader = std::make_unique<ShaderProgram>(pointVertexSrc->c_str(), pointFragmentSrc->c_str());
+    auto gridVertexSrc   = loadShaderSource("grid.vert");
+    auto gridFragmentSrc = loadShaderSource("grid.frag");
+    if (!gridVertexSrc || !gridFragmentSrc) {
+        std::cerr << "[Init] Failed to load grid shader sources" << std::endl;
+        return false;
+    }
+    auto fieldVertexSrc   = loadShaderSource("field.vert");
+    auto fieldFragmentSrc = loadShaderSource("field.frag");
+    if (!fieldVertexSrc || !fieldFragmentSrc) {
+        std::cerr << "[Init] Failed to load field shader sources" << std::endl;
+        return false;
+    }
+    fieldSources.vertexSrc        = *fieldVertexSrc;
+    fieldSources.fragmentTemplate = *fieldFragmentSrc;
+    const std::string fieldFragment =
+        buildFieldFragmentSource(fieldSources.fragmentTemplate, fieldSources.featureSet);
+    const double loadMs = millisecondsSince(loadStart);
+
+    // Issue all three builds before waiting on any, so a driver with
+    // parallel shader compilation can work on them at the same time.
+    ShaderCache cache;
+    const StartupClock::time_point issueStart = StartupClock::now();
+    pointShader = std::make_unique<ShaderProgram>(pointVertexSrc->c_str(), pointFragmentSrc->c_str(), &cache);
+    gridShader  = std::make_unique<ShaderProgram>(gridVertexSrc->c_str(), gridFragmentSrc->c_str(), &cache);
+    fieldShader = std::make_unique<ShaderProgram>(fieldVertexSrc->c_str(), fieldFragment.c_str(), &cache);
+    const double issueMs = millisecondsSince(issueStart);
+
+    const StartupClock::time_point waitStart = StartupClock::now();
+    pointShader->finish();
+    gridShader->finish();
+    fieldShader->finish();
+    reportShaderTiming(cache, loadMs, issueMs, millisecondsSince(waitStart));
+
+    labelGLObject(GLObjectType::Program, pointShader->getId(), "point program");
+    labelGLObject(GLObjectType::Program, gridShader->getId(), "grid program");
+    labelGLObject(GLObjectType::Program, fieldShader->getId(), "field program");
 
     check_gl_error("After point shader program link");
 
@@ -251,28 +393,15 @@ static bool initShadersDesktop(std::unique_ptr<ShaderProgram>& pointShader,
     colorClass1Location   = glGetUniformLocation(pointShader->getId(), "uColorClass1");
     selectedIndexLocation = glGetUniformLocation(pointShader->getId(), "uSelectedIndex");
 
-    auto gridVertexSrc   = loadTextFile("shaders/grid.vert");
-    auto gridFragmentSrc = loadTextFile("shaders/grid.frag");
-    if (!gridVertexSrc || !gridFragmentSrc) {
-        std::cerr << "[Init] Failed to load grid shader sources" << std::endl;
-        return false;
-    }
-    gridShader = std::make_unique<ShaderProgram>(gridVertexSrc->c_str(), gridFragmentSrc->c_str());
     gridColorLocation = glGetUniformLocation(gridShader->getId(), "uColor");
 
-    auto fieldVertexSrc   = loadTextFile("shaders/field.vert");
-    auto fieldFragmentSrc = loadTextFile("shaders/field.frag");
-    if (!fieldVertexSrc || !fieldFragmentSrc) {
-        std::cerr << "[Init] Failed to load field shader sources" << std::endl;
-        return false;
-    }
-    fieldShader = std::make_unique<ShaderProgram>(fieldVertexSrc->c_str(), fieldFragmentSrc->c_str());
-    fieldW1Location = glGetUniformLocation(fieldShader->getId(), "u_W1");
-    fieldB1Location = glGetUniformLocation(fieldShader->getId(), "u_b1");
-    fieldW2Location = glGetUniformLocation(fieldShader->getId(), "u_W2");
-    fieldB2Location = glGetUniformLocation(fieldShader->getId(), "u_b2");
-    fieldW3Location = glGetUniformLocation(fieldShader->getId(), "u_W3");
-    fieldB3Location = glGetUniformLocation(fieldShader->getId(), "u_b3");
+    queryFieldUniformLocations(*fieldShader,
+                               fieldW1Location,
+                               fieldB1Location,
+                               fieldW2Location,
+                               fieldB2Location,
+                               fieldW3Location,
+                               fieldB3Location);
 
     return true;
 }
@@ -307,6 +436,8 @@ int App::run() {
                     g_wasmState.maxPoints,
                     g_wasmState.dataset,
                     g_wasmState.pointCloud,
+                    g_wasmState.pointGrid,
+                    g_wasmState.datasetCache,
                     g_wasmState.gridAxes,
                     g_wasmState.fieldVis,
                     g_wasmState.leftMousePressedLastFrame);
@@ -335,6 +466,8 @@ int App::run() {
     int fieldW3Location       = -1;
     int fieldB3Location       = -1;
 
+    FieldShaderSources fieldSources;
+
     if (!initShadersDesktop(pointShader,
                             gridShader,
                             fieldShader,
@@ -348,7 +481,8 @@ int App::run() {
                             fieldW2Location,
                             fieldB2Location,
                             fieldW3Location,
-                            fieldB3Location)) {
+                            fieldB3Location,
+                            fieldSources)) {
         shutdownApp();
         return -1;
     }
@@ -362,6 +496,8 @@ int App::run() {
 
     int maxPoints = 0;
     PointCloud pointCloud;
+    PointGrid pointGrid;
+    DatasetCache datasetCache;
     GridAxes gridAxes;
     FieldVisualizer fieldVis;
     Trainer trainer;
@@ -375,6 +511,8 @@ int App::run() {
                     maxPoints,
                     dataset,
                     pointCloud,
+                    pointGrid,
+                    datasetCache,
                     gridAxes,
                     fieldVis,
                     leftMousePressedLastFrame);
@@ -382,33 +520,36 @@ int App::run() {
     // ==========================================
     // 5. THE GAME LOOP
     // ==========================================
-    renderLoop(window,
-               *pointShader,
-               *gridShader,
-               *fieldShader,
-               pointSizeLocation,
-               colorClass0Location,
-               colorClass1Location,
-               selectedIndexLocation,
-               gridColorLocation,
-               fieldW1Location,
-               fieldB1Location,
-               fieldW2Location,
-               fieldB2Location,
-               fieldW3Location,
-               fieldB3Location,
-               ui,
-               dataset,
-               pointCloud,
-               gridAxes,
-               fieldVis,
-               trainer,
-               leftMousePressedLastFrame,
-               maxPoints);
+    const int exitCode = renderLoop(window,
+                                    *pointShader,
+                                    *gridShader,
+                                    *fieldShader,
+                                    pointSizeLocation,
+                                    colorClass0Location,
+                                    colorClass1Location,
+                                    selectedIndexLocation,
+                                    gridColorLocation,
+                                    fieldW1Location,
+                                    fieldB1Location,
+                                    fieldW2Location,
+                                    fieldB2Location,
+                                    fieldW3Location,
+                                    fieldB3Location,
+                                    fieldSources,
+                                    ui,
+                                    dataset,
+                                    pointCloud,
+                                    pointGrid,
+                                    datasetCache,
+                                    gridAxes,
+                                    fieldVis,
+                                    trainer,
+                                    leftMousePressedLastFrame,
+                                    maxPoints);
 
     shutdownScene(pointCloud, gridAxes, fieldVis);
     shutdownApp();
-    return 0;
+    return exitCode;
 #endif
 }
 
@@ -436,9 +577,12 @@ int App::run() {
          g_wasmState.fieldB2Location,
          g_wasmState.fieldW3Location,
          g_wasmState.fieldB3Location,
+         g_wasmState.fieldSources,
          g_wasmState.ui,
          g_wasmState.dataset,
          g_wasmState.pointCloud,
+         g_wasmState.pointGrid,
+         g_wasmState.datasetCache,
          g_wasmState.gridAxes,
          g_wasmState.fieldVis,
          g_wasmState.trainer,
@@ -446,33 +590,37 @@ int App::run() {
          g_wasmState.maxPoints};
 
      updateAndRenderFrame(ctx);
+     reportFirstFrame();
  }
  #endif
 
-void App::renderLoop(GLFWwindow* window,
-                     ShaderProgram& pointShader,
-                     ShaderProgram& gridShader,
-                     ShaderProgram& fieldShader,
-                     int pointSizeLocation,
-                     int colorClass0Location,
-                     int colorClass1Location,
-                     int selectedIndexLocation,
-                     int gridColorLocation,
-                     int fieldW1Location,
-                     int fieldB1Location,
-                     int fieldW2Location,
-                     int fieldB2Location,
-                     int fieldW3Location,
-                     int fieldB3Location,
-                     UiState& ui,
-                     std::vector<DataPoint>& dataset,
-                     PointCloud& pointCloud,
-                     GridAxes& gridAxes,
-                     FieldVisualizer& fieldVis,
-                     Trainer& trainer,
-                     bool& leftMousePressedLastFrame,
-                     int maxPoints) {
-    std::cout << "[Loop] Entering render loop" << std::endl;
+int App::renderLoop(GLFWwindow* window,
+                    ShaderProgram& pointShader,
+                    ShaderProgram& gridShader,
+                    ShaderProgram& fieldShader,
+                    int pointSizeLocation,
+                    int colorClass0Location,
+                    int colorClass1Location,
+                    int selectedIndexLocation,
+                    int gridColorLocation,
+                    int fieldW1Location,
+                    int fieldB1Location,
+                    int fieldW2Location,
+                    int fieldB2Location,
+                    int fieldW3Location,
+                    int fieldB3Location,
+                    FieldShaderSources& fieldSources,
+                    UiState& ui,
+                    std::vector<DataPoint>& dataset,
+                    PointCloud& pointCloud,
+                    PointGrid& pointGrid,
+                    DatasetCache& datasetCache,
+                    GridAxes& gridAxes,
+                    FieldVisualizer& fieldVis,
+                    Trainer& trainer,
+                    bool& leftMousePressedLastFrame,
+                    int maxPoints) {
+    NN_LOG_INFO("[Loop] Entering render loop");
 
     FrameContext ctx{
         window,
@@ -490,19 +638,28 @@ void App::renderLoop(GLFWwindow* window,
         fieldB2Location,
         fieldW3Location,
         fieldB3Location,
+        fieldSources,
         ui,
         dataset,
         pointCloud,
+        pointGrid,
+        datasetCache,
         gridAxes,
         fieldVis,
         trainer,
         leftMousePressedLastFrame,
         maxPoints};
 
+    if (m_bench.enabled) {
+        return runRenderBench(m_bench, ctx);
+    }
+
     while (!glfwWindowShouldClose(window)) {
         if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
             glfwSetWindowShouldClose(window, true);
 
         updateAndRenderFrame(ctx);
+        reportFirstFrame();
     }
+    return 0;
 }
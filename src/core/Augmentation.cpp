@@ -0,0 +1,74 @@
+#include "Augmentation.h"
+
+#include <algorithm>
+
+namespace {
+
+// Independent draws per sample.
+const std::uint32_t kDrawsPerSample = 5;
+
+// 32-bit integer hash (lowbias32); only 32-bit multiplies, so it vectorizes.
+inline std::uint32_t hash32(std::uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Uniform in [-1, 1).
+inline float signedUnit(std::uint32_t bits)
+{
+    return static_cast<float>(bits >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+// Uniform in [0, 1).
+inline float unit(std::uint32_t bits)
+{
+    return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+} // namespace
+
+void augmentBatch(const AugmentConfig& config,
+                  std::uint32_t key,
+                  float* xs,
+                  float* ys,
+                  int* labels,
+                  int count)
+{
+    if (!config.isActive() || count <= 0) {
+        return;
+    }
+
+    const float jitter     = config.jitter;
+    const float maxAngle   = std::min(std::max(config.maxRotation, 0.0f), MaxAugmentRotation);
+    const float scaleRange = config.scaleRange;
+    const float labelNoise = config.labelNoise;
+    const std::uint32_t base = hash32(key);
+
+    for (int i = 0; i < count; ++i) {
+        const std::uint32_t ctr = base + static_cast<std::uint32_t>(i) * kDrawsPerSample;
+
+        const float a  = maxAngle * signedUnit(hash32(ctr));
+        const float s  = 1.0f + scaleRange * signedUnit(hash32(ctr + 1u));
+        const float jx = jitter * signedUnit(hash32(ctr + 2u));
+        const float jy = jitter * signedUnit(hash32(ctr + 3u));
+        const float u  = unit(hash32(ctr + 4u));
+
+        // Taylor sin/cos, |a| <= 0.5.
+        const float a2 = a * a;
+        const float c  = 1.0f - a2 * (0.5f - a2 * (1.0f / 24.0f - a2 * (1.0f / 720.0f)));
+        const float sn = a * (1.0f - a2 * (1.0f / 6.0f - a2 * (1.0f / 120.0f)));
+
+        const float x = xs[i];
+        const float y = ys[i];
+        xs[i] = s * (c * x - sn * y) + jx;
+        ys[i] = s * (sn * x + c * y) + jy;
+
+        // Two-class labels: flip with probability labelNoise, branch-free.
+        labels[i] ^= (u < labelNoise) ? 1 : 0;
+    }
+}
@@ -0,0 +1,356 @@
+#include "BatchPipeline.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+#include "ToyNet.h"
+
+namespace {
+
+// Spins before the consumer parks; a batch is usually only microseconds away.
+const int kAcquireSpins = 64;
+
+std::uint32_t nextRandom(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<std::uint32_t>((z ^ (z >> 31)) >> 32);
+}
+
+} // namespace
+
+BatchPipeline::BatchPipeline()
+    : m_set(FeatureSet::Raw)
+    , m_batchSize(1)
+    , m_cursor(0)
+    , m_rngState(0)
+    , m_streaming(false)
+    , m_streamType(DatasetType::TwoBlobs)
+    , m_streamSpread(0.0f)
+    , m_streamSeed(0)
+    , m_streamNext(0)
+    , m_augmentKey(0)
+    , m_stop(false)
+    , m_consumerWaiting(false)
+    , m_producerWaiting(false)
+    , m_produced(0)
+    , m_consumerStalls(0)
+{
+}
+
+BatchPipeline::~BatchPipeline()
+{
+    stop();
+}
+
+bool BatchPipeline::start(const std::vector<DataPoint>& dataset,
+                          FeatureSet set,
+                          int batchSize,
+                          int depth,
+                          unsigned int seed,
+                          const AugmentConfig& augment)
+{
+    stop();
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    (void)dataset;
+    (void)set;
+    (void)batchSize;
+    (void)depth;
+    (void)seed;
+    (void)augment;
+    NN_LOG_ERROR("Batch prefetching requires thread support");
+    return false;
+#else
+    if (dataset.empty()) {
+        return false;
+    }
+
+    // The producer works on its own copy, so the caller may edit or
+    // regenerate its dataset at any time (and then restart the pipeline).
+    m_streaming = false;
+    m_dataset   = dataset;
+    m_columns.invalidate();
+    m_rngState  = seed;
+
+    const int dataCount = static_cast<int>(m_dataset.size());
+    m_order.resize(static_cast<std::size_t>(dataCount));
+    for (int i = 0; i < dataCount; ++i) {
+        m_order[i] = i;
+    }
+    m_cursor = dataCount; // reshuffle before the first batch
+    m_augmentKey = seed;
+
+    return startThread(set, batchSize, depth, augment);
+#endif
+}
+
+bool BatchPipeline::startStream(DatasetType type,
+                                float spread,
+                                unsigned int seed,
+                                std::uint64_t firstSample,
+                                FeatureSet set,
+                                int batchSize,
+                                int depth,
+                                const AugmentConfig& augment)
+{
+    stop();
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    (void)type;
+    (void)spread;
+    (void)seed;
+    (void)firstSample;
+    (void)set;
+    (void)batchSize;
+    (void)depth;
+    (void)augment;
+    NN_LOG_ERROR("Streaming data requires thread support");
+    return false;
+#else
+    m_streaming    = true;
+    m_streamType   = type;
+    m_streamSpread = spread;
+    m_streamSeed   = seed;
+    m_streamNext   = firstSample;
+    m_dataset.clear();
+    m_dataset.shrink_to_fit();
+    m_order.clear();
+    m_columns.invalidate();
+    m_augmentKey = static_cast<std::uint32_t>(firstSample) ^ (seed * 0x9E3779B9u);
+
+    return startThread(set, batchSize, depth, augment);
+#endif
+}
+
+bool BatchPipeline::startThread(FeatureSet set, int batchSize, int depth, const AugmentConfig& augment)
+{
+    m_set       = set;
+    m_batchSize = std::max(1, std::min(batchSize, ToyNet::MaxBatch));
+    m_augment   = augment;
+    m_batchIndices.resize(static_cast<std::size_t>(m_batchSize));
+    m_rawX.resize(static_cast<std::size_t>(m_batchSize));
+    m_rawY.resize(static_cast<std::size_t>(m_batchSize));
+
+    const int dim = featureDim(set);
+    depth = std::max(1, std::min(depth, MaxDepth));
+    m_buffers.resize(static_cast<std::size_t>(depth));
+    for (auto& buffer : m_buffers) {
+        buffer.features.resize(static_cast<std::size_t>(m_batchSize * dim));
+        buffer.labels.resize(static_cast<std::size_t>(m_batchSize));
+        buffer.points.resize(m_streaming ? static_cast<std::size_t>(m_batchSize) : 0);
+        buffer.count = 0;
+        buffer.dim   = dim;
+    }
+
+    m_ready.clear();
+    m_free.clear();
+    for (int i = 0; i < depth; ++i) {
+        m_free.tryPush(i);
+    }
+
+    m_stop.store(false, std::memory_order_relaxed);
+    m_produced.store(0, std::memory_order_relaxed);
+    m_consumerStalls = 0;
+    m_thread = std::thread(&BatchPipeline::producerLoop, this);
+    return true;
+}
+
+void BatchPipeline::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+    m_stop.store(true, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(m_freeMutex);
+        m_freeCv.notify_all();
+    }
+    m_thread.join();
+}
+
+bool BatchPipeline::isRunning() const
+{
+    return m_thread.joinable();
+}
+
+bool BatchPipeline::matches(FeatureSet set, int batchSize, int datasetSize,
+                            const AugmentConfig& augment) const
+{
+    const int clamped = std::max(1, std::min(batchSize, ToyNet::MaxBatch));
+    return isRunning() && !m_streaming && m_set == set && m_batchSize == clamped &&
+           static_cast<int>(m_dataset.size()) == datasetSize && m_augment == augment;
+}
+
+bool BatchPipeline::matchesStream(DatasetType type, float spread, unsigned int seed,
+                                  FeatureSet set, int batchSize, const AugmentConfig& augment) const
+{
+    const int clamped = std::max(1, std::min(batchSize, ToyNet::MaxBatch));
+    return isRunning() && m_streaming && m_streamType == type && m_streamSpread == spread &&
+           m_streamSeed == seed && m_set == set && m_batchSize == clamped && m_augment == augment;
+}
+
+const PreparedBatch* BatchPipeline::acquire()
+{
+    if (!isRunning()) {
+        return nullptr;
+    }
+
+    int index = -1;
+    for (int spin = 0; spin < kAcquireSpins; ++spin) {
+        if (m_ready.tryPop(index)) {
+            return &m_buffers[index];
+        }
+        std::this_thread::yield();
+    }
+
+    ++m_consumerStalls;
+    if (!popOrWait(m_ready, index, m_consumerWaiting, m_readyMutex, m_readyCv, m_stop)) {
+        return nullptr;
+    }
+    return &m_buffers[index];
+}
+
+void BatchPipeline::release(const PreparedBatch* batch)
+{
+    if (!batch || m_buffers.empty()) {
+        return;
+    }
+    const int index = static_cast<int>(batch - m_buffers.data());
+    pushAndWake(m_free, index, m_producerWaiting, m_freeMutex, m_freeCv);
+}
+
+BatchPipelineStats BatchPipeline::stats() const
+{
+    BatchPipelineStats s;
+    s.produced       = m_produced.load(std::memory_order_relaxed);
+    s.consumerStalls = m_consumerStalls;
+    return s;
+}
+
+bool BatchPipeline::popOrWait(IndexQueue& queue,
+                              int& out,
+                              std::atomic<bool>& waiting,
+                              std::mutex& mutex,
+                              std::condition_variable& cv,
+                              const std::atomic<bool>& stop)
+{
+    while (!queue.tryPop(out)) {
+        std::unique_lock<std::mutex> lock(mutex);
+        // Announce the wait before the final check; pushAndWake() reads the
+        // flag after its push, so one of the two always sees the other.
+        waiting.store(true, std::memory_order_seq_cst);
+        cv.wait(lock, [&] {
+            return !queue.empty() || stop.load(std::memory_order_seq_cst);
+        });
+        waiting.store(false, std::memory_order_relaxed);
+        if (stop.load(std::memory_order_relaxed) && queue.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BatchPipeline::pushAndWake(IndexQueue& queue,
+                                int value,
+                                std::atomic<bool>& waiting,
+                                std::mutex& mutex,
+                                std::condition_variable& cv)
+{
+    // Never fails: the queues can hold every buffer index at once.
+    queue.tryPush(value);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_one();
+    }
+}
+
+void BatchPipeline::producerLoop()
+{
+    // Expanded features are built once per run, on this thread.
+    // Augmented batches expand their transformed raw inputs instead.
+    if (!m_streaming && !m_augment.isActive()) {
+        m_columns.build(m_set, m_dataset);
+    }
+
+    int index = -1;
+    while (popOrWait(m_free, index, m_producerWaiting, m_freeMutex, m_freeCv, m_stop)) {
+        if (m_stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+        if (m_streaming) {
+            fillStreamBatch(m_buffers[index]);
+        } else {
+            fillBatch(m_buffers[index]);
+        }
+        m_produced.fetch_add(1, std::memory_order_relaxed);
+        pushAndWake(m_ready, index, m_consumerWaiting, m_readyMutex, m_readyCv);
+    }
+
+    // Wake a consumer that may be waiting for a batch that will never come.
+    std::lock_guard<std::mutex> lock(m_readyMutex);
+    m_readyCv.notify_all();
+}
+
+void BatchPipeline::reshuffle()
+{
+    // Fisher-Yates over the visiting order.
+    for (int i = static_cast<int>(m_order.size()) - 1; i > 0; --i) {
+        const int j = static_cast<int>(nextRandom(m_rngState) % static_cast<std::uint32_t>(i + 1));
+        std::swap(m_order[i], m_order[j]);
+    }
+    m_cursor = 0;
+}
+
+void BatchPipeline::fillBatch(PreparedBatch& batch)
+{
+    const int dataCount = static_cast<int>(m_order.size());
+    for (int i = 0; i < m_batchSize; ++i) {
+        if (m_cursor >= dataCount) {
+            reshuffle();
+        }
+        const int point = m_order[m_cursor++];
+        m_batchIndices[i] = point;
+        batch.labels[i]   = m_dataset[point].label;
+    }
+
+    if (m_augment.isActive()) {
+        for (int i = 0; i < m_batchSize; ++i) {
+            const DataPoint& p = m_dataset[m_batchIndices[i]];
+            m_rawX[i] = p.x;
+            m_rawY[i] = p.y;
+        }
+        finishAugmentedBatch(batch);
+        return;
+    }
+
+    m_columns.gatherRows(m_batchIndices.data(), m_batchSize, batch.features.data());
+    batch.count = m_batchSize;
+}
+
+void BatchPipeline::finishAugmentedBatch(PreparedBatch& batch)
+{
+    augmentBatch(m_augment, m_augmentKey++, m_rawX.data(), m_rawY.data(),
+                 batch.labels.data(), m_batchSize);
+    expandFeatureRows(m_set, m_rawX.data(), m_rawY.data(), m_batchSize, batch.features.data());
+    batch.count = m_batchSize;
+}
+
+void BatchPipeline::fillStreamBatch(PreparedBatch& batch)
+{
+    generateStreamSamples(m_streamType, m_streamSpread, m_streamSeed,
+                          m_streamNext, m_batchSize, batch.points.data());
+    m_streamNext += static_cast<std::uint64_t>(m_batchSize);
+
+    // batch.points keeps the clean samples for the trainer's reservoir.
+    for (int i = 0; i < m_batchSize; ++i) {
+        const DataPoint& p = batch.points[i];
+        m_rawX[i] = p.x;
+        m_rawY[i] = p.y;
+        batch.labels[i] = p.label;
+    }
+    // augmentBatch() is a no-op when augmentation is off.
+    finishAugmentedBatch(batch);
+}
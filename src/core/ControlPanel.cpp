@@ -1,12 +1,21 @@
 #include "ControlPanel.h"
 
+#include <algorithm>
+#include <iostream>
+
 #include "ToyNet.h"
 #include "DatasetGenerator.h"
+#include "FeatureExpansion.h"
 #include "NetworkVisualizer.h"
+#include "PerfCounters.h"
+#include "AllocTracker.h"
+#include "MemoryAccounting.h"
+#include "PhaseTimer.h"
 
 #include "imgui.h"
 
 static void drawDatasetSection(UiState& ui,
+                               Trainer& trainer,
                                std::size_t currentPointCount,
                                bool& regenerateRequested)
 {
@@ -19,8 +28,31 @@ static void drawDatasetSection(UiState& ui,
     regenerateRequested |= ImGui::SliderInt("Points", &ui.numPoints, 100, 5000);
     regenerateRequested |= ImGui::SliderFloat("Spread", &ui.spread, 0.01f, 0.5f);
     if (ImGui::Button("Regenerate Data")) {
+        // Generation is deterministic per seed, so a fresh sample needs a new one.
+        ++ui.datasetSeed;
         regenerateRequested = true;
     }
+
+    if (HogwildTrainer::defaultThreadCount() > 0) {
+        // Switching the data source starts a new run either way.
+        regenerateRequested |= ImGui::Checkbox("Stream Fresh Samples", &trainer.streaming);
+        if (trainer.streaming) {
+            ImGui::Text("Samples seen: %llu (showing %d)",
+                        static_cast<unsigned long long>(trainer.streamSampleCount()),
+                        static_cast<int>(currentPointCount));
+        }
+    }
+
+    if (!trainer.streaming) {
+        ImGui::Checkbox("Edit Points", &ui.editPoints);
+        if (ui.editPoints) {
+            ImGui::SameLine();
+            ImGui::RadioButton("Class 0", &ui.editLabel, 0);
+            ImGui::SameLine();
+            ImGui::RadioButton("Class 1", &ui.editLabel, 1);
+            ImGui::TextDisabled("Click to add, Shift+click to remove");
+        }
+    }
 }
 
 static void drawProbeSection(UiState& ui, Trainer& trainer)
@@ -54,9 +86,18 @@ static void drawHyperparameterSection(Trainer& trainer)
         trainer.resetForNewDataset();
     }
 
+    int featureIdx = static_cast<int>(trainer.featureSet);
+    if (ImGui::Combo("Input Features", &featureIdx, getFeatureSetNames(), FeatureSetCount)) {
+        if (featureIdx < 0) featureIdx = 0;
+        if (featureIdx >= FeatureSetCount) featureIdx = FeatureSetCount - 1;
+        trainer.featureSet = static_cast<FeatureSet>(featureIdx);
+        trainer.resetForNewDataset();
+    }
+
     ImGui::Separator();
     ImGui::SliderFloat("Learning Rate", &trainer.learningRate, 0.0001f, 0.2f, "%.5f");
     ImGui::SliderInt("Batch Size", &trainer.batchSize, 1, ToyNet::MaxBatch);
+    ImGui::Checkbox("Deterministic Reduction", &trainer.deterministic);
 
     ImGui::Separator();
     const char* optimizerNames[] = { "SGD", "SGD + Momentum", "Adam" };
@@ -92,10 +133,82 @@ static void drawHyperparameterSection(Trainer& trainer)
     }
 }
 
+static void drawAugmentationSection(Trainer& trainer)
+{
+    ImGui::Separator();
+    ImGui::Text("Augmentation (training batches only)");
+    AugmentConfig& aug = trainer.augment;
+    ImGui::SliderFloat("Jitter", &aug.jitter, 0.0f, 0.2f, "%.3f");
+    ImGui::SliderAngle("Rotation", &aug.maxRotation, 0.0f, MaxAugmentRotation * 180.0f / 3.14159265f);
+    ImGui::SliderFloat("Scale +/-", &aug.scaleRange, 0.0f, 0.3f, "%.2f");
+    ImGui::SliderFloat("Label Noise", &aug.labelNoise, 0.0f, 0.5f, "%.2f");
+}
+
+static void drawHogwildSection(Trainer& trainer)
+{
+    if (HogwildTrainer::defaultThreadCount() == 0) {
+        return;
+    }
+
+    ImGui::Separator();
+    ImGui::Checkbox("Hogwild Async Training", &trainer.hogwild);
+    if (!trainer.hogwild) {
+        return;
+    }
+
+    // Thread count only takes effect the next time auto-train starts.
+    ImGui::SliderInt("Hogwild Threads", &trainer.hogwildThreads, 1, HogwildTrainer::defaultThreadCount());
+    if (trainer.optimizerType == OptimizerType::Adam) {
+        ImGui::TextDisabled("Adam is not supported here; using plain SGD.");
+    }
+
+    const HogwildStats stats = trainer.hogwildStats();
+    if (stats.updates == 0) {
+        return;
+    }
+    ImGui::Text("Updates: %llu (%.0f /s)",
+                static_cast<unsigned long long>(stats.updates), stats.updatesPerSecond);
+    ImGui::Text("Staleness: mean %.2f, max %d", stats.meanStaleness, stats.maxStaleness);
+
+    float histogram[HogwildStalenessBuckets];
+    for (int b = 0; b < HogwildStalenessBuckets; ++b) {
+        histogram[b] = static_cast<float>(stats.stalenessHistogram[b]) / static_cast<float>(stats.updates);
+    }
+    ImGui::PlotHistogram("##Staleness", histogram, HogwildStalenessBuckets, 0,
+                         "staleness 0, 1, 2-3, 4-7, ...", 0.0f, 1.0f, ImVec2(-1.0f, 50.0f));
+}
+
+static void drawLiveAttachSection(UiState& ui, Trainer& trainer)
+{
+#if defined(__linux__)
+    ImGui::Separator();
+    if (!trainer.isLiveAttached()) {
+        ImGui::InputText("Live Segment", ui.liveSegmentName, sizeof(ui.liveSegmentName));
+        if (ImGui::Button("Attach to Headless Run")) {
+            trainer.attachLive(ui.liveSegmentName);
+        }
+        return;
+    }
+
+    // While attached the weights, curves and dataset follow the external
+    // trainer; local training controls have no effect.
+    const LiveSnapshot& live = trainer.liveSnapshot();
+    ImGui::Text("Live: %s (pid %d)", ui.liveSegmentName, live.writerPid);
+    ImGui::Text("Step %d%s", live.step, live.finished ? " (finished)" : "");
+    if (ImGui::Button("Detach")) {
+        trainer.detachLive();
+    }
+#else
+    (void)ui;
+    (void)trainer;
+#endif
+}
+
 static void drawTrainingSection(UiState& ui,
                                 Trainer& trainer,
                                 std::size_t currentPointCount,
-                                bool& stepTrainRequested)
+                                bool& stepTrainRequested,
+                                bool& evaluateRequested)
 {
     if (ImGui::Button("Train Epoch")) {
         stepTrainRequested = true;
@@ -107,6 +220,32 @@ static void drawTrainingSection(UiState& ui,
     ImGui::Text("Loss: %.4f", trainer.lastLoss);
     ImGui::Text("Accuracy: %.3f", trainer.lastAccuracy);
 
+    if (ImGui::Button("Evaluate Full Dataset")) {
+        evaluateRequested = true;
+    }
+    if (trainer.fullEvalEpoch >= 0) {
+        ImGui::Text("Full data @ epoch %d: loss %.4f, acc %.3f",
+                    trainer.fullEvalEpoch, trainer.fullLoss, trainer.fullAccuracy);
+    }
+
+    if (HogwildTrainer::defaultThreadCount() > 0) {
+        ImGui::Checkbox("Prefetch Batches", &trainer.prefetch);
+        if (trainer.isPrefetchRunning()) {
+            const BatchPipelineStats stats = trainer.prefetchStats();
+            ImGui::Text("Prefetched: %llu, waits: %llu",
+                        static_cast<unsigned long long>(stats.produced),
+                        static_cast<unsigned long long>(stats.consumerStalls));
+        }
+    }
+
+    ImGui::Checkbox("Compact Storage", &trainer.compactStorage);
+    ImGui::SameLine();
+    ImGui::Text("(training copy: %.1f KB)",
+                static_cast<double>(trainer.trainingCopyBytes()) / 1024.0);
+
+    drawHogwildSection(trainer);
+    drawLiveAttachSection(ui, trainer);
+
     ImGui::Separator();
     ImGui::SliderInt("Auto Max Epochs", &trainer.autoMaxEpochs, 0, 2000);
     // TODO: Add an ImGui help tooltip explaining epochs vs internal step terminology.
@@ -236,14 +375,153 @@ static void drawAccuracyPlotWindow(const Trainer& trainer,
     ImGui::End();
 }
 
+static void drawPerfHudWindow(const ImGuiIO& io, Trainer& trainer)
+{
+    // Frame-time and throughput stats from the shared counters registry.
+
+#ifdef __EMSCRIPTEN__
+    ImVec2 perfSize(300.0f, 680.0f);
+    ImVec2 perfPos(io.DisplaySize.x - perfSize.x - 10.0f, 40.0f);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+#else
+    ImVec2 perfSize(300.0f, 680.0f);
+    ImVec2 perfPos(10.0f, io.DisplaySize.y - perfSize.y - 20.0f);
+#endif
+    ImGui::SetNextWindowPos(perfPos, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(perfSize, ImGuiCond_FirstUseEver);
+
+    if (!ImGui::Begin("Performance")) {
+        ImGui::End();
+        return;
+    }
+
+    const PerfRegistry& perf = PerfRegistry::shared();
+    const PerfSummary summary = perf.summarize();
+    if (summary.frames == 0) {
+        ImGui::Text("No frames yet");
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Frame: %.2f ms avg (%.0f fps)",
+                summary.meanFrameMs,
+                summary.meanFrameMs > 0.0f ? 1000.0f / summary.meanFrameMs : 0.0f);
+    ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms",
+                summary.p50FrameMs,
+                summary.p95FrameMs,
+                summary.p99FrameMs,
+                summary.maxFrameMs);
+
+    ImGui::PlotLines("##FrameTimes",
+                     perf.frameTimes(),
+                     perf.historyCount(),
+                     perf.historyOffset(),
+                     nullptr,
+                     0.0f,
+                     std::max(33.3f, summary.maxFrameMs),
+                     ImVec2(-1.0f, 50.0f));
+
+    // 1 ms buckets; the last one collects every frame of 40 ms or more.
+    const int bucketCount = 40;
+    float buckets[bucketCount];
+    perf.frameTimeHistogram(buckets, bucketCount, 1.0f);
+    ImGui::PlotHistogram("##FrameTimeHistogram",
+                         buckets,
+                         bucketCount,
+                         0,
+                         "0 - 40 ms",
+                         0.0f,
+                         FLT_MAX,
+                         ImVec2(-1.0f, 50.0f));
+
+    ImGui::Separator();
+    ImGui::Text("Train steps/s:   %.0f",
+                summary.perSecond[static_cast<int>(PerfCounter::TrainSteps)]);
+    ImGui::Text("Train samples/s: %.0f",
+                summary.perSecond[static_cast<int>(PerfCounter::TrainSamples)]);
+    ImGui::Text("GPU upload: %.1f KB last frame, %.1f KB/frame avg",
+                summary.lastFrame[static_cast<int>(PerfCounter::UploadBytes)] / 1024.0,
+                summary.perFrame[static_cast<int>(PerfCounter::UploadBytes)] / 1024.0);
+    ImGui::Text("Last dataset switch: %.2f ms", perf.lastDatasetMs());
+    if (allocTrackingEnabled()) {
+        ImGui::Text("Allocations: %.1f/frame avg (%.1f KB), %.0f last frame",
+                    summary.perFrame[static_cast<int>(PerfCounter::Allocations)],
+                    summary.perFrame[static_cast<int>(PerfCounter::AllocBytes)] / 1024.0,
+                    summary.lastFrame[static_cast<int>(PerfCounter::Allocations)]);
+    } else {
+        ImGui::TextDisabled("Allocations: not tracked in this build");
+    }
+
+    ImGui::Separator();
+    ImGui::Text("CPU ms per frame (avg)");
+    for (int i = 0; i < PerfSectionCount; ++i) {
+        const PerfSection section = static_cast<PerfSection>(i);
+        ImGui::Text("  %-13s %6.3f", PerfRegistry::sectionName(section), summary.sectionMs[i]);
+    }
+
+    ImGui::Separator();
+    if (phaseTimingEnabled()) {
+        // Since the last reset; forward/loss/backward add up all threads.
+        const TrainPhaseTimes phases = trainer.phaseTimes();
+        std::uint64_t totalNs = 0;
+        for (int i = 0; i < TrainPhaseCount; ++i) {
+            totalNs += phases.ns[i];
+        }
+        ImGui::Text("Train phases, us per step (%llu steps)",
+                    static_cast<unsigned long long>(phases.steps));
+        for (int i = 0; i < TrainPhaseCount; ++i) {
+            const double us = phases.steps > 0 ? phases.ns[i] / 1000.0 / phases.steps : 0.0;
+            const float share = totalNs > 0 ? static_cast<float>(phases.ns[i]) / totalNs : 0.0f;
+            ImGui::Text("  %-10s %8.2f %5.1f%%",
+                        trainPhaseName(static_cast<TrainPhase>(i)),
+                        us,
+                        share * 100.0f);
+        }
+        if (ImGui::Button("Reset Phases")) {
+            trainer.resetPhaseTimes();
+        }
+    } else {
+        ImGui::TextDisabled("Train phases: build with NNDEMO_PHASE_TIMING");
+    }
+
+    ImGui::Separator();
+    const MemoryRegistry& memory = MemoryRegistry::shared();
+    ImGui::Text("Memory: %.1f MB", memory.totalBytes() / (1024.0 * 1024.0));
+    for (int i = 0; i < MemoryTagCount; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        const double kb = memory.bytes(tag) / 1024.0;
+        if (memory.budget(tag) == 0) {
+            ImGui::Text("  %-15s %9.1f KB", MemoryRegistry::tagName(tag), kb);
+        } else if (memory.overBudget(tag)) {
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f),
+                               "  %-15s %9.1f / %.0f KB OVER",
+                               MemoryRegistry::tagName(tag),
+                               kb,
+                               memory.budget(tag) / 1024.0);
+        } else {
+            ImGui::Text("  %-15s %9.1f / %.0f KB",
+                        MemoryRegistry::tagName(tag),
+                        kb,
+                        memory.budget(tag) / 1024.0);
+        }
+    }
+    if (ImGui::Button("Dump Memory")) {
+        memory.dump(std::cout);
+    }
+
+    ImGui::End();
+}
+
 void drawControlPanel(UiState& ui,
                       Trainer& trainer,
                       std::size_t currentPointCount,
                       bool& regenerateRequested,
-                      bool& stepTrainRequested)
+                      bool& stepTrainRequested,
+                      bool& evaluateRequested)
 {
     regenerateRequested = false;
     stepTrainRequested = false;
+    evaluateRequested = false;
 
     ImGuiIO& io = ImGui::GetIO();
 #ifdef __EMSCRIPTEN__
@@ -256,6 +534,7 @@ void drawControlPanel(UiState& ui,
     drawNetworkDiagramWindow(ui, trainer, controlsPos, controlsSize);
     drawLossPlotWindow(trainer, controlsPos, io);
     drawAccuracyPlotWindow(trainer, controlsPos, io);
+    drawPerfHudWindow(io, trainer);
 #else
     // Desktop build: full ImGui control panel with data, probe, and
     // training windows in addition to the visualization plots.
@@ -267,7 +546,7 @@ void drawControlPanel(UiState& ui,
     ImGui::SetNextWindowPos(controlsPos, ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowSize(controlsSize, ImGuiCond_FirstUseEver);
     ImGui::Begin("Data & Probe");
-    drawDatasetSection(ui, currentPointCount, regenerateRequested);
+    drawDatasetSection(ui, trainer, currentPointCount, regenerateRequested);
     drawProbeSection(ui, trainer);
     ImGui::End();
 
@@ -278,12 +557,14 @@ void drawControlPanel(UiState& ui,
     ImGui::SetNextWindowSize(trainSize, ImGuiCond_FirstUseEver);
     ImGui::Begin("Training & Hyperparams");
     drawHyperparameterSection(trainer);
-    drawTrainingSection(ui, trainer, currentPointCount, stepTrainRequested);
+    drawAugmentationSection(trainer);
+    drawTrainingSection(ui, trainer, currentPointCount, stepTrainRequested, evaluateRequested);
     ImGui::End();
 
     drawNetworkDiagramWindow(ui, trainer, controlsPos, controlsSize);
     drawLossPlotWindow(trainer, controlsPos, io);
     drawAccuracyPlotWindow(trainer, controlsPos, io);
+    drawPerfHudWindow(io, trainer);
 #endif
 }
 
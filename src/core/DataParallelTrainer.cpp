@@ -0,0 +1,244 @@
+#include "DataParallelTrainer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "LiveShare.h"
+#include "Logger.h"
+#include "ShmAllReduce.h"
+#include "ThreadPool.h"
+#include "ToyNet.h"
+
+#if defined(__linux__)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+// Body of one worker process. Returns the process exit code.
+int workerMain(const DataParallelConfig& cfg, ShmAllReduce& allReduce, int rank)
+{
+    // Each worker is its own process and the workers already fill the
+    // machine, so everything in it runs on an empty pool (inline on this
+    // thread). The shared pool is never touched: the parent may already
+    // have created it, and its threads do not exist in the child.
+    ThreadPool pool(0);
+
+    std::vector<DataPoint> dataset;
+    generateDataset(cfg.dataset, cfg.numPoints, cfg.spread, dataset, cfg.seed, pool);
+
+    std::vector<DataPoint> shard;
+    for (std::size_t i = static_cast<std::size_t>(rank); i < dataset.size();
+         i += static_cast<std::size_t>(cfg.workers)) {
+        shard.push_back(dataset[i]);
+    }
+    if (shard.empty()) {
+        std::cerr << "[rank " << rank << "] empty shard" << std::endl;
+        allReduce.abort();
+        return 1;
+    }
+
+    // Identical initialization on every rank; identical averaged gradients
+    // then keep the replicas identical.
+    ToyNet net(pool);
+    net.setFeatureSet(cfg.featureSet);
+    net.setOptimizer(cfg.optimizer);
+    net.setLearningRate(cfg.learningRate);
+    net.resetParameters(cfg.seed);
+
+    const int paramCount = net.getParameterCount();
+    const int lossIndex  = paramCount;
+    const int accIndex   = paramCount + 1;
+    std::vector<float> buffer(static_cast<std::size_t>(paramCount + 2));
+
+    std::mt19937 rng(cfg.seed * 7919u + static_cast<unsigned>(rank));
+    std::uniform_int_distribution<std::size_t> pick(0, shard.size() - 1);
+    std::vector<DataPoint> batch(static_cast<std::size_t>(cfg.batchSize));
+
+    const float invWorkers = 1.0f / static_cast<float>(cfg.workers);
+
+    LivePublisher live;
+    const bool publishing = rank == 0 && !cfg.publishName.empty();
+    if (publishing) {
+        LiveDatasetInfo info;
+        info.datasetIndex = static_cast<int>(cfg.dataset);
+        info.numPoints    = cfg.numPoints;
+        info.spread       = cfg.spread;
+        info.seed         = cfg.seed;
+        if (!live.create(cfg.publishName, info)) {
+            allReduce.abort();
+            return 1;
+        }
+        live.publish(net, 0, 0.0f, 0.0f);
+    }
+
+    for (int step = 1; step <= cfg.steps; ++step) {
+        for (auto& p : batch) {
+            p = shard[pick(rng)];
+        }
+
+        float acc = 0.0f;
+        const float loss = net.computeGradients(batch, acc);
+        net.copyGradientsTo(buffer.data());
+        buffer[lossIndex] = loss;
+        buffer[accIndex]  = acc;
+
+        if (!allReduce.allReduceSum(buffer.data())) {
+            std::cerr << "[rank " << rank << "] all-reduce aborted at step " << step << std::endl;
+            return 2;
+        }
+        for (auto& v : buffer) {
+            v *= invWorkers;
+        }
+        net.applyGradients(buffer.data());
+
+        if (publishing && (step % std::max(cfg.publishInterval, 1) == 0 || step == cfg.steps)) {
+            live.publish(net, step, buffer[lossIndex], buffer[accIndex]);
+        }
+
+        if (rank == 0 && cfg.logInterval > 0 && step % cfg.logInterval == 0) {
+            std::printf("step %6d  loss %.5f  acc %.4f\n", step, buffer[lossIndex], buffer[accIndex]);
+            std::fflush(stdout);
+        }
+    }
+
+    // Replica check: broadcast rank 0's parameters (the other ranks
+    // contribute -0.0f, which leaves any sum bit-exact) and compare them
+    // bit for bit with the local ones on every rank.
+    std::vector<float> params(static_cast<std::size_t>(paramCount));
+    net.copyParametersTo(params.data());
+    std::fill(buffer.begin(), buffer.end(), -0.0f);
+    if (rank == 0) {
+        std::copy(params.begin(), params.end(), buffer.begin());
+    }
+    if (!allReduce.allReduceSum(buffer.data())) {
+        return 2;
+    }
+    const bool inSync = std::memcmp(buffer.data(), params.data(), params.size() * sizeof(float)) == 0;
+    if (!inSync) {
+        std::cerr << "[rank " << rank << "] parameters differ from rank 0" << std::endl;
+    }
+
+    // Count the diverged ranks for the summary line.
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    buffer[0] = inSync ? 0.0f : 1.0f;
+    if (!allReduce.allReduceSum(buffer.data())) {
+        return 2;
+    }
+    const int divergedRanks = static_cast<int>(buffer[0]);
+
+    if (publishing) {
+        // The segment name is unlinked on destroy; viewers that are already
+        // attached keep the final state.
+        live.finish();
+    }
+
+    if (rank == 0) {
+        int correct = 0;
+        for (const auto& p : dataset) {
+            float p0 = 0.0f;
+            float p1 = 0.0f;
+            net.forwardSingle(p.x, p.y, p0, p1);
+            if (((p1 > p0) ? 1 : 0) == p.label) {
+                ++correct;
+            }
+        }
+        std::printf("workers %d, full-dataset accuracy %.4f, replicas %s (%d of %d differ)\n",
+                    cfg.workers,
+                    static_cast<double>(correct) / static_cast<double>(dataset.size()),
+                    divergedRanks == 0 ? "identical" : "DIVERGED",
+                    divergedRanks,
+                    cfg.workers);
+    }
+    return divergedRanks == 0 ? 0 : 3;
+}
+
+#endif
+
+} // namespace
+
+int runDataParallelTraining(const DataParallelConfig& cfg)
+{
+#if defined(__linux__)
+    if (cfg.workers < 1 || cfg.batchSize < 1 || cfg.batchSize > ToyNet::MaxBatch) {
+        std::cerr << "Invalid data-parallel configuration" << std::endl;
+        return 1;
+    }
+
+    // Parameters plus the minibatch loss and accuracy.
+    ShmAllReduce allReduce;
+    if (!allReduce.create(cfg.shmName, cfg.workers, ToyNet::parameterCountFor(cfg.featureSet) + 2)) {
+        return 1;
+    }
+
+    std::fflush(stdout);
+    std::vector<pid_t> pids(static_cast<std::size_t>(cfg.workers), -1);
+    for (int rank = 0; rank < cfg.workers; ++rank) {
+        const pid_t pid = fork();
+        if (pid < 0) {
+            std::perror("fork");
+            allReduce.abort();
+            break;
+        }
+        if (pid == 0) {
+            allReduce.setRank(rank);
+            const int code = workerMain(cfg, allReduce, rank);
+            // _exit() skips atexit handlers, so write queued log messages
+            // (e.g. from LivePublisher) first.
+            logFlush();
+            std::fflush(stdout);
+            _exit(code);
+        }
+        pids[rank] = pid;
+    }
+
+    // Reap workers. The first abnormal exit aborts the group so the others
+    // leave their barrier instead of waiting for a peer that is gone.
+    int failures = 0;
+    int remaining = 0;
+    for (pid_t pid : pids) {
+        if (pid > 0) {
+            ++remaining;
+        }
+    }
+    while (remaining > 0) {
+        int status = 0;
+        const pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            break;
+        }
+        const auto it = std::find(pids.begin(), pids.end(), pid);
+        if (it == pids.end()) {
+            continue;
+        }
+        --remaining;
+
+        const int rank = static_cast<int>(it - pids.begin());
+        const bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        if (!ok) {
+            ++failures;
+            if (WIFSIGNALED(status)) {
+                std::cerr << "worker " << rank << " killed by signal " << WTERMSIG(status) << std::endl;
+            } else {
+                std::cerr << "worker " << rank << " exited with code " << WEXITSTATUS(status) << std::endl;
+            }
+            allReduce.abort();
+        }
+    }
+
+    allReduce.destroy();
+    return failures == 0 ? 0 : 1;
+#else
+    (void)cfg;
+    std::cerr << "Multi-process training is only supported on Linux" << std::endl;
+    return 1;
+#endif
+}
@@ -0,0 +1,99 @@
+#include "DatasetCache.h"
+
+#include <utility>
+
+DatasetCache::DatasetCache(std::size_t budgetBytes)
+    : m_budget(budgetBytes)
+    , m_bytes(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_memory(MemoryTag::DatasetCache)
+    , m_hasActive(false)
+    , m_activeEdited(false)
+{
+}
+
+bool DatasetCache::switchTo(const DatasetKey& key,
+                            std::vector<DataPoint>& points,
+                            PointGrid& grid,
+                            FeatureColumns& columns)
+{
+    park(points, grid, columns);
+
+    m_activeKey    = key;
+    m_hasActive    = true;
+    m_activeEdited = false;
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->key == key) {
+            points.swap(it->points);
+            std::swap(grid, it->grid);
+            std::swap(columns, it->columns);
+            m_bytes -= it->bytes;
+            m_entries.erase(it);
+            m_memory.set(m_bytes);
+            ++m_hits;
+            return true;
+        }
+    }
+
+    ++m_misses;
+    return false;
+}
+
+void DatasetCache::park(std::vector<DataPoint>& points, PointGrid& grid, FeatureColumns& columns)
+{
+    if (m_hasActive && !m_activeEdited && !points.empty()) {
+        Entry entry;
+        entry.key = m_activeKey;
+        entry.points.swap(points);
+        std::swap(entry.grid, grid);
+        // Columns that were never built (or belong to other points) would
+        // only hold memory.
+        if (columns.getCount() == static_cast<int>(entry.points.size())) {
+            std::swap(entry.columns, columns);
+        }
+        entry.bytes = entry.points.capacity() * sizeof(DataPoint) +
+                      entry.grid.memoryBytes() +
+                      entry.columns.memoryBytes();
+
+        if (entry.bytes <= m_budget) {
+            m_bytes += entry.bytes;
+            m_entries.push_front(std::move(entry));
+            evictToBudget();
+        }
+    }
+
+    points.clear();
+    grid.clear();
+    columns = FeatureColumns();
+    m_hasActive    = false;
+    m_activeEdited = false;
+}
+
+void DatasetCache::markActiveEdited()
+{
+    m_activeEdited = true;
+}
+
+void DatasetCache::clear()
+{
+    m_entries.clear();
+    m_bytes = 0;
+    m_memory.set(0);
+}
+
+void DatasetCache::setBudget(std::size_t budgetBytes)
+{
+    m_budget = budgetBytes;
+    evictToBudget();
+}
+
+void DatasetCache::evictToBudget()
+{
+    while (m_bytes > m_budget && !m_entries.empty()) {
+        m_bytes -= m_entries.back().bytes;
+        m_entries.pop_back();
+    }
+    m_memory.set(m_bytes);
+}
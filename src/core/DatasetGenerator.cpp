@@ -1,7 +1,9 @@
 #include "DatasetGenerator.h"
 
 #include <cmath>
-#include <cstdlib>
+#include <cstdint>
+
+#include "ThreadPool.h"
 
 namespace {
 
@@ -13,172 +15,227 @@ const char* kDatasetTypeNames[DatasetTypeCount] = {
     "Spirals"
 };
 
-float rand01()
-{
-    return static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
-}
-
-void generateTwoBlobs(int numPoints, float spread, std::vector<DataPoint>& out)
-{
-    out.clear();
-    out.reserve(static_cast<std::size_t>(numPoints));
-
-    int half = numPoints / 2;
+// Counter-based random numbers: the k-th draw for sample `index` is a pure
+// function of (seed, index, k), so any range of samples can be generated
+// independently (and therefore in parallel) with identical results.
+struct SampleRng {
+    std::uint64_t base;
+    std::uint32_t draw;
+
+    SampleRng(unsigned int seed, int index)
+        : base((static_cast<std::uint64_t>(seed) << 32) ^ static_cast<std::uint32_t>(index))
+        , draw(0)
+    {
+    }
 
-    for (int i = 0; i < half; ++i) {
-        float angle = rand01() * 2.0f * static_cast<float>(M_PI);
-        float radius = spread * rand01();
-        float cx = -0.5f;
-        float cy = 0.0f;
-        float x = cx + std::cos(angle) * radius;
-        float y = cy + std::sin(angle) * radius;
-        out.push_back({x, y, 0});
+    // Stream sample `counter`. The odd multiplier keeps every 64-bit counter
+    // distinct, and the salt keeps the stream from replaying the finite
+    // dataset generated with the same seed.
+    static SampleRng forStream(unsigned int seed, std::uint64_t counter)
+    {
+        SampleRng rng(0, 0);
+        rng.base = ((static_cast<std::uint64_t>(seed) << 32) ^ 0x5EED5EED00000000ull) +
+                   counter * 0xD1B54A32D192ED03ull;
+        return rng;
     }
 
-    for (int i = half; i < numPoints; ++i) {
-        float angle = rand01() * 2.0f * static_cast<float>(M_PI);
-        float radius = spread * rand01();
-        float cx = 0.5f;
-        float cy = 0.0f;
-        float x = cx + std::cos(angle) * radius;
-        float y = cy + std::sin(angle) * radius;
-        out.push_back({x, y, 1});
+    float next01()
+    {
+        // splitmix64 finalizer over (base, draw)
+        std::uint64_t z = base + 0x9E3779B97F4A7C15ull * (static_cast<std::uint64_t>(draw++) + 1ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= (z >> 31);
+        return static_cast<float>(z >> 40) / 16777216.0f;
     }
-}
+};
 
-void generateConcentricCircles(int numPoints, float noise, std::vector<DataPoint>& out)
+DataPoint sampleTwoBlobs(int numPoints, float spread, SampleRng& rng, int i)
 {
-    out.clear();
-    out.reserve(static_cast<std::size_t>(numPoints));
+    int half = numPoints / 2;
+    int label = (i < half) ? 0 : 1;
+
+    float angle = rng.next01() * 2.0f * static_cast<float>(M_PI);
+    float radius = spread * rng.next01();
+    float cx = (label == 0) ? -0.5f : 0.5f;
+    float cy = 0.0f;
+    float x = cx + std::cos(angle) * radius;
+    float y = cy + std::sin(angle) * radius;
+    return {x, y, label};
+}
 
+DataPoint sampleConcentricCircles(int numPoints, float noise, SampleRng& rng, int i)
+{
     int half = numPoints / 2;
+    int label = (i < half) ? 0 : 1;
 
     float innerR = 0.3f;
     float outerR = 0.75f;
     float noiseScale = noise;
 
-    for (int i = 0; i < half; ++i) {
-        float angle = rand01() * 2.0f * static_cast<float>(M_PI);
-        float r = innerR + noiseScale * (rand01() - 0.5f);
-        float x = r * std::cos(angle);
-        float y = r * std::sin(angle);
-        out.push_back({x, y, 0});
-    }
-
-    for (int i = half; i < numPoints; ++i) {
-        float angle = rand01() * 2.0f * static_cast<float>(M_PI);
-        float r = outerR + noiseScale * (rand01() - 0.5f);
-        float x = r * std::cos(angle);
-        float y = r * std::sin(angle);
-        out.push_back({x, y, 1});
-    }
+    float angle = rng.next01() * 2.0f * static_cast<float>(M_PI);
+    float r = ((label == 0) ? innerR : outerR) + noiseScale * (rng.next01() - 0.5f);
+    float x = r * std::cos(angle);
+    float y = r * std::sin(angle);
+    return {x, y, label};
 }
 
-void generateTwoMoons(int numPoints, float noise, std::vector<DataPoint>& out)
+DataPoint sampleTwoMoons(int numPoints, float noise, SampleRng& rng, int i)
 {
-    out.clear();
-    out.reserve(static_cast<std::size_t>(numPoints));
-
     int half = numPoints / 2;
+    int label = (i < half) ? 0 : 1;
 
     float radius = 0.8f;
     float offsetX = 0.5f;
     float offsetY = 0.25f;
     float noiseScale = noise;
 
-    for (int i = 0; i < half; ++i) {
-        float t = rand01() * static_cast<float>(M_PI);
-        float x = std::cos(t) * radius - offsetX;
-        float y = std::sin(t) * radius * 0.5f;
-        x += noiseScale * (rand01() - 0.5f);
-        y += noiseScale * (rand01() - 0.5f);
-        out.push_back({x, y, 0});
-    }
-
-    for (int i = half; i < numPoints; ++i) {
-        float t = rand01() * static_cast<float>(M_PI);
-        float x = std::cos(t) * radius + offsetX;
-        float y = -std::sin(t) * radius * 0.5f + offsetY;
-        x += noiseScale * (rand01() - 0.5f);
-        y += noiseScale * (rand01() - 0.5f);
-        out.push_back({x, y, 1});
+    float t = rng.next01() * static_cast<float>(M_PI);
+    float x;
+    float y;
+    if (label == 0) {
+        x = std::cos(t) * radius - offsetX;
+        y = std::sin(t) * radius * 0.5f;
+    } else {
+        x = std::cos(t) * radius + offsetX;
+        y = -std::sin(t) * radius * 0.5f + offsetY;
     }
+    x += noiseScale * (rng.next01() - 0.5f);
+    y += noiseScale * (rng.next01() - 0.5f);
+    return {x, y, label};
 }
 
-void generateXORQuads(int numPoints, float spread, std::vector<DataPoint>& out)
+DataPoint sampleXORQuads(int numPoints, float spread, SampleRng& rng, int i)
 {
-    out.clear();
-    out.reserve(static_cast<std::size_t>(numPoints));
-
     int quarter = numPoints / 4;
     float r = spread;
 
-    auto sampleAround = [&](float cx, float cy, int label, int count) {
-        for (int i = 0; i < count; ++i) {
-            float angle = rand01() * 2.0f * static_cast<float>(M_PI);
-            float rad = r * rand01();
-            float x = cx + std::cos(angle) * rad;
-            float y = cy + std::sin(angle) * rad;
-            out.push_back({x, y, label});
-        }
-    };
+    // Quadrant order: (-,-) and (+,+) are class 0, (-,+) and (+,-) class 1.
+    // The last quadrant takes any remainder.
+    static const float kCx[4]    = { -0.5f, 0.5f, -0.5f,  0.5f };
+    static const float kCy[4]    = { -0.5f, 0.5f,  0.5f, -0.5f };
+    static const int   kLabel[4] = { 0, 0, 1, 1 };
+
+    int q = (quarter > 0) ? i / quarter : 3;
+    if (q > 3) q = 3;
 
-    sampleAround(-0.5f, -0.5f, 0, quarter);
-    sampleAround( 0.5f,  0.5f, 0, quarter);
-    sampleAround(-0.5f,  0.5f, 1, quarter);
-    sampleAround( 0.5f, -0.5f, 1, numPoints - 3 * quarter);
+    float angle = rng.next01() * 2.0f * static_cast<float>(M_PI);
+    float rad = r * rng.next01();
+    float x = kCx[q] + std::cos(angle) * rad;
+    float y = kCy[q] + std::sin(angle) * rad;
+    return {x, y, kLabel[q]};
 }
 
-void generateSpirals(int numPoints, float noise, std::vector<DataPoint>& out)
+DataPoint sampleSpirals(int numPoints, float noise, SampleRng& rng, int i)
 {
-    out.clear();
-    out.reserve(static_cast<std::size_t>(numPoints));
-
     int half = numPoints / 2;
+    int label = (i < half) ? 0 : 1;
 
     float maxT = 3.5f * static_cast<float>(M_PI);
     float a = 0.1f;
     float b = 0.05f;
     float noiseScale = noise;
+    float angleOffset = (label == 0) ? 0.0f : static_cast<float>(M_PI);
+
+    float t = rng.next01() * maxT;
+    float r = a + b * t;
+    float x = r * std::cos(t + angleOffset);
+    float y = r * std::sin(t + angleOffset);
+    x += noiseScale * (rng.next01() - 0.5f);
+    y += noiseScale * (rng.next01() - 0.5f);
+    return {x, y, label};
+}
 
-    auto sampleSpiral = [&](int label, float angleOffset, int count) {
-        for (int i = 0; i < count; ++i) {
-            float t = rand01() * maxT;
-            float r = a + b * t;
-            float x = r * std::cos(t + angleOffset);
-            float y = r * std::sin(t + angleOffset);
-            x += noiseScale * (rand01() - 0.5f);
-            y += noiseScale * (rand01() - 0.5f);
-            out.push_back({x, y, label});
-        }
-    };
+DataPoint samplePoint(DatasetType type, int numPoints, float spread, unsigned int seed, int i)
+{
+    SampleRng rng(seed, i);
+    switch (type) {
+        case DatasetType::TwoBlobs:
+            return sampleTwoBlobs(numPoints, spread, rng, i);
+        case DatasetType::ConcentricCircles:
+            return sampleConcentricCircles(numPoints, spread, rng, i);
+        case DatasetType::TwoMoons:
+            return sampleTwoMoons(numPoints, spread, rng, i);
+        case DatasetType::XORQuads:
+            return sampleXORQuads(numPoints, spread, rng, i);
+        case DatasetType::Spirals:
+            return sampleSpirals(numPoints, spread, rng, i);
+    }
+    return {0.0f, 0.0f, 0};
+}
+
+// Stream samples reuse the finite samplers with a virtual dataset of four
+// points, so sample k gets class (k & 3) / 2, or XOR quadrant k & 3.
+const int kStreamPeriod = 4;
 
-    sampleSpiral(0, 0.0f, half);
-    sampleSpiral(1, static_cast<float>(M_PI), numPoints - half);
+template <typename Sampler>
+void fillStream(Sampler sample, float spread, unsigned int seed,
+                std::uint64_t first, int count, DataPoint* out)
+{
+    for (int i = 0; i < count; ++i) {
+        const std::uint64_t k = first + static_cast<std::uint64_t>(i);
+        SampleRng rng = SampleRng::forStream(seed, k);
+        out[i] = sample(kStreamPeriod, spread, rng, static_cast<int>(k & (kStreamPeriod - 1)));
+    }
 }
 
+// Points per parallel chunk; large enough to amortize task overhead.
+const int kGenerateGrain = 4096;
+
 } // namespace
 
 void generateDataset(DatasetType type,
                      int numPoints,
                      float spread,
-                     std::vector<DataPoint>& out)
+                     std::vector<DataPoint>& out,
+                     unsigned int seed)
+{
+    generateDataset(type, numPoints, spread, out, seed, ThreadPool::shared());
+}
+
+void generateDataset(DatasetType type,
+                     int numPoints,
+                     float spread,
+                     std::vector<DataPoint>& out,
+                     unsigned int seed,
+                     ThreadPool& pool)
+{
+    if (numPoints < 0) {
+        numPoints = 0;
+    }
+    out.resize(static_cast<std::size_t>(numPoints));
+
+    DataPoint* dst = out.data();
+    pool.parallelFor(0, numPoints, kGenerateGrain, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            dst[i] = samplePoint(type, numPoints, spread, seed, i);
+        }
+    });
+}
+
+void generateStreamSamples(DatasetType type,
+                           float spread,
+                           unsigned int seed,
+                           std::uint64_t first,
+                           int count,
+                           DataPoint* out)
 {
+    // Dispatch once per call so the per-sample loop has no type switch.
     switch (type) {
         case DatasetType::TwoBlobs:
-            generateTwoBlobs(numPoints, spread, out);
+            fillStream(sampleTwoBlobs, spread, seed, first, count, out);
             break;
         case DatasetType::ConcentricCircles:
-            generateConcentricCircles(numPoints, spread, out);
+            fillStream(sampleConcentricCircles, spread, seed, first, count, out);
             break;
         case DatasetType::TwoMoons:
-            generateTwoMoons(numPoints, spread, out);
+            fillStream(sampleTwoMoons, spread, seed, first, count, out);
             break;
         case DatasetType::XORQuads:
-            generateXORQuads(numPoints, spread, out);
+            fillStream(sampleXORQuads, spread, seed, first, count, out);
             break;
         case DatasetType::Spirals:
-            generateSpirals(numPoints, spread, out);
+            fillStream(sampleSpirals, spread, seed, first, count, out);
             break;
     }
 }
@@ -0,0 +1,295 @@
+#include "FeatureExpansion.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+const char* kFeatureSetNames[FeatureSetCount] = {
+    "Raw (x, y)",
+    "Polynomial",
+    "Sin / Cos",
+    "Random Fourier"
+};
+
+const float kPi = 3.14159265358979f;
+
+// Frequency scale for the random Fourier features. Inputs live in [-1, 1],
+// so a scale of a few radians per unit gives a handful of oscillations
+// across the plot.
+const float kFourierScale = 3.0f;
+
+struct FourierWeights {
+    float wx[RandomFourierCount];
+    float wy[RandomFourierCount];
+    float b[RandomFourierCount];
+    float amplitude;
+};
+
+// The random Fourier weights are fixed for the lifetime of the process (and
+// across runs) so CPU training, the cached columns and the generated field
+// shader all agree. They use a private LCG rather than std::rand so building
+// them never perturbs the dataset or initialization random streams.
+const FourierWeights& fourierWeights()
+{
+    static const FourierWeights weights = [] {
+        FourierWeights w{};
+        std::uint32_t state = 0x9E3779B9u;
+        auto next01 = [&state]() {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<float>((state >> 8) + 1u) / 16777217.0f;
+        };
+        auto nextNormal = [&]() {
+            // Box-Muller transform for standard normal (mean 0, variance 1)
+            float u1 = next01();
+            float u2 = next01();
+            return std::sqrt(-2.0f * std::log(u1)) * std::cos(2.0f * kPi * u2);
+        };
+        for (int d = 0; d < RandomFourierCount; ++d) {
+            w.wx[d] = kFourierScale * nextNormal();
+            w.wy[d] = kFourierScale * nextNormal();
+            w.b[d]  = 2.0f * kPi * next01();
+        }
+        w.amplitude = std::sqrt(2.0f / static_cast<float>(RandomFourierCount));
+        return w;
+    }();
+    return weights;
+}
+
+int roundUpTo16(int n)
+{
+    return (n + 15) & ~15;
+}
+
+} // namespace
+
+int featureDim(FeatureSet set)
+{
+    switch (set) {
+        case FeatureSet::Raw:           return 2;
+        case FeatureSet::Polynomial:    return 5;
+        case FeatureSet::Trig:          return 6;
+        case FeatureSet::RandomFourier: return 2 + RandomFourierCount;
+    }
+    return 2;
+}
+
+void expandFeatures(FeatureSet set, float x, float y, float* out)
+{
+    out[0] = x;
+    out[1] = y;
+
+    switch (set) {
+        case FeatureSet::Raw:
+            break;
+        case FeatureSet::Polynomial:
+            out[2] = x * x;
+            out[3] = y * y;
+            out[4] = x * y;
+            break;
+        case FeatureSet::Trig:
+            out[2] = std::sin(kPi * x);
+            out[3] = std::cos(kPi * x);
+            out[4] = std::sin(kPi * y);
+            out[5] = std::cos(kPi * y);
+            break;
+        case FeatureSet::RandomFourier: {
+            const FourierWeights& w = fourierWeights();
+            for (int d = 0; d < RandomFourierCount; ++d) {
+                out[2 + d] = w.amplitude * std::cos(w.wx[d] * x + w.wy[d] * y + w.b[d]);
+            }
+            break;
+        }
+    }
+}
+
+void expandFeatureRows(FeatureSet set, const float* xs, const float* ys, int count, float* out)
+{
+    const int dim = featureDim(set);
+    for (int i = 0; i < count; ++i) {
+        expandFeatures(set, xs[i], ys[i], out + static_cast<std::size_t>(i) * dim);
+    }
+}
+
+const char* const* getFeatureSetNames()
+{
+    return kFeatureSetNames;
+}
+
+FeatureColumns::FeatureColumns()
+    : m_set(FeatureSet::Raw)
+    , m_dim(0)
+    , m_count(0)
+    , m_stride(0)
+    , m_valid(false)
+{
+}
+
+void FeatureColumns::build(FeatureSet set, const std::vector<DataPoint>& dataset)
+{
+    m_set    = set;
+    m_dim    = featureDim(set);
+    m_count  = static_cast<int>(dataset.size());
+    m_stride = roundUpTo16(m_count);
+
+    m_values.assign(static_cast<std::size_t>(m_stride) * static_cast<std::size_t>(m_dim), 0.0f);
+
+    float row[MaxFeatureDim];
+    for (int n = 0; n < m_count; ++n) {
+        expandFeatures(set, dataset[n].x, dataset[n].y, row);
+        for (int f = 0; f < m_dim; ++f) {
+            m_values[static_cast<std::size_t>(f) * m_stride + n] = row[f];
+        }
+    }
+
+    m_valid = true;
+}
+
+void FeatureColumns::invalidate()
+{
+    m_valid = false;
+    m_count = 0;
+}
+
+void FeatureColumns::appendPoint(const DataPoint& p)
+{
+    if (!m_valid) {
+        return;
+    }
+
+    if (m_count == m_stride) {
+        // Out of spare rows: re-lay the columns out with 50% headroom.
+        const int newStride = roundUpTo16(m_count + m_count / 2 + 1);
+        std::vector<float, AlignedAllocator<float>> grown(
+            static_cast<std::size_t>(newStride) * static_cast<std::size_t>(m_dim), 0.0f);
+        for (int f = 0; f < m_dim; ++f) {
+            std::copy(column(f), column(f) + m_count,
+                      grown.begin() + static_cast<std::ptrdiff_t>(f) * newStride);
+        }
+        m_values.swap(grown);
+        m_stride = newStride;
+    }
+
+    float row[MaxFeatureDim];
+    expandFeatures(m_set, p.x, p.y, row);
+    for (int f = 0; f < m_dim; ++f) {
+        m_values[static_cast<std::size_t>(f) * m_stride + m_count] = row[f];
+    }
+    ++m_count;
+}
+
+void FeatureColumns::removePointSwap(int index)
+{
+    if (!m_valid || index < 0 || index >= m_count) {
+        return;
+    }
+
+    const int last = m_count - 1;
+    for (int f = 0; f < m_dim; ++f) {
+        float* col = m_values.data() + static_cast<std::size_t>(f) * m_stride;
+        col[index] = col[last];
+        col[last]  = 0.0f;
+    }
+    --m_count;
+}
+
+bool FeatureColumns::matches(FeatureSet set, int count) const
+{
+    return m_valid && m_set == set && m_count == count;
+}
+
+int FeatureColumns::getDim() const
+{
+    return m_dim;
+}
+
+int FeatureColumns::getCount() const
+{
+    return m_count;
+}
+
+const float* FeatureColumns::column(int feature) const
+{
+    return m_values.data() + static_cast<std::size_t>(feature) * m_stride;
+}
+
+std::size_t FeatureColumns::memoryBytes() const
+{
+    return m_values.capacity() * sizeof(float);
+}
+
+void FeatureColumns::gatherRows(const int* indices, int count, float* out) const
+{
+    for (int f = 0; f < m_dim; ++f) {
+        const float* col = column(f);
+        for (int n = 0; n < count; ++n) {
+            out[n * m_dim + f] = col[indices[n]];
+        }
+    }
+}
+
+std::string buildFieldFragmentSource(const std::string& templateSrc, FeatureSet set)
+{
+    const std::string beginMarker = "// @features-begin";
+    const std::string endMarker   = "// @features-end";
+
+    const std::size_t begin = templateSrc.find(beginMarker);
+    const std::size_t end   = templateSrc.find(endMarker);
+    if (begin == std::string::npos || end == std::string::npos || end < begin) {
+        return templateSrc;
+    }
+
+    const int dim = featureDim(set);
+
+    std::string block;
+    char line[256];
+
+    std::snprintf(line, sizeof(line), "const int INPUT_DIM  = %d;\n", dim);
+    block += line;
+    block += "void expandFeatures(vec2 p, out float a0[INPUT_DIM])\n{\n";
+    block += "    a0[0] = p.x;\n";
+    block += "    a0[1] = p.y;\n";
+
+    switch (set) {
+        case FeatureSet::Raw:
+            break;
+        case FeatureSet::Polynomial:
+            block += "    a0[2] = p.x * p.x;\n";
+            block += "    a0[3] = p.y * p.y;\n";
+            block += "    a0[4] = p.x * p.y;\n";
+            break;
+        case FeatureSet::Trig:
+            std::snprintf(line, sizeof(line),
+                          "    const float PI = %.8e;\n", static_cast<double>(kPi));
+            block += line;
+            block += "    a0[2] = sin(PI * p.x);\n";
+            block += "    a0[3] = cos(PI * p.x);\n";
+            block += "    a0[4] = sin(PI * p.y);\n";
+            block += "    a0[5] = cos(PI * p.y);\n";
+            break;
+        case FeatureSet::RandomFourier: {
+            const FourierWeights& w = fourierWeights();
+            for (int d = 0; d < RandomFourierCount; ++d) {
+                std::snprintf(line, sizeof(line),
+                              "    a0[%d] = %.8e * cos(%.8e * p.x + %.8e * p.y + %.8e);\n",
+                              2 + d,
+                              static_cast<double>(w.amplitude),
+                              static_cast<double>(w.wx[d]),
+                              static_cast<double>(w.wy[d]),
+                              static_cast<double>(w.b[d]));
+                block += line;
+            }
+            break;
+        }
+    }
+
+    block += "}\n";
+
+    std::string out;
+    out.reserve(templateSrc.size() + block.size());
+    out.append(templateSrc, 0, begin);
+    out += block;
+    out.append(templateSrc, end + endMarker.size(), std::string::npos);
+    return out;
+}
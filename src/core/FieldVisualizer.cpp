@@ -14,7 +14,11 @@
 #include <GLFW/glfw3.h>
 #endif
 
-#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "GLDebug.h"
+#include "PerfCounters.h"
 
 FieldVisualizer::FieldVisualizer()
     : m_resolution(0)
@@ -23,6 +27,7 @@ FieldVisualizer::FieldVisualizer()
     , m_vao(0)
     , m_vbo(0)
     , m_dirty(false)
+    , m_gpuMemory(MemoryTag::GpuBuffers)
 {
 }
 
@@ -36,8 +41,37 @@ void FieldVisualizer::init(int resolution)
     m_quads = (m_resolution - 1) * (m_resolution - 1);
     m_verts = m_quads * 6;
 
-    // 2 floats per vertex: position only. Color is computed in the fragment shader.
-    m_vertexData.resize(static_cast<std::size_t>(m_verts * 2));
+    // The mesh is a fixed grid over [-1, 1]^2; the field itself is evaluated
+    // per fragment from the weight uniforms, so it is built and uploaded once.
+    const float step  = 2.0f / static_cast<float>(m_resolution - 1);
+    const int   cells = m_resolution - 1;
+    std::vector<float> vertexData(static_cast<std::size_t>(m_verts) * 2);
+
+    std::size_t v = 0;
+    for (int j = 0; j < cells; ++j) {
+        float y0 = -1.0f + step * static_cast<float>(j);
+        float y1 = -1.0f + step * static_cast<float>(j + 1);
+        for (int i = 0; i < cells; ++i) {
+            float x0 = -1.0f + step * static_cast<float>(i);
+            float x1 = -1.0f + step * static_cast<float>(i + 1);
+
+            // First triangle
+            vertexData[v++] = x0;
+            vertexData[v++] = y0;
+            vertexData[v++] = x1;
+            vertexData[v++] = y0;
+            vertexData[v++] = x1;
+            vertexData[v++] = y1;
+
+            // Second triangle
+            vertexData[v++] = x0;
+            vertexData[v++] = y0;
+            vertexData[v++] = x1;
+            vertexData[v++] = y1;
+            vertexData[v++] = x0;
+            vertexData[v++] = y1;
+        }
+    }
 
     glGenVertexArrays(1, &m_vao);
     glGenBuffers(1, &m_vbo);
@@ -45,8 +79,13 @@ void FieldVisualizer::init(int resolution)
     glBindVertexArray(m_vao);
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
-    const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(m_vertexData.size() * sizeof(float));
-    glBufferData(GL_ARRAY_BUFFER, bufferSize, nullptr, GL_DYNAMIC_DRAW);
+    // 2 floats per vertex: position only. Color is computed in the fragment shader.
+    const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(vertexData.size() * sizeof(float));
+    glBufferData(GL_ARRAY_BUFFER, bufferSize, vertexData.data(), GL_STATIC_DRAW);
+    m_gpuMemory.set(static_cast<std::size_t>(bufferSize));
+    PerfRegistry::shared().add(PerfCounter::UploadBytes, static_cast<std::uint64_t>(bufferSize));
+    labelGLObject(GLObjectType::VertexArray, m_vao, "field VAO");
+    labelGLObject(GLObjectType::Buffer, m_vbo, "field VBO");
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), reinterpret_cast<void*>(0));
@@ -68,43 +107,8 @@ bool FieldVisualizer::isDirty() const
 
 void FieldVisualizer::update()
 {
-    if (!m_vao || !m_vbo) {
-        return;
-    }
-
-    const float step = 2.0f / static_cast<float>(m_resolution - 1);
-
-    std::size_t v = 0;
-
-    for (int j = 0; j < m_resolution - 1; ++j) {
-        float y0 = -1.0f + step * static_cast<float>(j);
-        float y1 = -1.0f + step * static_cast<float>(j + 1);
-        for (int i = 0; i < m_resolution - 1; ++i) {
-            float x0 = -1.0f + step * static_cast<float>(i);
-            float x1 = -1.0f + step * static_cast<float>(i + 1);
-
-            // First triangle
-            m_vertexData[v++] = x0;
-            m_vertexData[v++] = y0;
-            m_vertexData[v++] = x1;
-            m_vertexData[v++] = y0;
-            m_vertexData[v++] = x1;
-            m_vertexData[v++] = y1;
-
-            // Second triangle
-            m_vertexData[v++] = x0;
-            m_vertexData[v++] = y0;
-            m_vertexData[v++] = x1;
-            m_vertexData[v++] = y1;
-            m_vertexData[v++] = x0;
-            m_vertexData[v++] = y1;
-        }
-    }
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(m_vertexData.size() * sizeof(float));
-    glBufferSubData(GL_ARRAY_BUFFER, 0, bufferSize, m_vertexData.data());
-
+    // Nothing to rebuild: the mesh never changes and the weights are set as
+    // uniforms on every draw.
     m_dirty = false;
 }
 
@@ -130,6 +134,6 @@ void FieldVisualizer::shutdown()
         m_vbo = 0;
     }
 
-    m_vertexData.clear();
     m_dirty = false;
+    m_gpuMemory.set(0);
 }
@@ -0,0 +1,258 @@
+#include "HogwildTrainer.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+#include "ThreadPool.h"
+
+namespace {
+
+// Small per-worker generator for minibatch sampling (splitmix64).
+struct BatchRng {
+    std::uint64_t state;
+
+    explicit BatchRng(std::uint64_t seed)
+        : state(seed)
+    {
+    }
+
+    std::uint32_t next()
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<std::uint32_t>((z ^ (z >> 31)) >> 32);
+    }
+};
+
+int stalenessBucket(std::uint64_t staleness)
+{
+    int bucket = 0;
+    while (staleness > 0 && bucket < HogwildStalenessBuckets - 1) {
+        staleness >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+} // namespace
+
+HogwildTrainer::HogwildTrainer()
+    : m_paramCount(0)
+    , m_version(0)
+    , m_stop(false)
+    , m_optimizer(static_cast<int>(OptimizerType::SGD))
+    , m_learningRate(0.1f)
+    , m_momentum(0.9f)
+    , m_batchSize(1)
+    , m_workerCount(0)
+    , m_lastWorker(0)
+{
+}
+
+HogwildTrainer::~HogwildTrainer()
+{
+    stop();
+}
+
+int HogwildTrainer::defaultThreadCount()
+{
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return 0;
+#else
+    // The shared pool's workers sleep while Hogwild runs, so this fills the
+    // same cores without oversubscribing them.
+    return ThreadPool::shared().concurrency();
+#endif
+}
+
+bool HogwildTrainer::start(const ToyNet& net,
+                           const std::vector<DataPoint>& dataset,
+                           int threadCount,
+                           int batchSize)
+{
+    stop();
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    (void)net;
+    (void)dataset;
+    (void)threadCount;
+    (void)batchSize;
+    NN_LOG_ERROR("Hogwild training requires thread support");
+    return false;
+#else
+    if (dataset.empty() || threadCount < 1) {
+        return false;
+    }
+
+    m_paramCount = net.getParameterCount();
+    std::vector<float> initial(static_cast<std::size_t>(m_paramCount));
+    net.copyParametersTo(initial.data());
+
+    m_params.reset(new std::atomic<float>[m_paramCount]);
+    m_velocity.reset(new std::atomic<float>[m_paramCount]);
+    for (int i = 0; i < m_paramCount; ++i) {
+        m_params[i].store(initial[i], std::memory_order_relaxed);
+        m_velocity[i].store(0.0f, std::memory_order_relaxed);
+    }
+    m_readScratch.resize(static_cast<std::size_t>(m_paramCount));
+
+    m_dataset   = dataset;
+    m_batchSize = std::max(1, std::min(batchSize, ToyNet::MaxBatch));
+    m_version.store(0, std::memory_order_relaxed);
+    m_stop.store(false, std::memory_order_relaxed);
+    m_lastWorker.store(0, std::memory_order_relaxed);
+    m_workerStats.reset(new WorkerStats[threadCount]);
+    m_workerCount = threadCount;
+    m_startTime = std::chrono::steady_clock::now();
+
+    m_threads.reserve(static_cast<std::size_t>(threadCount));
+    for (int i = 0; i < threadCount; ++i) {
+        // Each worker gets its own network for activations and gradients;
+        // only the parameter array is shared.
+        ToyNet localNet = net;
+        localNet.setParallelTraining(false);
+        m_threads.emplace_back(&HogwildTrainer::workerLoop, this, i, std::move(localNet));
+    }
+    return true;
+#endif
+}
+
+void HogwildTrainer::stop()
+{
+    if (m_threads.empty()) {
+        return;
+    }
+    m_stop.store(true, std::memory_order_relaxed);
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+    m_stopTime = std::chrono::steady_clock::now();
+}
+
+bool HogwildTrainer::isRunning() const
+{
+    return !m_threads.empty();
+}
+
+void HogwildTrainer::setHyperparams(OptimizerType type, float learningRate, float momentum)
+{
+    m_optimizer.store(static_cast<int>(type), std::memory_order_relaxed);
+    m_learningRate.store(learningRate, std::memory_order_relaxed);
+    m_momentum.store(momentum, std::memory_order_relaxed);
+}
+
+void HogwildTrainer::readParameters(ToyNet& net)
+{
+    if (!m_params || net.getParameterCount() != m_paramCount) {
+        return;
+    }
+    for (int i = 0; i < m_paramCount; ++i) {
+        m_readScratch[i] = m_params[i].load(std::memory_order_relaxed);
+    }
+    net.copyParametersFrom(m_readScratch.data());
+}
+
+HogwildStats HogwildTrainer::stats() const
+{
+    HogwildStats out{};
+    const int workerCount = m_workerCount;
+    if (!m_workerStats || workerCount == 0) {
+        return out;
+    }
+
+    std::uint64_t stalenessSum = 0;
+    for (int w = 0; w < workerCount; ++w) {
+        const WorkerStats& ws = m_workerStats[w];
+        out.updates  += ws.updates.load(std::memory_order_relaxed);
+        stalenessSum += ws.stalenessSum.load(std::memory_order_relaxed);
+        out.maxStaleness = std::max(out.maxStaleness, ws.stalenessMax.load(std::memory_order_relaxed));
+        for (int b = 0; b < HogwildStalenessBuckets; ++b) {
+            out.stalenessHistogram[b] += ws.histogram[b].load(std::memory_order_relaxed);
+        }
+    }
+
+    if (out.updates > 0) {
+        out.meanStaleness = static_cast<float>(static_cast<double>(stalenessSum) /
+                                               static_cast<double>(out.updates));
+    }
+
+    const auto endTime = isRunning() ? std::chrono::steady_clock::now() : m_stopTime;
+    const double seconds = std::chrono::duration<double>(endTime - m_startTime).count();
+    if (seconds > 0.0) {
+        out.updatesPerSecond = static_cast<double>(out.updates) / seconds;
+    }
+
+    const WorkerStats& last = m_workerStats[m_lastWorker.load(std::memory_order_relaxed)];
+    out.lastLoss     = last.lastLoss.load(std::memory_order_relaxed);
+    out.lastAccuracy = last.lastAccuracy.load(std::memory_order_relaxed);
+    return out;
+}
+
+void HogwildTrainer::workerLoop(int index, ToyNet localNet)
+{
+    WorkerStats& ws = m_workerStats[index];
+    BatchRng rng(0xC0FFEEull + static_cast<std::uint64_t>(index) * 0x9E3779B97F4A7C15ull);
+
+    const int dataCount = static_cast<int>(m_dataset.size());
+    std::vector<DataPoint> batch(static_cast<std::size_t>(m_batchSize));
+    std::vector<float> params(static_cast<std::size_t>(m_paramCount));
+    std::vector<float> grads(static_cast<std::size_t>(m_paramCount));
+
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        // Snapshot the shared parameters. Other workers may be writing at the
+        // same time, so the snapshot can mix old and new values; that is the
+        // Hogwild trade-off.
+        const std::uint64_t seenVersion = m_version.load(std::memory_order_relaxed);
+        for (int i = 0; i < m_paramCount; ++i) {
+            params[i] = m_params[i].load(std::memory_order_relaxed);
+        }
+        localNet.copyParametersFrom(params.data());
+
+        for (auto& p : batch) {
+            p = m_dataset[rng.next() % static_cast<std::uint32_t>(dataCount)];
+        }
+
+        float accuracy = 0.0f;
+        const float loss = localNet.computeGradients(batch, accuracy);
+        localNet.copyGradientsTo(grads.data());
+
+        const float lr = m_learningRate.load(std::memory_order_relaxed);
+        const bool  useMomentum = m_optimizer.load(std::memory_order_relaxed) ==
+                                  static_cast<int>(OptimizerType::SGDMomentum);
+
+        if (useMomentum) {
+            const float mu = m_momentum.load(std::memory_order_relaxed);
+            for (int i = 0; i < m_paramCount; ++i) {
+                float v = mu * m_velocity[i].load(std::memory_order_relaxed) + grads[i];
+                m_velocity[i].store(v, std::memory_order_relaxed);
+                m_params[i].store(m_params[i].load(std::memory_order_relaxed) - lr * v,
+                                  std::memory_order_relaxed);
+            }
+        } else {
+            for (int i = 0; i < m_paramCount; ++i) {
+                m_params[i].store(m_params[i].load(std::memory_order_relaxed) - lr * grads[i],
+                                  std::memory_order_relaxed);
+            }
+        }
+
+        const std::uint64_t staleness =
+            m_version.fetch_add(1, std::memory_order_relaxed) - seenVersion;
+
+        ws.updates.store(ws.updates.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        ws.stalenessSum.store(ws.stalenessSum.load(std::memory_order_relaxed) + staleness,
+                              std::memory_order_relaxed);
+        const int clamped = static_cast<int>(std::min<std::uint64_t>(staleness, 1u << 30));
+        if (clamped > ws.stalenessMax.load(std::memory_order_relaxed)) {
+            ws.stalenessMax.store(clamped, std::memory_order_relaxed);
+        }
+        auto& bucket = ws.histogram[stalenessBucket(staleness)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        ws.lastLoss.store(loss, std::memory_order_relaxed);
+        ws.lastAccuracy.store(accuracy, std::memory_order_relaxed);
+        m_lastWorker.store(index, std::memory_order_relaxed);
+    }
+}
@@ -7,13 +7,38 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
-#include <iostream>
-
 #include "Input.h"
 #include "Object2D.h"
 #include "GeometryUtils.h"
 #include "DataPoint.h"
 #include "ControlPanel.h"
+#include "PointGrid.h"
+#include "Logger.h"
+
+namespace {
+
+// Convert the cursor from window coordinates into clip-space [-1, 1] so the
+// mouse position lives in the same space as the dataset points and
+// decision field. Returns false if the window has no area.
+bool cursorToNdc(GLFWwindow* window, float& xNdc, float& yNdc)
+{
+    double mouseX = 0.0;
+    double mouseY = 0.0;
+    glfwGetCursorPos(window, &mouseX, &mouseY);
+
+    int winWidth = 0;
+    int winHeight = 0;
+    glfwGetWindowSize(window, &winWidth, &winHeight);
+    if (winWidth <= 0 || winHeight <= 0) {
+        return false;
+    }
+
+    xNdc =  2.0f * static_cast<float>(mouseX) / static_cast<float>(winWidth) - 1.0f;
+    yNdc =  1.0f - 2.0f * static_cast<float>(mouseY) / static_cast<float>(winHeight);
+    return true;
+}
+
+} // namespace
 
 void handleKeyboardInput(GLFWwindow* window,
                          Object2D* objects,
@@ -32,7 +57,7 @@ void handleKeyboardInput(GLFWwindow* window,
     int tabState = glfwGetKey(window, GLFW_KEY_TAB);
     if (tabState == GLFW_PRESS && !tabPressedLastFrame) {
         selectedObject = (selectedObject + 1) % objectCount;
-        std::cout << "[Input] TAB -> selectedObject = " << selectedObject << std::endl;
+        NN_LOG_INFO("[Input] TAB -> selectedObject = %d", selectedObject);
     }
     tabPressedLastFrame = (tabState == GLFW_PRESS);
 
@@ -42,62 +67,62 @@ void handleKeyboardInput(GLFWwindow* window,
     // Arrow keys move the active object by changing the offset uniform
     if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
         active.offsetY += moveSpeed;
-        std::cout << "[Input] UP    -> offset = (" << active.offsetX << ", " << active.offsetY << ")" << std::endl;
+        NN_LOG_DEBUG("[Input] UP    -> offset = (%g, %g)", active.offsetX, active.offsetY);
     }
     if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
         active.offsetY -= moveSpeed;
-        std::cout << "[Input] DOWN  -> offset = (" << active.offsetX << ", " << active.offsetY << ")" << std::endl;
+        NN_LOG_DEBUG("[Input] DOWN  -> offset = (%g, %g)", active.offsetX, active.offsetY);
     }
     if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
         active.offsetX -= moveSpeed;
-        std::cout << "[Input] LEFT  -> offset = (" << active.offsetX << ", " << active.offsetY << ")" << std::endl;
+        NN_LOG_DEBUG("[Input] LEFT  -> offset = (%g, %g)", active.offsetX, active.offsetY);
     }
     if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
         active.offsetX += moveSpeed;
-        std::cout << "[Input] RIGHT -> offset = (" << active.offsetX << ", " << active.offsetY << ")" << std::endl;
+        NN_LOG_DEBUG("[Input] RIGHT -> offset = (%g, %g)", active.offsetX, active.offsetY);
     }
 
     // Scale controls (Z/X)
     if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS) {
         active.scale -= scaleStep;
         if (active.scale < 0.1f) active.scale = 0.1f; // avoid inverting/vanishing
-        std::cout << "[Input] Z -> scale = " << active.scale << std::endl;
+        NN_LOG_DEBUG("[Input] Z -> scale = %g", active.scale);
     }
     if (glfwGetKey(window, GLFW_KEY_X) == GLFW_PRESS) {
         active.scale += scaleStep;
-        std::cout << "[Input] X -> scale = " << active.scale << std::endl;
+        NN_LOG_DEBUG("[Input] X -> scale = %g", active.scale);
     }
 
     // Rotation controls (Q/E)
     if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) {
         active.rotation -= rotationStep;
-        std::cout << "[Input] Q -> rotation = " << active.rotation << " radians" << std::endl;
+        NN_LOG_DEBUG("[Input] Q -> rotation = %g radians", active.rotation);
     }
     if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) {
         active.rotation += rotationStep;
-        std::cout << "[Input] E -> rotation = " << active.rotation << " radians" << std::endl;
+        NN_LOG_DEBUG("[Input] E -> rotation = %g radians", active.rotation);
     }
 
     // Number keys change the color uniform of the active object
     if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS) {
         active.color[0] = 1.0f; active.color[1] = 0.0f; active.color[2] = 0.0f; // Red
-        std::cout << "[Input] 1 -> color = RED" << std::endl;
+        NN_LOG_DEBUG("[Input] 1 -> color = RED");
     }
     if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS) {
         active.color[0] = 0.0f; active.color[1] = 1.0f; active.color[2] = 0.0f; // Green
-        std::cout << "[Input] 2 -> color = GREEN" << std::endl;
+        NN_LOG_DEBUG("[Input] 2 -> color = GREEN");
     }
     if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) {
         active.color[0] = 0.0f; active.color[1] = 0.0f; active.color[2] = 1.0f; // Blue
-        std::cout << "[Input] 3 -> color = BLUE" << std::endl;
+        NN_LOG_DEBUG("[Input] 3 -> color = BLUE");
     }
     if (glfwGetKey(window, GLFW_KEY_4) == GLFW_PRESS) {
         active.color[0] = 1.0f; active.color[1] = 1.0f; active.color[2] = 1.0f; // White
-        std::cout << "[Input] 4 -> color = WHITE" << std::endl;
+        NN_LOG_DEBUG("[Input] 4 -> color = WHITE");
     }
     if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS) {
         active.color[0] = 1.0f; active.color[1] = 0.5f; active.color[2] = 0.2f; // Back to original orange
-        std::cout << "[Input] 5 -> color = ORANGE" << std::endl;
+        NN_LOG_DEBUG("[Input] 5 -> color = ORANGE");
     }
 }
 
@@ -172,14 +197,14 @@ void handleMouseInput(GLFWwindow* window,
 
             if (hitTriangle && !hitSquare) {
                 selectedObject = 0;
-                std::cout << "[Pick] Selected triangle" << std::endl;
+                NN_LOG_INFO("[Pick] Selected triangle");
             } else if (!hitTriangle && hitSquare) {
                 selectedObject = 1;
-                std::cout << "[Pick] Selected square" << std::endl;
+                NN_LOG_INFO("[Pick] Selected square");
             } else if (hitTriangle && hitSquare) {
                 // If both are hit (overlap), prefer the square for now.
                 selectedObject = 1;
-                std::cout << "[Pick] Selected square (overlap)" << std::endl;
+                NN_LOG_INFO("[Pick] Selected square (overlap)");
             }
         }
     }
@@ -189,6 +214,7 @@ void handleMouseInput(GLFWwindow* window,
 
 void handleProbeSelection(GLFWwindow* window,
                           const std::vector<DataPoint>& dataset,
+                          const PointGrid& grid,
                           UiState& ui,
                           bool& leftMousePressedLastFrame,
                           bool mouseOverGui)
@@ -199,34 +225,11 @@ void handleProbeSelection(GLFWwindow* window,
 
     int leftState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
     if (leftState == GLFW_PRESS && !leftMousePressedLastFrame && !mouseOverGui) {
-        double mouseX = 0.0;
-        double mouseY = 0.0;
-        glfwGetCursorPos(window, &mouseX, &mouseY);
-
-        int winWidth = 0;
-        int winHeight = 0;
-        glfwGetWindowSize(window, &winWidth, &winHeight);
-        if (winWidth > 0 && winHeight > 0) {
-            // Convert from window coordinates into clip-space [-1, 1]
-            // so the mouse position lives in the same space as the
-            // dataset points and decision field.
-            float xNdc =  2.0f * static_cast<float>(mouseX) / static_cast<float>(winWidth) - 1.0f;
-            float yNdc =  1.0f - 2.0f * static_cast<float>(mouseY) / static_cast<float>(winHeight);
-
-            int   bestIndex = -1;
-            float bestDist2 = 0.0f;
+        float xNdc = 0.0f;
+        float yNdc = 0.0f;
+        if (cursorToNdc(window, xNdc, yNdc)) {
             const float pickRadius = 0.15f; // enlarged radius for easier selection
-            const float maxDist2   = pickRadius * pickRadius;
-
-            for (std::size_t i = 0; i < dataset.size(); ++i) {
-                float dx = dataset[i].x - xNdc;
-                float dy = dataset[i].y - yNdc;
-                float d2 = dx * dx + dy * dy;
-                if (d2 <= maxDist2 && (bestIndex < 0 || d2 < bestDist2)) {
-                    bestIndex = static_cast<int>(i);
-                    bestDist2 = d2;
-                }
-            }
+            const int bestIndex = grid.nearest(dataset, xNdc, yNdc, pickRadius);
 
             if (bestIndex >= 0) {
                 ui.probeEnabled       = true;
@@ -241,3 +244,42 @@ void handleProbeSelection(GLFWwindow* window,
 
     leftMousePressedLastFrame = (leftState == GLFW_PRESS);
 }
+
+PointEdit handlePointEditing(GLFWwindow* window,
+                             const std::vector<DataPoint>& dataset,
+                             const PointGrid& grid,
+                             const UiState& ui,
+                             bool& leftMousePressedLastFrame,
+                             bool mouseOverGui)
+{
+    PointEdit edit;
+    if (!window) {
+        return edit;
+    }
+
+    int leftState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
+    if (leftState == GLFW_PRESS && !leftMousePressedLastFrame && !mouseOverGui) {
+        float xNdc = 0.0f;
+        float yNdc = 0.0f;
+        if (cursorToNdc(window, xNdc, yNdc)) {
+            const bool shift = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
+                               glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS;
+            if (shift) {
+                const float removeRadius = 0.05f;
+                const int index = grid.nearest(dataset, xNdc, yNdc, removeRadius);
+                if (index >= 0) {
+                    edit.kind  = PointEdit::Remove;
+                    edit.index = index;
+                }
+            } else {
+                edit.kind  = PointEdit::Add;
+                edit.label = ui.editLabel;
+            }
+            edit.x = xNdc;
+            edit.y = yNdc;
+        }
+    }
+
+    leftMousePressedLastFrame = (leftState == GLFW_PRESS);
+    return edit;
+}
@@ -0,0 +1,144 @@
+#include "LinearArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+// Resets in a row under a quarter of capacity before the block shrinks.
+const int kShrinkAfterResets = 256;
+
+} // namespace
+
+LinearArena::LinearArena(std::size_t blockBytes)
+    : m_block(0)
+    , m_offset(0)
+    , m_blockBytes(blockBytes > 0 ? blockBytes : 1)
+    , m_peak(0)
+    , m_idleResets(0)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    freeBlocks();
+}
+
+void* LinearArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (alignment == 0) {
+        alignment = 1;
+    }
+    if (m_blocks.empty()) {
+        addBlock(bytes + alignment);
+    }
+
+    for (;;) {
+        const Block& block = m_blocks[m_block];
+        const std::uintptr_t base    = reinterpret_cast<std::uintptr_t>(block.data);
+        const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+        const std::size_t    start   = static_cast<std::size_t>(aligned - base);
+        if (start + bytes <= block.size) {
+            m_offset = start + bytes;
+            return block.data + start;
+        }
+
+        // Blocks kept from an earlier cycle are reused before adding one.
+        if (m_block + 1 >= m_blocks.size()) {
+            addBlock(bytes + alignment);
+        }
+        ++m_block;
+        m_offset = 0;
+    }
+}
+
+void LinearArena::reset()
+{
+    const std::size_t used = bytesUsed();
+
+    if (m_blocks.size() > 1) {
+        // The cycle overflowed; next time it fits in one block.
+        const std::size_t size = std::max(m_blockBytes, used);
+        freeBlocks();
+        addBlock(size);
+        m_idleResets = 0;
+        m_peak       = 0;
+    } else if (!m_blocks.empty() && m_blocks[0].size > m_blockBytes) {
+        if (used < m_blocks[0].size / 4) {
+            m_peak = std::max(m_peak, used);
+            if (++m_idleResets >= kShrinkAfterResets) {
+                const std::size_t size = std::max(m_blockBytes, 2 * m_peak);
+                freeBlocks();
+                addBlock(size);
+                m_idleResets = 0;
+                m_peak       = 0;
+            }
+        } else {
+            m_idleResets = 0;
+            m_peak       = 0;
+        }
+    }
+
+    m_block  = 0;
+    m_offset = 0;
+}
+
+LinearArena::Mark LinearArena::mark() const
+{
+    return Mark{m_block, m_offset};
+}
+
+void LinearArena::rewind(const Mark& m)
+{
+    m_block  = m.block;
+    m_offset = m.offset;
+}
+
+std::size_t LinearArena::bytesUsed() const
+{
+    // Earlier blocks count in full; their tails could not be used.
+    std::size_t used = m_offset;
+    for (std::size_t i = 0; i < m_block && i < m_blocks.size(); ++i) {
+        used += m_blocks[i].size;
+    }
+    return used;
+}
+
+std::size_t LinearArena::capacity() const
+{
+    std::size_t total = 0;
+    for (const Block& block : m_blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+void LinearArena::addBlock(std::size_t minBytes)
+{
+    Block block;
+    block.size = std::max(m_blockBytes, minBytes);
+    block.data = static_cast<unsigned char*>(::operator new(block.size));
+    m_blocks.push_back(block);
+}
+
+void LinearArena::freeBlocks()
+{
+    for (const Block& block : m_blocks) {
+        ::operator delete(block.data);
+    }
+    m_blocks.clear();
+    m_block  = 0;
+    m_offset = 0;
+}
+
+LinearArena& frameArena()
+{
+    static LinearArena arena(1024 * 1024);
+    return arena;
+}
+
+LinearArena& scratchArena()
+{
+    thread_local LinearArena arena(64 * 1024);
+    return arena;
+}
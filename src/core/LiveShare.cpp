@@ -0,0 +1,308 @@
+#include "LiveShare.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include "Logger.h"
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define NNDEMO_LIVE_SHARE 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const std::uint32_t kLiveMagic   = 0x4E4E4C56u; // "NNLV"
+const std::uint32_t kLiveVersion = 1;
+
+// A reader gives up for this frame after this many torn reads; it will
+// try again next frame.
+const int kMaxReadAttempts = 64;
+
+} // namespace
+
+// Everything after `sequence` is written only between an odd and the next
+// even sequence value.
+struct LiveSegment {
+    std::uint32_t              magic;
+    std::uint32_t              version;
+    std::atomic<std::uint32_t> sequence;
+    std::int32_t               writerPid;
+
+    std::int32_t  finished;
+    std::int32_t  step;
+    float         loss;
+    float         accuracy;
+    std::int32_t  featureSet;
+    std::int32_t  paramCount;
+    std::int32_t  datasetIndex;
+    std::int32_t  numPoints;
+    float         spread;
+    std::uint32_t datasetSeed;
+    std::int32_t  historyTotal; // points ever published; slot = n % LiveHistorySize
+
+    float params[LiveMaxParams];
+    float lossHistory[LiveHistorySize];
+    float accuracyHistory[LiveHistorySize];
+};
+
+// ---------------------------------------------------------------------------
+// LivePublisher
+
+LivePublisher::LivePublisher()
+    : m_segment(nullptr)
+    , m_sequence(0)
+{
+}
+
+LivePublisher::~LivePublisher()
+{
+    destroy();
+}
+
+bool LivePublisher::create(const std::string& name, const LiveDatasetInfo& dataset)
+{
+#ifdef NNDEMO_LIVE_SHARE
+    destroy();
+
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        NN_LOG_ERROR("[Live] shm_open failed for %s: %s", name.c_str(), std::strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(sizeof(LiveSegment))) != 0) {
+        NN_LOG_ERROR("[Live] ftruncate failed for %s: %s", name.c_str(), std::strerror(errno));
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, sizeof(LiveSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        NN_LOG_ERROR("[Live] mmap failed for %s: %s", name.c_str(), std::strerror(errno));
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // The mapping is zero-filled, so only the non-zero fields need setting.
+    m_segment = new (base) LiveSegment();
+    m_segment->magic        = kLiveMagic;
+    m_segment->version      = kLiveVersion;
+    m_segment->writerPid    = static_cast<std::int32_t>(getpid());
+    m_segment->datasetIndex = dataset.datasetIndex;
+    m_segment->numPoints    = dataset.numPoints;
+    m_segment->spread       = dataset.spread;
+    m_segment->datasetSeed  = dataset.seed;
+    m_segment->sequence.store(0, std::memory_order_release);
+
+    m_sequence = 0;
+    m_name     = name;
+    return true;
+#else
+    (void)name;
+    (void)dataset;
+    NN_LOG_ERROR("[Live] Live sharing is only supported on Linux");
+    return false;
+#endif
+}
+
+void LivePublisher::destroy()
+{
+#ifdef NNDEMO_LIVE_SHARE
+    if (!m_segment) {
+        return;
+    }
+    munmap(m_segment, sizeof(LiveSegment));
+    // Attached viewers keep their mapping; unlinking only hides the name.
+    shm_unlink(m_name.c_str());
+#endif
+    m_segment = nullptr;
+}
+
+void LivePublisher::beginWrite()
+{
+    m_segment->sequence.store(++m_sequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void LivePublisher::endWrite()
+{
+    m_segment->sequence.store(++m_sequence, std::memory_order_release);
+}
+
+void LivePublisher::publish(const ToyNet& net, int step, float loss, float accuracy)
+{
+    if (!m_segment) {
+        return;
+    }
+
+    LiveSegment& seg = *m_segment;
+    beginWrite();
+    seg.step       = step;
+    seg.loss       = loss;
+    seg.accuracy   = accuracy;
+    seg.featureSet = static_cast<std::int32_t>(net.getFeatureSet());
+    seg.paramCount = net.getParameterCount();
+    net.copyParametersTo(seg.params);
+
+    const int slot = seg.historyTotal % LiveHistorySize;
+    seg.lossHistory[slot]     = loss;
+    seg.accuracyHistory[slot] = accuracy;
+    ++seg.historyTotal;
+    endWrite();
+}
+
+void LivePublisher::finish()
+{
+    if (!m_segment) {
+        return;
+    }
+    beginWrite();
+    m_segment->finished = 1;
+    endWrite();
+}
+
+// ---------------------------------------------------------------------------
+// LiveSubscriber
+
+LiveSubscriber::LiveSubscriber()
+    : m_segment(nullptr)
+    , m_lastSequence(0)
+    , m_historyRead(0)
+{
+}
+
+LiveSubscriber::~LiveSubscriber()
+{
+    detach();
+}
+
+bool LiveSubscriber::attach(const std::string& name)
+{
+#ifdef NNDEMO_LIVE_SHARE
+    detach();
+
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        NN_LOG_WARN("[Live] Cannot open live segment %s: %s", name.c_str(), std::strerror(errno));
+        return false;
+    }
+    void* base = mmap(nullptr, sizeof(LiveSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        NN_LOG_ERROR("[Live] mmap failed for %s: %s", name.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    const LiveSegment* seg = static_cast<const LiveSegment*>(base);
+    if (seg->magic != kLiveMagic || seg->version != kLiveVersion) {
+        NN_LOG_WARN("[Live] Segment %s is not a live training segment", name.c_str());
+        munmap(base, sizeof(LiveSegment));
+        return false;
+    }
+
+    m_segment      = seg;
+    m_lastSequence = ~0u;
+    m_historyRead  = 0;
+    m_scratchParams.reserve(LiveMaxParams);
+    m_scratchLoss.reserve(LiveHistorySize);
+    m_scratchAccuracy.reserve(LiveHistorySize);
+    return true;
+#else
+    (void)name;
+    NN_LOG_ERROR("[Live] Live sharing is only supported on Linux");
+    return false;
+#endif
+}
+
+void LiveSubscriber::detach()
+{
+#ifdef NNDEMO_LIVE_SHARE
+    if (m_segment) {
+        munmap(const_cast<LiveSegment*>(m_segment), sizeof(LiveSegment));
+    }
+#endif
+    m_segment = nullptr;
+}
+
+bool LiveSubscriber::isAttached() const
+{
+    return m_segment != nullptr;
+}
+
+bool LiveSubscriber::read(LiveSnapshot& out)
+{
+    if (!m_segment) {
+        return false;
+    }
+    const LiveSegment& seg = *m_segment;
+
+    for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+        const std::uint32_t before = seg.sequence.load(std::memory_order_acquire);
+        if (before & 1u) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (before == m_lastSequence) {
+            return false;
+        }
+
+        // Copy into scratch first; nothing in `out` changes unless the
+        // sequence proves the copy was not torn.
+        const int paramCount   = std::min(std::max(seg.paramCount, 0), LiveMaxParams);
+        const int historyTotal = seg.historyTotal;
+        const int historyFrom  = std::max(m_historyRead, historyTotal - LiveHistorySize);
+        const int newPoints    = std::max(0, historyTotal - historyFrom);
+
+        m_scratchParams.assign(seg.params, seg.params + paramCount);
+        m_scratchLoss.resize(static_cast<std::size_t>(newPoints));
+        m_scratchAccuracy.resize(static_cast<std::size_t>(newPoints));
+        for (int i = 0; i < newPoints; ++i) {
+            const int slot = (historyFrom + i) % LiveHistorySize;
+            m_scratchLoss[i]     = seg.lossHistory[slot];
+            m_scratchAccuracy[i] = seg.accuracyHistory[slot];
+        }
+
+        LiveSnapshot next;
+        next.writerPid           = seg.writerPid;
+        next.finished            = seg.finished != 0;
+        next.step                = seg.step;
+        next.loss                = seg.loss;
+        next.accuracy            = seg.accuracy;
+        next.featureSet          = static_cast<FeatureSet>(seg.featureSet);
+        next.dataset.datasetIndex = seg.datasetIndex;
+        next.dataset.numPoints   = seg.numPoints;
+        next.dataset.spread      = seg.spread;
+        next.dataset.seed        = seg.datasetSeed;
+        next.historyTotal        = historyTotal;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seg.sequence.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+
+        out.writerPid    = next.writerPid;
+        out.finished     = next.finished;
+        out.step         = next.step;
+        out.loss         = next.loss;
+        out.accuracy     = next.accuracy;
+        out.featureSet   = next.featureSet;
+        out.dataset      = next.dataset;
+        out.params       = m_scratchParams;
+        out.historyTotal = next.historyTotal;
+        out.newLoss.assign(m_scratchLoss.begin(), m_scratchLoss.end());
+        out.newAccuracy.assign(m_scratchAccuracy.begin(), m_scratchAccuracy.end());
+
+        m_lastSequence = before;
+        m_historyRead  = historyTotal;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,376 @@
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+// No threads to flush on; every message is written as it is logged.
+#define NN_LOG_SYNCHRONOUS
+#else
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#endif
+
+#include "AllocTracker.h"
+
+namespace {
+
+struct LevelName {
+    const char* name;
+    LogLevel    level;
+};
+
+const LevelName kLevelNames[] = {
+    {"debug", LogLevel::Debug},
+    {"info",  LogLevel::Info},
+    {"warn",  LogLevel::Warn},
+    {"error", LogLevel::Error},
+    {"off",   LogLevel::Off},
+};
+
+LogLevel levelFromEnv()
+{
+    const char* env = std::getenv("NNDEMO_LOG_LEVEL");
+    if (env) {
+        for (const LevelName& entry : kLevelNames) {
+            if (std::strcmp(env, entry.name) == 0) {
+                return entry.level;
+            }
+        }
+        std::fprintf(stderr, "[Log] Unknown NNDEMO_LOG_LEVEL value '%s'\n", env);
+    }
+    return LogLevel::Info;
+}
+
+std::atomic<int>& levelState()
+{
+    static std::atomic<int> level(static_cast<int>(levelFromEnv()));
+    return level;
+}
+
+// Format into `text`, marking messages that did not fit.
+void formatMessage(char* text, const char* format, va_list args)
+{
+    const int length = std::vsnprintf(text, LogMessageBytes, format, args);
+    if (length >= LogMessageBytes) {
+        std::memcpy(text + LogMessageBytes - 4, "...", 4);
+    } else if (length < 0) {
+        std::snprintf(text, LogMessageBytes, "[Log] bad format: %s", format);
+    }
+}
+
+#ifndef NN_LOG_SYNCHRONOUS
+
+typedef std::chrono::steady_clock Clock;
+
+// How long the flusher sleeps when nobody wakes it.
+const std::chrono::milliseconds kFlushInterval(10);
+
+struct LogRecord {
+    Clock::rep time;
+    char       text[LogMessageBytes];
+};
+
+// Single-producer / single-consumer ring: the owning thread advances head,
+// the flusher (holding LogSink::m_mutex) advances tail.
+struct LogRing {
+    LogRecord records[LogRingRecords];
+
+    alignas(64) std::atomic<std::uint32_t> head{0};
+    alignas(64) std::atomic<std::uint32_t> tail{0};
+    std::atomic<std::uint32_t> dropped{0};
+    std::atomic<bool>          retired{false}; // owner has exited
+};
+
+// Drains the rings of all threads to the output file.
+class LogSink {
+public:
+    static LogSink& shared();
+
+    LogRing* registerRing();
+    void wake();
+    void flush();
+    void writeNow(const char* text);
+    bool stopped() const { return m_stopped.load(std::memory_order_acquire); }
+
+private:
+    struct Pending {
+        Clock::rep    time;
+        std::uint32_t ring;
+        std::uint32_t slot;
+    };
+
+    LogSink();
+    void run();
+    void drain();
+    static void stopAtExit();
+
+    std::mutex                 m_mutex; // rings, draining and the output
+    std::vector<LogRing*>      m_rings;
+    std::vector<std::uint32_t> m_heads;
+    std::vector<Pending>       m_pending;
+    std::string                m_buffer;
+    std::FILE*                 m_out;
+
+    std::mutex              m_wakeMutex;
+    std::condition_variable m_wake;
+    bool                    m_stop;
+    std::atomic<bool>       m_stopped;
+    std::thread             m_thread;
+};
+
+LogSink& LogSink::shared()
+{
+    // Never destroyed: threads and static destructors may log during exit.
+    // stopAtExit() joins the flusher and writes what is left.
+    static LogSink* sink = new LogSink();
+    return *sink;
+}
+
+LogSink::LogSink()
+    : m_out(stderr)
+    , m_stop(false)
+    , m_stopped(false)
+{
+    if (const char* path = std::getenv("NNDEMO_LOG_FILE")) {
+        if (std::FILE* file = std::fopen(path, "w")) {
+            m_out = file;
+        } else {
+            std::fprintf(stderr, "[Log] Cannot open %s, logging to stderr\n", path);
+        }
+    }
+    m_rings.reserve(16);
+    m_heads.reserve(16);
+    m_pending.reserve(LogRingRecords * 4);
+    m_buffer.reserve(64 * 1024);
+
+    m_thread = std::thread([this] { run(); });
+    std::atexit(stopAtExit);
+}
+
+LogRing* LogSink::registerRing()
+{
+    LogRing* ring = new LogRing();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rings.push_back(ring);
+    return ring;
+}
+
+void LogSink::wake()
+{
+    m_wake.notify_one();
+}
+
+void LogSink::flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    drain();
+}
+
+void LogSink::writeNow(const char* text)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    drain();
+    std::fputs(text, m_out);
+    std::fputc('\n', m_out);
+    std::fflush(m_out);
+}
+
+void LogSink::run()
+{
+    std::unique_lock<std::mutex> wakeLock(m_wakeMutex);
+    while (!m_stop) {
+        m_wake.wait_for(wakeLock, kFlushInterval);
+        wakeLock.unlock();
+        flush();
+        wakeLock.lock();
+    }
+}
+
+void LogSink::drain()
+{
+    m_pending.clear();
+    m_heads.resize(m_rings.size());
+    std::uint32_t dropped = 0;
+
+    for (std::size_t i = 0; i < m_rings.size(); ++i) {
+        LogRing& ring = *m_rings[i];
+        const std::uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        const std::uint32_t head = ring.head.load(std::memory_order_acquire);
+        m_heads[i] = head;
+        dropped += ring.dropped.exchange(0, std::memory_order_relaxed);
+        for (std::uint32_t slot = tail; slot != head; ++slot) {
+            m_pending.push_back(Pending{ring.records[slot % LogRingRecords].time,
+                                        static_cast<std::uint32_t>(i),
+                                        slot});
+        }
+    }
+
+    if (!m_pending.empty() || dropped > 0) {
+        // Rings are drained one after another; restore the order in which
+        // the messages were logged.
+        std::sort(m_pending.begin(), m_pending.end(), [](const Pending& a, const Pending& b) {
+            if (a.time != b.time) {
+                return a.time < b.time;
+            }
+            if (a.ring != b.ring) {
+                return a.ring < b.ring;
+            }
+            return static_cast<std::int32_t>(a.slot - b.slot) < 0;
+        });
+
+        m_buffer.clear();
+        for (const Pending& p : m_pending) {
+            m_buffer += m_rings[p.ring]->records[p.slot % LogRingRecords].text;
+            m_buffer += '\n';
+        }
+        if (dropped > 0) {
+            char note[96];
+            std::snprintf(note, sizeof(note), "[Log] %u messages dropped (ring full)\n", dropped);
+            m_buffer += note;
+        }
+        std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_out);
+        std::fflush(m_out);
+    }
+
+    // Release the slots, and free the rings of threads that have exited
+    // once everything they logged is written.
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < m_rings.size(); ++i) {
+        LogRing* ring = m_rings[i];
+        ring->tail.store(m_heads[i], std::memory_order_release);
+        if (ring->retired.load(std::memory_order_acquire) &&
+            ring->head.load(std::memory_order_acquire) == m_heads[i]) {
+            delete ring;
+        } else {
+            m_rings[kept++] = ring;
+        }
+    }
+    m_rings.resize(kept);
+}
+
+void LogSink::stopAtExit()
+{
+    LogSink& sink = shared();
+    {
+        std::lock_guard<std::mutex> lock(sink.m_wakeMutex);
+        sink.m_stop = true;
+    }
+    sink.m_wake.notify_one();
+    sink.m_thread.join();
+    sink.m_stopped.store(true, std::memory_order_release);
+    sink.flush();
+}
+
+// The calling thread's ring. t_ring is a plain pointer so it stays usable
+// after the thread's destructors have run (e.g. logging from a static
+// destructor on the main thread); t_ringOwner retires the ring on exit.
+thread_local LogRing* t_ring        = nullptr;
+thread_local bool     t_ringRetired = false;
+
+struct RingOwner {
+    LogRing* ring = nullptr;
+    ~RingOwner() {
+        if (ring) {
+            ring->retired.store(true, std::memory_order_release);
+            t_ring        = nullptr;
+            t_ringRetired = true;
+        }
+    }
+};
+
+thread_local RingOwner t_ringOwner;
+
+// Null once the thread has exited or logging has shut down; the caller
+// then writes synchronously.
+LogRing* threadRing()
+{
+    if (t_ring) {
+        return t_ring;
+    }
+    if (t_ringRetired) {
+        return nullptr;
+    }
+    // Once per thread.
+    NN_ALLOW_ALLOC();
+    LogSink& sink = LogSink::shared();
+    if (sink.stopped()) {
+        return nullptr;
+    }
+    t_ring = sink.registerRing();
+    t_ringOwner.ring = t_ring;
+    return t_ring;
+}
+
+#endif
+
+} // namespace
+
+bool logEnabled(LogLevel level)
+{
+    return level != LogLevel::Off &&
+           static_cast<int>(level) >= levelState().load(std::memory_order_relaxed);
+}
+
+void setLogLevel(LogLevel level)
+{
+    levelState().store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel logLevel()
+{
+    return static_cast<LogLevel>(levelState().load(std::memory_order_relaxed));
+}
+
+void logMessage(LogLevel level, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+#ifdef NN_LOG_SYNCHRONOUS
+    (void)level;
+    char text[LogMessageBytes];
+    formatMessage(text, format, args);
+    std::fprintf(stderr, "%s\n", text);
+#else
+    LogRing* ring = threadRing();
+    if (!ring || LogSink::shared().stopped()) {
+        char text[LogMessageBytes];
+        formatMessage(text, format, args);
+        LogSink::shared().writeNow(text);
+    } else {
+        const std::uint32_t head = ring->head.load(std::memory_order_relaxed);
+        const std::uint32_t used = head - ring->tail.load(std::memory_order_acquire);
+        if (used >= static_cast<std::uint32_t>(LogRingRecords)) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            LogRecord& record = ring->records[head % LogRingRecords];
+            record.time = Clock::now().time_since_epoch().count();
+            formatMessage(record.text, format, args);
+            ring->head.store(head + 1, std::memory_order_release);
+            // Errors go out right away; a filling ring is drained early.
+            if (level >= LogLevel::Error || used + 1 == static_cast<std::uint32_t>(LogRingRecords / 2)) {
+                LogSink::shared().wake();
+            }
+        }
+    }
+#endif
+
+    va_end(args);
+}
+
+void logFlush()
+{
+#ifndef NN_LOG_SYNCHRONOUS
+    LogSink::shared().flush();
+#endif
+}
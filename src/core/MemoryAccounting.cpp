@@ -0,0 +1,204 @@
+#include "MemoryAccounting.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+#include "Logger.h"
+
+namespace {
+
+struct TagInfo {
+    const char* name;
+    const char* key;
+};
+
+const TagInfo kTags[MemoryTagCount] = {
+    {"Datasets",        "datasets"},
+    {"Dataset cache",   "cache"},
+    {"Training data",   "training"},
+    {"Model",           "model"},
+    {"Optimizer state", "optimizer"},
+    {"Histories",       "histories"},
+    {"GPU buffers",     "gpu"},
+    {"Frame arena",     "arena"},
+};
+
+// "64M" -> 64 MiB. Returns false on anything else.
+bool parseBytes(const char* text, std::size_t length, std::size_t& out)
+{
+    if (length == 0 || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    std::size_t value = 0;
+    std::size_t i = 0;
+    while (i < length && std::isdigit(static_cast<unsigned char>(text[i]))) {
+        value = value * 10 + static_cast<std::size_t>(text[i] - '0');
+        ++i;
+    }
+    if (i < length) {
+        switch (std::toupper(static_cast<unsigned char>(text[i]))) {
+        case 'K': value <<= 10; break;
+        case 'M': value <<= 20; break;
+        case 'G': value <<= 30; break;
+        default: return false;
+        }
+        ++i;
+    }
+    out = value;
+    return i == length;
+}
+
+} // namespace
+
+MemoryRegistry::MemoryRegistry()
+{
+    for (int i = 0; i < MemoryTagCount; ++i) {
+        m_bytes[i].store(0, std::memory_order_relaxed);
+        m_accounts[i].store(0, std::memory_order_relaxed);
+        m_budgets[i].store(0, std::memory_order_relaxed);
+    }
+    loadBudgetsFromEnv();
+}
+
+MemoryRegistry& MemoryRegistry::shared()
+{
+    static MemoryRegistry registry;
+    return registry;
+}
+
+std::size_t MemoryRegistry::bytes(MemoryTag tag) const
+{
+    return m_bytes[static_cast<int>(tag)].load(std::memory_order_relaxed);
+}
+
+std::size_t MemoryRegistry::totalBytes() const
+{
+    std::size_t total = 0;
+    for (int i = 0; i < MemoryTagCount; ++i) {
+        total += m_bytes[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+int MemoryRegistry::accountCount(MemoryTag tag) const
+{
+    return m_accounts[static_cast<int>(tag)].load(std::memory_order_relaxed);
+}
+
+void MemoryRegistry::setBudget(MemoryTag tag, std::size_t bytes)
+{
+    m_budgets[static_cast<int>(tag)].store(bytes, std::memory_order_relaxed);
+}
+
+std::size_t MemoryRegistry::budget(MemoryTag tag) const
+{
+    return m_budgets[static_cast<int>(tag)].load(std::memory_order_relaxed);
+}
+
+bool MemoryRegistry::overBudget(MemoryTag tag) const
+{
+    const std::size_t limit = budget(tag);
+    return limit > 0 && bytes(tag) > limit;
+}
+
+void MemoryRegistry::dump(std::ostream& os) const
+{
+    os << "[Memory] " << std::left << std::setw(16) << "tag"
+       << std::right << std::setw(12) << "KB"
+       << std::setw(10) << "accounts"
+       << std::setw(12) << "budget KB" << "\n";
+    for (int i = 0; i < MemoryTagCount; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        os << "[Memory] " << std::left << std::setw(16) << tagName(tag)
+           << std::right << std::setw(12) << (bytes(tag) + 1023) / 1024
+           << std::setw(10) << accountCount(tag);
+        if (budget(tag) > 0) {
+            os << std::setw(12) << budget(tag) / 1024 << (overBudget(tag) ? "  OVER" : "");
+        } else {
+            os << std::setw(12) << "-";
+        }
+        os << "\n";
+    }
+    os << "[Memory] " << std::left << std::setw(16) << "total"
+       << std::right << std::setw(12) << (totalBytes() + 1023) / 1024 << "\n";
+}
+
+const char* MemoryRegistry::tagName(MemoryTag tag)
+{
+    const int i = static_cast<int>(tag);
+    return (i >= 0 && i < MemoryTagCount) ? kTags[i].name : "?";
+}
+
+const char* MemoryRegistry::tagKey(MemoryTag tag)
+{
+    const int i = static_cast<int>(tag);
+    return (i >= 0 && i < MemoryTagCount) ? kTags[i].key : "?";
+}
+
+void MemoryRegistry::loadBudgetsFromEnv()
+{
+    const char* env = std::getenv("NNDEMO_MEMORY_BUDGETS");
+    if (!env) {
+        return;
+    }
+
+    // Comma-separated key=size pairs.
+    const char* entry = env;
+    while (*entry) {
+        const char* end = std::strchr(entry, ',');
+        const std::size_t length = end ? static_cast<std::size_t>(end - entry) : std::strlen(entry);
+        const char* eq = static_cast<const char*>(std::memchr(entry, '=', length));
+
+        bool parsed = false;
+        if (eq) {
+            const std::size_t keyLength = static_cast<std::size_t>(eq - entry);
+            for (int i = 0; i < MemoryTagCount && !parsed; ++i) {
+                if (std::strlen(kTags[i].key) == keyLength &&
+                    std::strncmp(kTags[i].key, entry, keyLength) == 0) {
+                    std::size_t bytes = 0;
+                    if (parseBytes(eq + 1, length - keyLength - 1, bytes)) {
+                        setBudget(static_cast<MemoryTag>(i), bytes);
+                        parsed = true;
+                    }
+                }
+            }
+        }
+        if (!parsed) {
+            NN_LOG_WARN("[Memory] Ignoring budget entry '%.*s' in NNDEMO_MEMORY_BUDGETS",
+                        static_cast<int>(length), entry);
+        }
+
+        entry += length;
+        if (*entry == ',') {
+            ++entry;
+        }
+    }
+}
+
+MemoryAccount::MemoryAccount(MemoryTag tag)
+    : m_registry(MemoryRegistry::shared())
+    , m_tag(tag)
+    , m_bytes(0)
+{
+    m_registry.m_accounts[static_cast<int>(m_tag)].fetch_add(1, std::memory_order_relaxed);
+}
+
+MemoryAccount::~MemoryAccount()
+{
+    set(0);
+    m_registry.m_accounts[static_cast<int>(m_tag)].fetch_sub(1, std::memory_order_relaxed);
+}
+
+void MemoryAccount::set(std::size_t bytes)
+{
+    std::atomic<std::size_t>& total = m_registry.m_bytes[static_cast<int>(m_tag)];
+    if (bytes >= m_bytes) {
+        total.fetch_add(bytes - m_bytes, std::memory_order_relaxed);
+    } else {
+        total.fetch_sub(m_bytes - bytes, std::memory_order_relaxed);
+    }
+    m_bytes = bytes;
+}
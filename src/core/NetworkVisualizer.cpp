@@ -35,7 +35,8 @@ void NetworkVisualizer::draw(const ToyNet& net,
 {
     ImGui::Separator();
     ImGui::Text("Network Diagram");
-    ImGui::Text("Architecture: 2 -> %d -> %d -> 2", ToyNet::Hidden1, ToyNet::Hidden2);
+    const int inputDim = net.getInputDim();
+    ImGui::Text("Architecture: %d -> %d -> %d -> 2", inputDim, ToyNet::Hidden1, ToyNet::Hidden2);
 
     const ImVec2 canvasSize(m_canvasWidth, m_canvasHeight);
     ImVec2 canvasPos = ImGui::GetCursorScreenPos();
@@ -48,7 +49,7 @@ void NetworkVisualizer::draw(const ToyNet& net,
     ImGui::InvisibleButton("net_canvas", canvasSize);
 
     const int layerCount = 4;
-    int layerSizes[layerCount] = { ToyNet::InputDim, ToyNet::Hidden1, ToyNet::Hidden2, ToyNet::OutputDim };
+    int layerSizes[layerCount] = { inputDim, ToyNet::Hidden1, ToyNet::Hidden2, ToyNet::OutputDim };
 
     const float marginX = m_marginX;
     const float marginY = m_marginY;
@@ -96,6 +97,7 @@ void NetworkVisualizer::draw(const ToyNet& net,
         return 0.5f + 2.0f * t;
     };
 
+    float probeIn[ToyNet::MaxInputDim] = {};
     float probeA1[ToyNet::Hidden1] = {};
     float probeA2[ToyNet::Hidden2] = {};
     float probeP0 = 0.0f;
@@ -103,6 +105,7 @@ void NetworkVisualizer::draw(const ToyNet& net,
     bool  hasProbe = false;
     if (probeEnabled) {
         net.forwardSingleWithActivations(probeX, probeY, probeP0, probeP1, probeA1, probeA2);
+        expandFeatures(net.getFeatureSet(), probeX, probeY, probeIn);
         hasProbe = true;
     }
 
@@ -166,15 +169,15 @@ void NetworkVisualizer::draw(const ToyNet& net,
 
     for (int j = 0; j < ToyNet::Hidden1; ++j) {
         ImVec2 toPos = nodePos(1, j);
-        for (int i = 0; i < ToyNet::InputDim; ++i) {
+        for (int i = 0; i < inputDim; ++i) {
             ImVec2 fromPos = nodePos(0, i);
-            float w = W1[j * ToyNet::InputDim + i];
+            float w = W1[j * inputDim + i];
             float thickness = weightThickness(w);
             drawList->AddLine(fromPos, toPos, weightColor(w), thickness);
 
             float srcAct = 0.0f;
             if (hasProbe) {
-                srcAct = (i == 0) ? probeX : probeY;
+                srcAct = probeIn[i];
             }
             considerEdgeHover(fromPos, toPos, 0, i, 1, j, w, srcAct);
         }
@@ -260,8 +263,8 @@ void NetworkVisualizer::draw(const ToyNet& net,
 
             float activation = 0.0f;
             if (hasProbe) {
-                if (layer == 0) {
-                    activation = (i == 0) ? probeX : probeY;
+                if (layer == 0 && i < inputDim) {
+                    activation = probeIn[i];
                 } else if (layer == 1 && i < ToyNet::Hidden1) {
                     activation = probeA1[i];
                 } else if (layer == 2 && i < ToyNet::Hidden2) {
@@ -333,7 +336,9 @@ void NetworkVisualizer::draw(const ToyNet& net,
         ImGui::Text("%s neuron %d", layerName, hoverIndex);
         ImGui::Text("Bias: %.4f", hoverBias);
         if (hasProbe) {
-            if (hoverLayer == 0) {
+            if (hoverLayer == 0 && hoverIndex >= ToyNet::InputDim) {
+                ImGui::Text("Probe feature value: %.4f", hoverActivation);
+            } else if (hoverLayer == 0) {
                 ImGui::Text("Probe input: (x=%.3f, y=%.3f)", probeX, probeY);
             } else if (hoverLayer == 3 && hoverIndex < ToyNet::OutputDim) {
                 ImGui::Text("Probe probs: p0=%.3f, p1=%.3f", probeP0, probeP1);
@@ -356,7 +361,9 @@ void NetworkVisualizer::draw(const ToyNet& net,
 
         ImGui::BeginTooltip();
 
-        if (edgeFromLayer == 0) {
+        if (edgeFromLayer == 0 && edgeFromIndex >= ToyNet::InputDim) {
+            ImGui::Text("Weight: Input feature %d -> %s neuron %d", edgeFromIndex, toLayerName, edgeToIndex);
+        } else if (edgeFromLayer == 0) {
             const char* comp = (edgeFromIndex == 0) ? "x" : "y";
             ImGui::Text("Weight: Input %s -> %s neuron %d", comp, toLayerName, edgeToIndex);
         } else if (edgeToLayer == 3) {
@@ -377,7 +384,7 @@ void NetworkVisualizer::draw(const ToyNet& net,
     }
 
     ImGui::Separator();
-    ImGui::Text("Layers: Input (2) -> Hidden1 (4 ReLU) -> Hidden2 (8 ReLU) -> Output (2)");
+    ImGui::Text("Layers: Input (%d) -> Hidden1 (4 ReLU) -> Hidden2 (8 ReLU) -> Output (2)", inputDim);
     ImGui::Text("Legend:");
     ImGui::BulletText("Line color = sign of weight, thickness = |weight|");
     ImGui::BulletText("Halo = large bias magnitude");
@@ -0,0 +1,151 @@
+#include "PerfCounters.h"
+
+#include <algorithm>
+
+#include "AllocTracker.h"
+
+namespace {
+
+float percentile(const float* sorted, int count, float p)
+{
+    if (count <= 0) {
+        return 0.0f;
+    }
+    const int index = static_cast<int>(p * static_cast<float>(count - 1) + 0.5f);
+    return sorted[std::min(std::max(index, 0), count - 1)];
+}
+
+} // namespace
+
+PerfRegistry::PerfRegistry()
+    : m_next(0)
+    , m_count(0)
+    , m_lastDatasetMs(0.0f)
+    , m_started(false)
+    , m_allocations(0)
+    , m_allocBytes(0)
+    , m_frameStart(std::chrono::steady_clock::now())
+{
+    for (std::atomic<std::uint64_t>& c : m_counters) {
+        c.store(0, std::memory_order_relaxed);
+    }
+    std::fill(m_sectionMs, m_sectionMs + PerfSectionCount, 0.0);
+    std::fill(m_frameMs, m_frameMs + PerfHistoryFrames, 0.0f);
+}
+
+PerfRegistry& PerfRegistry::shared()
+{
+    static PerfRegistry registry;
+    return registry;
+}
+
+void PerfRegistry::addTime(PerfSection section, double ms)
+{
+    m_sectionMs[static_cast<int>(section)] += ms;
+}
+
+void PerfRegistry::endFrame()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const std::chrono::duration<double, std::milli> frame = now - m_frameStart;
+    m_frameStart = now;
+
+    const AllocCounts allocs = processAllocCounts();
+    add(PerfCounter::Allocations, allocs.allocations - m_allocations);
+    add(PerfCounter::AllocBytes, allocs.bytes - m_allocBytes);
+    m_allocations = allocs.allocations;
+    m_allocBytes  = allocs.bytes;
+
+    if (!m_started) {
+        // The first frame would also cover startup; only start the clock.
+        m_started = true;
+        std::fill(m_sectionMs, m_sectionMs + PerfSectionCount, 0.0);
+        for (std::atomic<std::uint64_t>& c : m_counters) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    m_frameMs[m_next] = static_cast<float>(frame.count());
+    for (int s = 0; s < PerfSectionCount; ++s) {
+        m_historySectionMs[m_next][s] = static_cast<float>(m_sectionMs[s]);
+        m_sectionMs[s] = 0.0;
+    }
+    for (int c = 0; c < PerfCounterCount; ++c) {
+        m_historyCounters[m_next][c] = m_counters[c].exchange(0, std::memory_order_relaxed);
+    }
+
+    const float datasetMs = m_historySectionMs[m_next][static_cast<int>(PerfSection::Dataset)];
+    if (datasetMs > 0.0f) {
+        m_lastDatasetMs = datasetMs;
+    }
+
+    m_next = (m_next + 1) % PerfHistoryFrames;
+    m_count = std::min(m_count + 1, PerfHistoryFrames);
+}
+
+void PerfRegistry::frameTimeHistogram(float* buckets, int bucketCount, float bucketMs) const
+{
+    std::fill(buckets, buckets + bucketCount, 0.0f);
+    if (bucketCount <= 0 || bucketMs <= 0.0f) {
+        return;
+    }
+    for (int i = 0; i < m_count; ++i) {
+        const int b = std::min(static_cast<int>(m_frameMs[i] / bucketMs), bucketCount - 1);
+        buckets[b] += 1.0f;
+    }
+}
+
+PerfSummary PerfRegistry::summarize() const
+{
+    PerfSummary s = {};
+    s.frames = m_count;
+    if (m_count == 0) {
+        return s;
+    }
+
+    float sorted[PerfHistoryFrames];
+    double totalMs = 0.0;
+    for (int i = 0; i < m_count; ++i) {
+        sorted[i] = m_frameMs[i];
+        totalMs += m_frameMs[i];
+        for (int c = 0; c < PerfCounterCount; ++c) {
+            s.perFrame[c] += static_cast<double>(m_historyCounters[i][c]);
+        }
+        for (int k = 0; k < PerfSectionCount; ++k) {
+            s.sectionMs[k] += m_historySectionMs[i][k];
+        }
+    }
+    std::sort(sorted, sorted + m_count);
+
+    s.seconds     = totalMs / 1000.0;
+    s.meanFrameMs = static_cast<float>(totalMs / m_count);
+    s.p50FrameMs  = percentile(sorted, m_count, 0.50f);
+    s.p95FrameMs  = percentile(sorted, m_count, 0.95f);
+    s.p99FrameMs  = percentile(sorted, m_count, 0.99f);
+    s.maxFrameMs  = sorted[m_count - 1];
+
+    const int last = (m_next + PerfHistoryFrames - 1) % PerfHistoryFrames;
+    for (int c = 0; c < PerfCounterCount; ++c) {
+        s.perSecond[c] = s.seconds > 0.0 ? s.perFrame[c] / s.seconds : 0.0;
+        s.perFrame[c] /= static_cast<double>(m_count);
+        s.lastFrame[c] = static_cast<double>(m_historyCounters[last][c]);
+    }
+    for (int k = 0; k < PerfSectionCount; ++k) {
+        s.sectionMs[k] /= static_cast<float>(m_count);
+    }
+    return s;
+}
+
+const char* PerfRegistry::sectionName(PerfSection section)
+{
+    switch (section) {
+    case PerfSection::Ui:          return "UI";
+    case PerfSection::Training:    return "Training";
+    case PerfSection::Dataset:     return "Dataset";
+    case PerfSection::FieldUpdate: return "Field update";
+    case PerfSection::Render:      return "Render";
+    case PerfSection::Present:     return "Present";
+    default:                       return "?";
+    }
+}
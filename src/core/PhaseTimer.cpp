@@ -0,0 +1,62 @@
+#include "PhaseTimer.h"
+
+#include <atomic>
+
+namespace {
+
+std::atomic<std::uint64_t> s_phaseNs[TrainPhaseCount];
+std::atomic<std::uint64_t> s_steps(0);
+
+} // namespace
+
+bool phaseTimingEnabled()
+{
+#ifdef NN_PHASE_TIMING
+    return true;
+#else
+    return false;
+#endif
+}
+
+TrainPhaseTimes trainPhaseTotals()
+{
+    TrainPhaseTimes t;
+    for (int i = 0; i < TrainPhaseCount; ++i) {
+        t.ns[i] = s_phaseNs[i].load(std::memory_order_relaxed);
+    }
+    t.steps = s_steps.load(std::memory_order_relaxed);
+    return t;
+}
+
+TrainPhaseTimes trainPhaseDelta(const TrainPhaseTimes& later, const TrainPhaseTimes& earlier)
+{
+    TrainPhaseTimes t;
+    for (int i = 0; i < TrainPhaseCount; ++i) {
+        t.ns[i] = later.ns[i] - earlier.ns[i];
+    }
+    t.steps = later.steps - earlier.steps;
+    return t;
+}
+
+void addTrainPhaseTime(TrainPhase phase, std::uint64_t ns)
+{
+    s_phaseNs[static_cast<int>(phase)].fetch_add(ns, std::memory_order_relaxed);
+}
+
+void countTrainPhaseStep()
+{
+    s_steps.fetch_add(1, std::memory_order_relaxed);
+}
+
+const char* trainPhaseName(TrainPhase phase)
+{
+    switch (phase) {
+    case TrainPhase::Input:     return "Input";
+    case TrainPhase::Forward:   return "Forward";
+    case TrainPhase::Loss:      return "Loss";
+    case TrainPhase::Backward:  return "Backward";
+    case TrainPhase::Reduce:    return "Reduce";
+    case TrainPhase::Optimizer: return "Optimizer";
+    default:                    return "?";
+    }
+}
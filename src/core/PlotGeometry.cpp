@@ -14,16 +14,55 @@
 #include <GLFW/glfw3.h>
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "GLDebug.h"
+#include "LinearArena.h"
+#include "PerfCounters.h"
+
+namespace {
+
+struct FloatVertex {
+    float x;
+    float y;
+    float label;
+};
+
+// Labels stay non-normalized, so the shader reads 0.0 / 1.0 either way.
+struct PackedVertex {
+    std::int16_t  x;
+    std::int16_t  y;
+    std::uint8_t  label;
+    std::uint8_t  pad[3];
+};
+
+static_assert(sizeof(FloatVertex) == 12, "unexpected FloatVertex size");
+static_assert(sizeof(PackedVertex) == 8, "unexpected PackedVertex size");
+
+std::int16_t toNormalizedShort(float v)
+{
+    const float scaled = std::round(v / PointPositionExtent * 32767.0f);
+    return static_cast<std::int16_t>(std::min(std::max(scaled, -32767.0f), 32767.0f));
+}
+
+} // namespace
+
 PointCloud::PointCloud()
     : m_vao(0)
     , m_vbo(0)
     , m_maxPoints(0)
+    , m_format(PointVertexFormat::Packed)
+    , m_gpuMemory(MemoryTag::GpuBuffers)
 {
 }
 
-void PointCloud::init(int maxPoints)
+void PointCloud::init(int maxPoints, PointVertexFormat format)
 {
     m_maxPoints = maxPoints;
+    m_format    = format;
 
     glGenVertexArrays(1, &m_vao);
     glGenBuffers(1, &m_vbo);
@@ -31,36 +70,75 @@ void PointCloud::init(int maxPoints)
     glBindVertexArray(m_vao);
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
-    const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(m_maxPoints * 3 * sizeof(float));
+    const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(m_maxPoints * vertexSize());
     glBufferData(GL_ARRAY_BUFFER, bufferSize, nullptr, GL_DYNAMIC_DRAW);
+    m_gpuMemory.set(static_cast<std::size_t>(bufferSize));
+    labelGLObject(GLObjectType::VertexArray, m_vao, "points VAO");
+    labelGLObject(GLObjectType::Buffer, m_vbo, "points VBO");
 
+    const GLsizei stride = static_cast<GLsizei>(vertexSize());
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 3 * sizeof(float), reinterpret_cast<void*>(0));
-
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 3 * sizeof(float), reinterpret_cast<void*>(2 * sizeof(float)));
+    if (m_format == PointVertexFormat::Packed) {
+        glVertexAttribPointer(0, 2, GL_SHORT, GL_TRUE, stride,
+                              reinterpret_cast<void*>(offsetof(PackedVertex, x)));
+        glVertexAttribPointer(1, 1, GL_UNSIGNED_BYTE, GL_FALSE, stride,
+                              reinterpret_cast<void*>(offsetof(PackedVertex, label)));
+    } else {
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<void*>(offsetof(FloatVertex, x)));
+        glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<void*>(offsetof(FloatVertex, label)));
+    }
 
     glBindVertexArray(0);
 }
 
+std::size_t PointCloud::vertexSize() const
+{
+    return m_format == PointVertexFormat::Packed ? sizeof(PackedVertex) : sizeof(FloatVertex);
+}
+
 void PointCloud::upload(const std::vector<DataPoint>& data)
 {
-    if (!m_vbo) {
+    uploadRange(data, 0, data.size());
+}
+
+void PointCloud::uploadRange(const std::vector<DataPoint>& data, std::size_t first, std::size_t count)
+{
+    // The buffer holds at most m_maxPoints points.
+    const std::size_t end = std::min(data.size(), static_cast<std::size_t>(m_maxPoints));
+    if (!m_vbo || first >= end) {
         return;
     }
-
-    std::vector<float> buffer;
-    buffer.reserve(data.size() * 3);
-    for (const auto& p : data) {
-        buffer.push_back(p.x);
-        buffer.push_back(p.y);
-        buffer.push_back(static_cast<float>(p.label));
+    count = std::min(count, end - first);
+
+    const std::size_t stride = vertexSize();
+    // Interleaved in the frame arena, so large uploads cost no malloc.
+    const std::size_t bytes = count * stride;
+    unsigned char* staging = frameArena().allocateArray<unsigned char>(bytes);
+    for (std::size_t i = 0; i < count; ++i) {
+        const DataPoint& p = data[first + i];
+        if (m_format == PointVertexFormat::Packed) {
+            PackedVertex v = {};
+            v.x     = toNormalizedShort(p.x);
+            v.y     = toNormalizedShort(p.y);
+            v.label = static_cast<std::uint8_t>(p.label);
+            std::memcpy(staging + i * stride, &v, sizeof(v));
+        } else {
+            const FloatVertex v = {p.x / PointPositionExtent,
+                                   p.y / PointPositionExtent,
+                                   static_cast<float>(p.label)};
+            std::memcpy(staging + i * stride, &v, sizeof(v));
+        }
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0,
-                    static_cast<GLsizeiptr>(buffer.size() * sizeof(float)),
-                    buffer.data());
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    static_cast<GLintptr>(first * stride),
+                    static_cast<GLsizeiptr>(bytes),
+                    staging);
+    PerfRegistry::shared().add(PerfCounter::UploadBytes, bytes);
 }
 
 void PointCloud::draw(std::size_t pointCount) const
@@ -86,6 +164,7 @@ void PointCloud::shutdown()
     }
 
     m_maxPoints = 0;
+    m_gpuMemory.set(0);
 }
 
 GridAxes::GridAxes()
@@ -95,6 +174,7 @@ GridAxes::GridAxes()
     , m_axisVBO(0)
     , m_gridVertexCount(0)
     , m_axisVertexCount(0)
+    , m_gpuMemory(MemoryTag::GpuBuffers)
 {
 }
 
@@ -137,6 +217,8 @@ void GridAxes::init(float gridStep)
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), reinterpret_cast<void*>(0));
     glBindVertexArray(0);
+    labelGLObject(GLObjectType::VertexArray, m_gridVAO, "grid VAO");
+    labelGLObject(GLObjectType::Buffer, m_gridVBO, "grid VBO");
 
     glGenVertexArrays(1, &m_axisVAO);
     glGenBuffers(1, &m_axisVBO);
@@ -150,6 +232,10 @@ void GridAxes::init(float gridStep)
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), reinterpret_cast<void*>(0));
     glBindVertexArray(0);
+    labelGLObject(GLObjectType::VertexArray, m_axisVAO, "axes VAO");
+    labelGLObject(GLObjectType::Buffer, m_axisVBO, "axes VBO");
+
+    m_gpuMemory.set((m_gridVertices.size() + m_axisVertices.size()) * sizeof(float));
 }
 
 void GridAxes::drawGrid() const
@@ -198,4 +284,5 @@ void GridAxes::shutdown()
     m_axisVertices.clear();
     m_gridVertexCount = 0;
     m_axisVertexCount = 0;
+    m_gpuMemory.set(0);
 }
@@ -0,0 +1,100 @@
+#include "PointGrid.h"
+
+#include <algorithm>
+
+namespace {
+
+const float kCellSize = 2.0f / static_cast<float>(PointGrid::CellsPerSide);
+
+} // namespace
+
+PointGrid::PointGrid()
+    : m_cells(static_cast<std::size_t>(CellsPerSide * CellsPerSide))
+{
+}
+
+int PointGrid::cellCoord(float v)
+{
+    const int c = static_cast<int>((v + 1.0f) / kCellSize);
+    return std::min(std::max(c, 0), CellsPerSide - 1);
+}
+
+int PointGrid::cellOf(float x, float y)
+{
+    return cellCoord(y) * CellsPerSide + cellCoord(x);
+}
+
+void PointGrid::build(const std::vector<DataPoint>& points)
+{
+    clear();
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        insert(static_cast<int>(i), points[i].x, points[i].y);
+    }
+}
+
+void PointGrid::clear()
+{
+    for (auto& cell : m_cells) {
+        cell.clear();
+    }
+}
+
+void PointGrid::insert(int index, float x, float y)
+{
+    m_cells[cellOf(x, y)].push_back(index);
+}
+
+void PointGrid::remove(int index, float x, float y)
+{
+    std::vector<int>& cell = m_cells[cellOf(x, y)];
+    const auto it = std::find(cell.begin(), cell.end(), index);
+    if (it != cell.end()) {
+        *it = cell.back();
+        cell.pop_back();
+    }
+}
+
+void PointGrid::removeSwap(int index, float x, float y, int lastIndex, float lastX, float lastY)
+{
+    remove(index, x, y);
+
+    if (lastIndex == index) {
+        return;
+    }
+    std::vector<int>& lastCell = m_cells[cellOf(lastX, lastY)];
+    std::replace(lastCell.begin(), lastCell.end(), lastIndex, index);
+}
+
+int PointGrid::nearest(const std::vector<DataPoint>& points, float x, float y, float radius) const
+{
+    const int x0 = cellCoord(x - radius);
+    const int x1 = cellCoord(x + radius);
+    const int y0 = cellCoord(y - radius);
+    const int y1 = cellCoord(y + radius);
+
+    int   bestIndex = -1;
+    float bestDist2 = radius * radius;
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            for (int i : m_cells[cy * CellsPerSide + cx]) {
+                const float dx = points[i].x - x;
+                const float dy = points[i].y - y;
+                const float d2 = dx * dx + dy * dy;
+                if (d2 < bestDist2 || (d2 == bestDist2 && bestIndex < 0)) {
+                    bestIndex = i;
+                    bestDist2 = d2;
+                }
+            }
+        }
+    }
+    return bestIndex;
+}
+
+std::size_t PointGrid::memoryBytes() const
+{
+    std::size_t bytes = m_cells.capacity() * sizeof(std::vector<int>);
+    for (const auto& cell : m_cells) {
+        bytes += cell.capacity() * sizeof(int);
+    }
+    return bytes;
+}
@@ -0,0 +1,162 @@
+#include "QuantizedPoints.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const float kLevels = 65535.0f;
+
+std::uint16_t quantize(float v, float minV, float step)
+{
+    const float q = std::round((v - minV) / step);
+    return static_cast<std::uint16_t>(std::min(std::max(q, 0.0f), kLevels));
+}
+
+} // namespace
+
+QuantizedPoints::QuantizedPoints()
+    : m_minX(0.0f)
+    , m_minY(0.0f)
+    , m_stepX(1.0f)
+    , m_stepY(1.0f)
+    , m_count(0)
+    , m_valid(false)
+{
+}
+
+void QuantizedPoints::build(const std::vector<DataPoint>& dataset)
+{
+    m_count = static_cast<int>(dataset.size());
+
+    float minX = 0.0f;
+    float maxX = 0.0f;
+    float minY = 0.0f;
+    float maxY = 0.0f;
+    if (!dataset.empty()) {
+        minX = maxX = dataset[0].x;
+        minY = maxY = dataset[0].y;
+        for (const DataPoint& p : dataset) {
+            minX = std::min(minX, p.x);
+            maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y);
+            maxY = std::max(maxY, p.y);
+        }
+    }
+    m_minX  = minX;
+    m_minY  = minY;
+    m_stepX = (maxX > minX) ? (maxX - minX) / kLevels : 1.0f;
+    m_stepY = (maxY > minY) ? (maxY - minY) / kLevels : 1.0f;
+
+    m_x.resize(static_cast<std::size_t>(m_count));
+    m_y.resize(static_cast<std::size_t>(m_count));
+    m_labels.assign(static_cast<std::size_t>((m_count + 63) / 64), 0);
+    for (int i = 0; i < m_count; ++i) {
+        m_x[i] = encodeX(dataset[i].x);
+        m_y[i] = encodeY(dataset[i].y);
+        setLabel(i, dataset[i].label);
+    }
+
+    m_valid = true;
+}
+
+void QuantizedPoints::invalidate()
+{
+    m_valid = false;
+    m_count = 0;
+}
+
+void QuantizedPoints::appendPoint(const DataPoint& p)
+{
+    if (!m_valid) {
+        return;
+    }
+
+    const float maxX = m_minX + m_stepX * kLevels;
+    const float maxY = m_minY + m_stepY * kLevels;
+    if (p.x < m_minX || p.x > maxX || p.y < m_minY || p.y > maxY) {
+        invalidate();
+        return;
+    }
+
+    m_x.push_back(encodeX(p.x));
+    m_y.push_back(encodeY(p.y));
+    if (m_count % 64 == 0) {
+        m_labels.push_back(0);
+    }
+    setLabel(m_count, p.label);
+    ++m_count;
+}
+
+void QuantizedPoints::removePointSwap(int index)
+{
+    if (!m_valid || index < 0 || index >= m_count) {
+        return;
+    }
+
+    const int last = m_count - 1;
+    const int lastLabel = static_cast<int>((m_labels[last / 64] >> (last % 64)) & 1u);
+    m_x[index] = m_x[last];
+    m_y[index] = m_y[last];
+    setLabel(index, lastLabel);
+    setLabel(last, 0);
+
+    m_x.pop_back();
+    m_y.pop_back();
+    --m_count;
+    m_labels.resize(static_cast<std::size_t>((m_count + 63) / 64));
+}
+
+bool QuantizedPoints::matches(int count) const
+{
+    return m_valid && m_count == count;
+}
+
+int QuantizedPoints::getCount() const
+{
+    return m_count;
+}
+
+void QuantizedPoints::gather(const int* indices, int count, float* xs, float* ys, int* labels) const
+{
+    const std::uint16_t* qx = m_x.data();
+    const std::uint16_t* qy = m_y.data();
+    const std::uint64_t* bits = m_labels.data();
+    const float minX  = m_minX;
+    const float minY  = m_minY;
+    const float stepX = m_stepX;
+    const float stepY = m_stepY;
+
+    for (int n = 0; n < count; ++n) {
+        const int i = indices[n];
+        xs[n]     = minX + stepX * static_cast<float>(qx[i]);
+        ys[n]     = minY + stepY * static_cast<float>(qy[i]);
+        labels[n] = static_cast<int>((bits[i >> 6] >> (i & 63)) & 1u);
+    }
+}
+
+std::size_t QuantizedPoints::memoryBytes() const
+{
+    return (m_x.capacity() + m_y.capacity()) * sizeof(std::uint16_t) +
+           m_labels.capacity() * sizeof(std::uint64_t);
+}
+
+std::uint16_t QuantizedPoints::encodeX(float x) const
+{
+    return quantize(x, m_minX, m_stepX);
+}
+
+std::uint16_t QuantizedPoints::encodeY(float y) const
+{
+    return quantize(y, m_minY, m_stepY);
+}
+
+void QuantizedPoints::setLabel(int index, int label)
+{
+    const std::uint64_t bit = std::uint64_t(1) << (index % 64);
+    if (label != 0) {
+        m_labels[index / 64] |= bit;
+    } else {
+        m_labels[index / 64] &= ~bit;
+    }
+}
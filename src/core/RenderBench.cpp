@@ -0,0 +1,308 @@
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+
+#define GLFW_INCLUDE_NONE
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "RenderBench.h"
+#include "GpuTimers.h"
+#include "Scene.h"
+
+namespace {
+
+// Frames per lap of the probe path.
+const int kProbePeriod = 240;
+
+struct FrameStats {
+    double meanMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    double maxMs;
+};
+
+void printUsage()
+{
+    std::printf("Usage: NeuralNetDemo [--bench-render [--frames N] [--warmup N] [--size WxH]\n"
+                "                     [--dataset N] [--points N] [--no-train] [--no-probe]\n"
+                "                     [--show] [--egl] [--json FILE]]\n");
+}
+
+bool parseInt(const char* text, int minValue, int& out)
+{
+    char* end = nullptr;
+    const long value = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < minValue || value > 1000000) {
+        return false;
+    }
+    out = static_cast<int>(value);
+    return true;
+}
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const std::size_t last = sorted.size() - 1;
+    const std::size_t index = static_cast<std::size_t>(p * static_cast<double>(last) + 0.5);
+    return sorted[std::min(index, last)];
+}
+
+FrameStats summarizeFrames(std::vector<double> frameMs)
+{
+    FrameStats s = {};
+    if (frameMs.empty()) {
+        return s;
+    }
+    std::sort(frameMs.begin(), frameMs.end());
+    double total = 0.0;
+    for (double ms : frameMs) {
+        total += ms;
+    }
+    s.meanMs = total / static_cast<double>(frameMs.size());
+    s.p50Ms  = percentile(frameMs, 0.50);
+    s.p95Ms  = percentile(frameMs, 0.95);
+    s.p99Ms  = percentile(frameMs, 0.99);
+    s.maxMs  = frameMs.back();
+    return s;
+}
+
+// Make the configured dataset active, as the dataset controls would.
+void setUpScene(const RenderBenchConfig& config, FrameContext& ctx)
+{
+    ctx.ui.datasetIndex = config.datasetIndex;
+    ctx.ui.numPoints    = std::min(config.numPoints, ctx.maxPoints);
+
+    DatasetKey key;
+    key.type      = static_cast<DatasetType>(ctx.ui.datasetIndex);
+    key.numPoints = ctx.ui.numPoints;
+    key.spread    = ctx.ui.spread;
+    key.seed      = ctx.ui.datasetSeed;
+    activateDataset(key, ctx.dataset, ctx.pointGrid, ctx.datasetCache, ctx.trainer);
+    ctx.pointCloud.upload(ctx.dataset);
+    ctx.fieldVis.setDirty();
+
+    // Train for the whole run, so the field shader gets fresh weights as
+    // uniforms every frame (its mesh was built once in init).
+    ctx.trainer.autoTrain         = config.autoTrain;
+    ctx.trainer.autoMaxEpochs     = 0;
+    ctx.trainer.useTargetLossStop = false;
+}
+
+// Sweep the probe along a figure eight and select the nearest point.
+void moveProbe(FrameContext& ctx, int frame)
+{
+    const float t = 6.2831853f * static_cast<float>(frame % kProbePeriod) / kProbePeriod;
+    const float x = 0.8f * std::cos(t);
+    const float y = 0.8f * std::sin(2.0f * t);
+
+    ctx.ui.probeEnabled = true;
+    ctx.ui.probeX       = x;
+    ctx.ui.probeY       = y;
+
+    const int index = ctx.pointGrid.nearest(ctx.dataset, x, y, 0.15f);
+    ctx.ui.hasSelectedPoint   = index >= 0;
+    ctx.ui.selectedPointIndex = index;
+    ctx.ui.selectedLabel      = index >= 0 ? ctx.dataset[index].label : -1;
+}
+
+bool writeJson(const RenderBenchConfig& config,
+               const char* renderer,
+               int points,
+               int frames,
+               const FrameStats& frameStats,
+               bool gpuTiming,
+               int trainSteps)
+{
+    std::FILE* out = std::fopen(config.jsonPath.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "[RenderBench] Cannot write %s\n", config.jsonPath.c_str());
+        return false;
+    }
+
+    std::fprintf(out,
+                 "{\n  \"renderer\": \"%s\",\n  \"width\": %d,\n  \"height\": %d,\n"
+                 "  \"dataset\": \"%s\",\n  \"points\": %d,\n  \"auto_train\": %s,\n"
+                 "  \"probe\": %s,\n  \"warmup_frames\": %d,\n  \"frames\": %d,\n  \"train_steps\": %d,\n",
+                 renderer,
+                 config.width,
+                 config.height,
+                 datasetTypeToString(static_cast<DatasetType>(config.datasetIndex)),
+                 points,
+                 config.autoTrain ? "true" : "false",
+                 config.moveProbe ? "true" : "false",
+                 config.warmupFrames,
+                 frames,
+                 trainSteps);
+    std::fprintf(out,
+                 "  \"frame_ms\": {\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f},\n",
+                 frameStats.meanMs, frameStats.p50Ms, frameStats.p95Ms, frameStats.p99Ms, frameStats.maxMs);
+
+    std::fprintf(out, "  \"gpu_ms\": {");
+    if (gpuTiming) {
+        const GpuPassTimers& gpu = GpuPassTimers::shared();
+        for (int p = 0; p < GpuPassCount; ++p) {
+            const GpuPassStats& s = gpu.stats(static_cast<GpuPass>(p));
+            std::fprintf(out, "%s\n    \"%s\": {\"mean\": %.4f, \"max\": %.4f, \"frames\": %d}",
+                         p > 0 ? "," : "",
+                         GpuPassTimers::passName(static_cast<GpuPass>(p)),
+                         s.frames > 0 ? s.totalMs / s.frames : 0.0,
+                         s.maxMs,
+                         s.frames);
+        }
+        std::fprintf(out, "\n  ");
+    }
+    std::fprintf(out, "}\n}\n");
+    std::fclose(out);
+    return true;
+}
+
+} // namespace
+
+bool parseRenderBenchArgs(int argc, char** argv, RenderBenchConfig& config)
+{
+    bool benchOption = false;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool ok = true;
+
+        if (std::strcmp(arg, "--bench-render") == 0) {
+            config.enabled = true;
+            continue;
+        }
+        benchOption = true;
+        if (std::strcmp(arg, "--no-train") == 0) {
+            config.autoTrain = false;
+        } else if (std::strcmp(arg, "--no-probe") == 0) {
+            config.moveProbe = false;
+        } else if (std::strcmp(arg, "--show") == 0) {
+            config.showWindow = true;
+        } else if (std::strcmp(arg, "--egl") == 0) {
+            config.egl = true;
+        } else if (!value) {
+            ok = false;
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            ok = parseInt(value, 1, config.frames);
+            ++i;
+        } else if (std::strcmp(arg, "--warmup") == 0) {
+            ok = parseInt(value, 0, config.warmupFrames);
+            ++i;
+        } else if (std::strcmp(arg, "--dataset") == 0) {
+            ok = parseInt(value, 0, config.datasetIndex) && config.datasetIndex < DatasetTypeCount;
+            ++i;
+        } else if (std::strcmp(arg, "--points") == 0) {
+            ok = parseInt(value, 10, config.numPoints);
+            ++i;
+        } else if (std::strcmp(arg, "--size") == 0) {
+            ok = std::sscanf(value, "%dx%d", &config.width, &config.height) == 2 &&
+                 config.width >= 64 && config.height >= 64;
+            ++i;
+        } else if (std::strcmp(arg, "--json") == 0) {
+            config.jsonPath = value;
+            ++i;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::fprintf(stderr, "Bad option: %s\n", arg);
+            printUsage();
+            return false;
+        }
+    }
+    if (benchOption && !config.enabled) {
+        printUsage();
+        return false;
+    }
+    return true;
+}
+
+int runRenderBench(const RenderBenchConfig& config, FrameContext& ctx)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    setUpScene(config, ctx);
+
+    const GLubyte* rendererName = glGetString(GL_RENDERER);
+    const char* renderer = rendererName ? reinterpret_cast<const char*>(rendererName) : "unknown";
+
+    GpuPassTimers& gpu = GpuPassTimers::shared();
+    const bool gpuTiming = gpu.init();
+
+    std::vector<double> frameMs;
+    frameMs.reserve(static_cast<std::size_t>(config.frames));
+    int trainStepsAtStart = ctx.trainer.epochCount;
+
+    const int totalFrames = config.warmupFrames + config.frames;
+    for (int frame = 0; frame < totalFrames && !glfwWindowShouldClose(ctx.window); ++frame) {
+        if (frame == config.warmupFrames) {
+            gpu.finish();
+            gpu.resetStats();
+            trainStepsAtStart = ctx.trainer.epochCount;
+        }
+        if (config.moveProbe) {
+            moveProbe(ctx, frame);
+        }
+
+        const Clock::time_point start = Clock::now();
+        updateAndRenderFrame(ctx);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (frame >= config.warmupFrames) {
+            frameMs.push_back(ms);
+        }
+    }
+    gpu.finish();
+
+    const int frames = static_cast<int>(frameMs.size());
+    const int trainSteps = ctx.trainer.epochCount - trainStepsAtStart;
+    const FrameStats stats = summarizeFrames(frameMs);
+
+    std::printf("[RenderBench] %s, %dx%d, %s with %d points, auto-train %s, probe %s\n",
+                renderer,
+                config.width,
+                config.height,
+                datasetTypeToString(static_cast<DatasetType>(config.datasetIndex)),
+                ctx.ui.numPoints,
+                config.autoTrain ? "on" : "off",
+                config.moveProbe ? "on" : "off");
+    std::printf("[RenderBench] %d frames after %d warm-up, %d train steps\n",
+                frames, config.warmupFrames, trainSteps);
+    std::printf("[RenderBench] frame ms: mean %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f (%.0f fps)\n",
+                stats.meanMs, stats.p50Ms, stats.p95Ms, stats.p99Ms, stats.maxMs,
+                stats.meanMs > 0.0 ? 1000.0 / stats.meanMs : 0.0);
+    if (gpuTiming) {
+        std::printf("[RenderBench] %-16s %10s %10s %8s\n", "GPU pass", "mean ms", "max ms", "frames");
+        for (int p = 0; p < GpuPassCount; ++p) {
+            const GpuPassStats& s = gpu.stats(static_cast<GpuPass>(p));
+            std::printf("[RenderBench] %-16s %10.4f %10.4f %8d\n",
+                        GpuPassTimers::passName(static_cast<GpuPass>(p)),
+                        s.frames > 0 ? s.totalMs / s.frames : 0.0,
+                        s.maxMs,
+                        s.frames);
+        }
+    } else {
+        std::printf("[RenderBench] GPU timer queries not available\n");
+    }
+
+    bool ok = frames == config.frames;
+    if (!ok) {
+        std::fprintf(stderr, "[RenderBench] Window closed after %d of %d frames\n", frames, config.frames);
+    }
+    if (!config.jsonPath.empty()) {
+        ok &= writeJson(config, renderer, ctx.ui.numPoints, frames, stats, gpuTiming, trainSteps);
+    }
+    gpu.shutdown();
+    return ok ? 0 : 1;
+}
@@ -11,6 +11,8 @@
 #include <GLFW/glfw3.h>
 #endif
 
+#include <algorithm>
+#include <cstdio>
 #include <vector>
 
 #include "imgui.h"
@@ -19,24 +21,33 @@
 
 #include "Scene.h"
 #include "ShaderProgram.h"
+#include "GLDebug.h"
+#include "GpuTimers.h"
 #include "GLUtils.h"
+#include "PerfCounters.h"
+#include "AllocTracker.h"
+#include "LinearArena.h"
+#include "MemoryAccounting.h"
 
 void initSceneCommon(DatasetType currentDataset,
                      UiState& ui,
                      int& maxPoints,
                      std::vector<DataPoint>& dataset,
                      PointCloud& pointCloud,
+                     PointGrid& pointGrid,
+                     DatasetCache& datasetCache,
                      GridAxes& gridAxes,
                      FieldVisualizer& fieldVis,
                      bool& leftMousePressedLastFrame) {
     dataset.clear();
 
     maxPoints = 5000;
-    pointCloud.init(maxPoints);
+    pointCloud.init(maxPoints, PointVertexFormat::Packed);
 
     ui.datasetIndex       = static_cast<int>(currentDataset);
     ui.numPoints          = 1000;
     ui.spread             = 0.25f;
+    ui.datasetSeed        = 1;
     ui.pointSize          = 8.0f;
     ui.probeEnabled       = true;
     ui.probeX             = 0.0f;
@@ -44,8 +55,20 @@ void initSceneCommon(DatasetType currentDataset,
     ui.hasSelectedPoint   = false;
     ui.selectedPointIndex = -1;
     ui.selectedLabel      = -1;
-
-    generateDataset(currentDataset, ui.numPoints, ui.spread, dataset);
+    ui.editPoints         = false;
+    ui.editLabel          = 0;
+    std::snprintf(ui.liveSegmentName, sizeof(ui.liveSegmentName), "%s", "/nndemo_live");
+
+    DatasetKey key;
+    key.type      = currentDataset;
+    key.numPoints = ui.numPoints;
+    key.spread    = ui.spread;
+    key.seed      = ui.datasetSeed;
+    FeatureColumns columns;
+    if (!datasetCache.switchTo(key, dataset, pointGrid, columns)) {
+        generateDataset(currentDataset, ui.numPoints, ui.spread, dataset, ui.datasetSeed);
+        pointGrid.build(dataset);
+    }
     pointCloud.upload(dataset);
 
     const float gridStep = 0.25f;
@@ -57,7 +80,201 @@ void initSceneCommon(DatasetType currentDataset,
     leftMousePressedLastFrame = false;
 }
 
+void activateDataset(const DatasetKey& key,
+                     std::vector<DataPoint>& dataset,
+                     PointGrid& pointGrid,
+                     DatasetCache& datasetCache,
+                     Trainer& trainer) {
+    // The outgoing feature columns are parked along with their points.
+    FeatureColumns columns;
+    trainer.swapFeatureColumns(columns);
+
+    if (!datasetCache.switchTo(key, dataset, pointGrid, columns)) {
+        generateDataset(key.type, key.numPoints, key.spread, dataset, key.seed);
+        pointGrid.build(dataset);
+    }
+
+    trainer.resetForNewDataset();
+    // Restored columns (or an empty cache on a miss, built on first use).
+    trainer.swapFeatureColumns(columns);
+}
+
+void queryFieldUniformLocations(const ShaderProgram& fieldShader,
+                                int& fieldW1Location,
+                                int& fieldB1Location,
+                                int& fieldW2Location,
+                                int& fieldB2Location,
+                                int& fieldW3Location,
+                                int& fieldB3Location) {
+    fieldW1Location = glGetUniformLocation(fieldShader.getId(), "u_W1");
+    fieldB1Location = glGetUniformLocation(fieldShader.getId(), "u_b1");
+    fieldW2Location = glGetUniformLocation(fieldShader.getId(), "u_W2");
+    fieldB2Location = glGetUniformLocation(fieldShader.getId(), "u_b2");
+    fieldW3Location = glGetUniformLocation(fieldShader.getId(), "u_W3");
+    fieldB3Location = glGetUniformLocation(fieldShader.getId(), "u_b3");
+}
+
+// Regenerate the field shader so its input expansion and u_W1 size match
+// the network's current feature set.
+static void rebuildFieldShader(FrameContext& ctx) {
+    const FeatureSet set = ctx.trainer.net.getFeatureSet();
+    const std::string fragmentSrc =
+        buildFieldFragmentSource(ctx.fieldSources.fragmentTemplate, set);
+
+    ctx.fieldShader = ShaderProgram(ctx.fieldSources.vertexSrc.c_str(), fragmentSrc.c_str());
+    queryFieldUniformLocations(ctx.fieldShader,
+                               ctx.fieldW1Location,
+                               ctx.fieldB1Location,
+                               ctx.fieldW2Location,
+                               ctx.fieldB2Location,
+                               ctx.fieldW3Location,
+                               ctx.fieldB3Location);
+    ctx.fieldSources.featureSet = set;
+    labelGLObject(GLObjectType::Program, ctx.fieldShader.getId(), "field program");
+
+    check_gl_error("After field shader rebuild");
+}
+
+// Apply a click edit to the dataset and everything derived from it without
+// rebuilding: one vertex is re-uploaded, the picking grid and the trainer's
+// feature cache are patched, and training continues from the current weights.
+static void applyPointEdit(FrameContext& ctx, const PointEdit& edit) {
+    // Edits are user actions, not steady-state work.
+    NN_ALLOW_ALLOC();
+    std::vector<DataPoint>& dataset = ctx.dataset;
+
+    if (edit.kind == PointEdit::Add) {
+        if (static_cast<int>(dataset.size()) >= ctx.maxPoints) {
+            return;
+        }
+        const std::size_t index = dataset.size();
+        dataset.push_back(DataPoint{edit.x, edit.y, edit.label});
+        ctx.pointGrid.insert(static_cast<int>(index), edit.x, edit.y);
+        ctx.pointCloud.uploadRange(dataset, index, 1);
+        ctx.trainer.pointAppended(dataset);
+    } else if (edit.kind == PointEdit::Remove) {
+        const int index = edit.index;
+        const int last  = static_cast<int>(dataset.size()) - 1;
+        if (index < 0 || index > last) {
+            return;
+        }
+        // Move the last point into the freed slot so only one vertex changes.
+        const DataPoint removed = dataset[index];
+        const DataPoint moved   = dataset[last];
+        dataset[index] = moved;
+        dataset.pop_back();
+        ctx.pointGrid.removeSwap(index, removed.x, removed.y, last, moved.x, moved.y);
+        if (index < last) {
+            ctx.pointCloud.uploadRange(dataset, static_cast<std::size_t>(index), 1);
+        }
+        ctx.trainer.pointRemoved(dataset, index);
+
+        if (ctx.ui.hasSelectedPoint) {
+            if (ctx.ui.selectedPointIndex == index) {
+                ctx.ui.hasSelectedPoint   = false;
+                ctx.ui.selectedPointIndex = -1;
+                ctx.ui.selectedLabel      = -1;
+            } else if (ctx.ui.selectedPointIndex == last) {
+                ctx.ui.selectedPointIndex = index;
+            }
+        }
+    } else {
+        return;
+    }
+
+    // The points no longer match their generation parameters.
+    ctx.datasetCache.markActiveEdited();
+    ctx.fieldVis.setDirty();
+}
+
+// Mirror the streaming reservoir into the displayed dataset. Only the
+// slots the trainer wrote since the last frame are copied, re-uploaded and
+// moved in the picking grid; a full rebuild happens only when the stream
+// restarts.
+static void syncStreamReservoir(FrameContext& ctx) {
+    Trainer& trainer = ctx.trainer;
+    const std::vector<DataPoint>& reservoir = trainer.streamReservoir();
+    std::vector<DataPoint>& dataset = ctx.dataset;
+
+    if (trainer.reservoirWasReset() || dataset.size() > reservoir.size()) {
+        // Stream settings changed, a user action.
+        NN_ALLOW_ALLOC();
+        dataset.reserve(static_cast<std::size_t>(ctx.maxPoints));
+        dataset = reservoir;
+        ctx.pointCloud.upload(dataset);
+        ctx.pointGrid.build(dataset);
+        trainer.clearReservoirChanges();
+        return;
+    }
+
+    const std::vector<int>& slots = trainer.reservoirChangedSlots();
+    std::size_t runBegin = 0;
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        const int slot = slots[i];
+        const DataPoint& p = reservoir[static_cast<std::size_t>(slot)];
+        if (static_cast<std::size_t>(slot) < dataset.size()) {
+            const DataPoint old = dataset[slot];
+            ctx.pointGrid.remove(slot, old.x, old.y);
+            dataset[slot] = p;
+        } else {
+            // Appended slots arrive in order, into the capacity reserved
+            // when the stream was reset.
+            dataset.push_back(p);
+        }
+        {
+            // A cell list only allocates when it outgrows its largest size
+            // so far, which stops happening once the reservoir is full.
+            NN_ALLOW_ALLOC();
+            ctx.pointGrid.insert(slot, p.x, p.y);
+        }
+
+        // Upload runs of consecutive slots (the appends while the reservoir
+        // fills) with one call.
+        if (i + 1 == slots.size() || slots[i + 1] != slot + 1) {
+            ctx.pointCloud.uploadRange(dataset,
+                                       static_cast<std::size_t>(slots[runBegin]),
+                                       i + 1 - runBegin);
+            runBegin = i + 1;
+        }
+    }
+    trainer.clearReservoirChanges();
+}
+
+// Publish the sizes that are not tracked by their owners.
+static void reportMemoryUsage(FrameContext& ctx) {
+    static MemoryAccount datasetMemory(MemoryTag::Datasets);
+    static MemoryAccount arenaMemory(MemoryTag::FrameArena);
+
+    datasetMemory.set(ctx.dataset.capacity() * sizeof(DataPoint) + ctx.pointGrid.memoryBytes());
+    arenaMemory.set(frameArena().capacity());
+    ctx.trainer.reportMemory();
+}
+
+// Apply the budgets that have a way to give memory back: the dataset cache
+// evicts, the histories are decimated. Other tags are only flagged.
+static void enforceMemoryBudgets(FrameContext& ctx) {
+    MemoryRegistry& memory = MemoryRegistry::shared();
+
+    const std::size_t cacheBudget = memory.budget(MemoryTag::DatasetCache);
+    if (cacheBudget > 0 && cacheBudget != ctx.datasetCache.budget()) {
+        ctx.datasetCache.setBudget(cacheBudget);
+    }
+
+    if (memory.overBudget(MemoryTag::Histories)) {
+        // Loss and accuracy, one float each per point.
+        const std::size_t points = memory.budget(MemoryTag::Histories) / (2 * sizeof(float));
+        if (points < static_cast<std::size_t>(ctx.trainer.historyLimit())) {
+            NN_ALLOW_ALLOC();
+            ctx.trainer.setHistoryLimit(static_cast<int>(points));
+            ctx.trainer.reportMemory();
+        }
+    }
+}
+
 void updateAndRenderFrame(FrameContext& ctx) {
+    NN_ASSERT_NO_ALLOC("updateAndRenderFrame");
+    PerfLapTimer perf;
+
 #ifdef NNDEMO_ENABLE_IMGUI
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
@@ -71,13 +288,15 @@ void updateAndRenderFrame(FrameContext& ctx) {
 
     bool regenerate = false;
     bool stepTrainRequested = false;
+    bool evaluateRequested = false;
 
 #ifdef NNDEMO_ENABLE_IMGUI
     drawControlPanel(ctx.ui,
                      ctx.trainer,
                      ctx.dataset.size(),
                      regenerate,
-                     stepTrainRequested);
+                     stepTrainRequested,
+                     evaluateRequested);
 #endif
 
     bool wantCaptureMouse = false;
@@ -85,28 +304,76 @@ void updateAndRenderFrame(FrameContext& ctx) {
     wantCaptureMouse = io.WantCaptureMouse;
 #endif
 
-    handleProbeSelection(ctx.window,
-                         ctx.dataset,
-                         ctx.ui,
-                         ctx.leftMousePressedLastFrame,
-                         wantCaptureMouse);
+    if (ctx.ui.editPoints && !ctx.trainer.streaming) {
+        const PointEdit edit = handlePointEditing(ctx.window,
+                                                  ctx.dataset,
+                                                  ctx.pointGrid,
+                                                  ctx.ui,
+                                                  ctx.leftMousePressedLastFrame,
+                                                  wantCaptureMouse);
+        applyPointEdit(ctx, edit);
+    } else {
+        handleProbeSelection(ctx.window,
+                             ctx.dataset,
+                             ctx.pointGrid,
+                             ctx.ui,
+                             ctx.leftMousePressedLastFrame,
+                             wantCaptureMouse);
+    }
+
+    // When mirroring a live run, show the same points the trainer uses;
+    // they are regenerated from the published seed.
+    if (ctx.trainer.isLiveAttached()) {
+        const LiveDatasetInfo& live = ctx.trainer.liveSnapshot().dataset;
+        const int livePoints = std::min(live.numPoints, ctx.maxPoints);
+        if (live.numPoints > 0 &&
+            (live.datasetIndex != ctx.ui.datasetIndex ||
+             livePoints != ctx.ui.numPoints ||
+             live.spread != ctx.ui.spread ||
+             live.seed != ctx.ui.datasetSeed)) {
+            ctx.ui.datasetIndex = live.datasetIndex;
+            ctx.ui.numPoints    = livePoints;
+            ctx.ui.spread       = live.spread;
+            ctx.ui.datasetSeed  = live.seed;
+            regenerate = true;
+        }
+    }
+
+    perf.lap(PerfSection::Ui);
 
     if (regenerate) {
+        NN_ALLOW_ALLOC();
         if (ctx.ui.numPoints < 10) ctx.ui.numPoints = 10;
         if (ctx.ui.numPoints > ctx.maxPoints) ctx.ui.numPoints = ctx.maxPoints;
-        DatasetType currentDataset = static_cast<DatasetType>(ctx.ui.datasetIndex);
-        generateDataset(currentDataset,
-                        ctx.ui.numPoints,
-                        ctx.ui.spread,
-                        ctx.dataset);
+        if (ctx.trainer.streaming) {
+            // No stored dataset; the reservoir fills in as training runs.
+            FeatureColumns columns;
+            ctx.trainer.swapFeatureColumns(columns);
+            ctx.datasetCache.park(ctx.dataset, ctx.pointGrid, columns);
+            ctx.trainer.resetForNewDataset();
+        } else {
+            DatasetKey key;
+            key.type      = static_cast<DatasetType>(ctx.ui.datasetIndex);
+            key.numPoints = ctx.ui.numPoints;
+            key.spread    = ctx.ui.spread;
+            key.seed      = ctx.ui.datasetSeed;
+            activateDataset(key, ctx.dataset, ctx.pointGrid, ctx.datasetCache, ctx.trainer);
+        }
         ctx.pointCloud.upload(ctx.dataset);
 
         ctx.ui.hasSelectedPoint   = false;
         ctx.ui.selectedPointIndex = -1;
         ctx.ui.selectedLabel      = -1;
 
-        ctx.trainer.resetForNewDataset();
         ctx.fieldVis.setDirty();
+        perf.lap(PerfSection::Dataset);
+    }
+
+    if (ctx.trainer.streaming) {
+        ctx.trainer.setStreamSource(static_cast<DatasetType>(ctx.ui.datasetIndex),
+                                    ctx.ui.spread,
+                                    ctx.ui.datasetSeed,
+                                    ctx.ui.numPoints);
     }
 
     if (stepTrainRequested) {
@@ -114,74 +381,115 @@ void updateAndRenderFrame(FrameContext& ctx) {
         ctx.fieldVis.setDirty();
     }
 
-    if (ctx.trainer.autoTrain) {
-        if (ctx.trainer.autoTrainEpochs(ctx.dataset)) {
-            ctx.fieldVis.setDirty();
-        }
+    if (evaluateRequested) {
+        ctx.trainer.evaluateFullDataset(ctx.dataset);
+    }
+
+    // Called every frame (not only while autoTrain is set) so the trainer
+    // can wind down background workers when auto-train is switched off.
+    if (ctx.trainer.autoTrainEpochs(ctx.dataset)) {
+        ctx.fieldVis.setDirty();
+    }
+
+    if (ctx.trainer.streaming) {
+        syncStreamReservoir(ctx);
     }
+    perf.lap(PerfSection::Training);
 
     if (ctx.fieldVis.isDirty()) {
         ctx.fieldVis.update();
     }
+    perf.lap(PerfSection::FieldUpdate);
+
+    if (ctx.fieldSources.featureSet != ctx.trainer.net.getFeatureSet()) {
+        NN_ALLOW_ALLOC();
+        rebuildFieldShader(ctx);
+    }
 
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
-    ctx.fieldShader.use();
-    const auto& W1 = ctx.trainer.net.getW1();
-    const auto& B1 = ctx.trainer.net.getB1();
-    const auto& W2 = ctx.trainer.net.getW2();
-    const auto& B2 = ctx.trainer.net.getB2();
-    const auto& W3 = ctx.trainer.net.getW3();
-    const auto& B3 = ctx.trainer.net.getB3();
-
-    ctx.fieldShader.setFloatArray(ctx.fieldW1Location, W1.data(), static_cast<int>(W1.size()));
-    ctx.fieldShader.setFloatArray(ctx.fieldB1Location, B1.data(), static_cast<int>(B1.size()));
-    ctx.fieldShader.setFloatArray(ctx.fieldW2Location, W2.data(), static_cast<int>(W2.size()));
-    ctx.fieldShader.setFloatArray(ctx.fieldB2Location, B2.data(), static_cast<int>(B2.size()));
-    ctx.fieldShader.setFloatArray(ctx.fieldW3Location, W3.data(), static_cast<int>(W3.size()));
-    ctx.fieldShader.setFloatArray(ctx.fieldB3Location, B3.data(), static_cast<int>(B3.size()));
-    ctx.fieldVis.draw();
-
-    ctx.gridShader.use();
-    if (ctx.gridColorLocation != -1) {
-        ctx.gridShader.setVec3(ctx.gridColorLocation, 0.15f, 0.15f, 0.15f);
+    {
+        GLDebugGroup group("Decision field");
+        GpuPassScope gpuPass(GpuPass::Field);
+        ctx.fieldShader.use();
+        const auto& W1 = ctx.trainer.net.getW1();
+        const auto& B1 = ctx.trainer.net.getB1();
+        const auto& W2 = ctx.trainer.net.getW2();
+        const auto& B2 = ctx.trainer.net.getB2();
+        const auto& W3 = ctx.trainer.net.getW3();
+        const auto& B3 = ctx.trainer.net.getB3();
+
+        ctx.fieldShader.setFloatArray(ctx.fieldW1Location, W1.data(), static_cast<int>(W1.size()));
+        ctx.fieldShader.setFloatArray(ctx.fieldB1Location, B1.data(), static_cast<int>(B1.size()));
+        ctx.fieldShader.setFloatArray(ctx.fieldW2Location, W2.data(), static_cast<int>(W2.size()));
+        ctx.fieldShader.setFloatArray(ctx.fieldB2Location, B2.data(), static_cast<int>(B2.size()));
+        ctx.fieldShader.setFloatArray(ctx.fieldW3Location, W3.data(), static_cast<int>(W3.size()));
+        ctx.fieldShader.setFloatArray(ctx.fieldB3Location, B3.data(), static_cast<int>(B3.size()));
+        ctx.fieldVis.draw();
     }
-    ctx.gridAxes.drawGrid();
 
-    if (ctx.gridColorLocation != -1) {
-        ctx.gridShader.setVec3(ctx.gridColorLocation, 0.8f, 0.8f, 0.8f);
+    {
+        GLDebugGroup group("Grid and axes");
+        GpuPassScope gpuPass(GpuPass::GridAxes);
+        ctx.gridShader.use();
+        if (ctx.gridColorLocation != -1) {
+            ctx.gridShader.setVec3(ctx.gridColorLocation, 0.15f, 0.15f, 0.15f);
+        }
+        ctx.gridAxes.drawGrid();
+
+        if (ctx.gridColorLocation != -1) {
+            ctx.gridShader.setVec3(ctx.gridColorLocation, 0.8f, 0.8f, 0.8f);
+        }
+        ctx.gridAxes.drawAxes();
     }
-    ctx.gridAxes.drawAxes();
 
-    ctx.pointShader.use();
+    {
+        GLDebugGroup group("Points");
+        GpuPassScope gpuPass(GpuPass::Points);
+        ctx.pointShader.use();
 
-    if (ctx.pointSizeLocation != -1) {
-        ctx.pointShader.setFloat(ctx.pointSizeLocation, 8.0f);
-    }
-    if (ctx.colorClass0Location != -1) {
-        ctx.pointShader.setVec3(ctx.colorClass0Location, 0.2f, 0.6f, 1.0f);
-    }
-    if (ctx.colorClass1Location != -1) {
-        ctx.pointShader.setVec3(ctx.colorClass1Location, 1.0f, 0.5f, 0.2f);
-    }
-    if (ctx.selectedIndexLocation != -1) {
-        int selIndex = -1;
-        if (ctx.ui.hasSelectedPoint &&
-            ctx.ui.selectedPointIndex >= 0 &&
-            ctx.ui.selectedPointIndex < static_cast<int>(ctx.dataset.size())) {
-            selIndex = ctx.ui.selectedPointIndex;
+        if (ctx.pointSizeLocation != -1) {
+            ctx.pointShader.setFloat(ctx.pointSizeLocation, 8.0f);
+        }
+        if (ctx.colorClass0Location != -1) {
+            ctx.pointShader.setVec3(ctx.colorClass0Location, 0.2f, 0.6f, 1.0f);
+        }
+        if (ctx.colorClass1Location != -1) {
+            ctx.pointShader.setVec3(ctx.colorClass1Location, 1.0f, 0.5f, 0.2f);
+        }
+        if (ctx.selectedIndexLocation != -1) {
+            int selIndex = -1;
+            if (ctx.ui.hasSelectedPoint &&
+                ctx.ui.selectedPointIndex >= 0 &&
+                ctx.ui.selectedPointIndex < static_cast<int>(ctx.dataset.size())) {
+                selIndex = ctx.ui.selectedPointIndex;
+            }
+            ctx.pointShader.setInt(ctx.selectedIndexLocation, selIndex);
         }
-        ctx.pointShader.setInt(ctx.selectedIndexLocation, selIndex);
-    }
 
-    ctx.pointCloud.draw(ctx.dataset.size());
+        ctx.pointCloud.draw(ctx.dataset.size());
+    }
+    perf.lap(PerfSection::Render);
 
 #ifdef NNDEMO_ENABLE_IMGUI
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    {
+        GLDebugGroup group("ImGui");
+        GpuPassScope gpuPass(GpuPass::ImGui);
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
 #endif
+    perf.lap(PerfSection::Ui);
 
     glfwSwapBuffers(ctx.window);
     glfwPollEvents();
+    perf.lap(PerfSection::Present);
+
+    // Transient upload/staging buffers of this frame are done with.
+    frameArena().reset();
+    reportMemoryUsage(ctx);
+    enforceMemoryBudgets(ctx);
+    PerfRegistry::shared().endFrame();
+    GpuPassTimers::shared().endFrame();
 }
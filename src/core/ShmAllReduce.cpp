@@ -0,0 +1,255 @@
+#include "ShmAllReduce.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+struct ShmAllReduce::Header {
+    std::uint32_t              magic;
+    std::int32_t               ranks;
+    std::int32_t               count;
+    std::atomic<std::uint32_t> arrived;
+    std::atomic<std::uint32_t> generation; // futex word
+    std::atomic<std::uint32_t> aborted;
+};
+
+namespace {
+
+const std::uint32_t kMagic = 0x4E4E4152u; // "NNAR"
+
+// Header and each slot start on their own cache line.
+const std::size_t kHeaderBytes = 64;
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "futex word must be a plain 32-bit integer");
+
+#if defined(__linux__)
+void futexWait(std::atomic<std::uint32_t>* word, std::uint32_t expected)
+{
+    // Short timeout so waiters re-check the abort flag even if a wakeup is
+    // lost because the waking process died.
+    timespec timeout;
+    timeout.tv_sec  = 0;
+    timeout.tv_nsec = 50 * 1000 * 1000;
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(word), FUTEX_WAIT,
+            expected, &timeout, nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<std::uint32_t>* word)
+{
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(word), FUTEX_WAKE,
+            INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+int roundUpTo16(int n)
+{
+    return (n + 15) & ~15;
+}
+
+} // namespace
+
+ShmAllReduce::ShmAllReduce()
+    : m_header(nullptr)
+    , m_slots(nullptr)
+    , m_results(nullptr)
+    , m_ranks(0)
+    , m_count(0)
+    , m_stride(0)
+    , m_rank(0)
+    , m_calls(0)
+    , m_mappedSize(0)
+    , m_owner(false)
+    , m_ownerPid(0)
+{
+}
+
+ShmAllReduce::~ShmAllReduce()
+{
+    destroy();
+}
+
+bool ShmAllReduce::create(const std::string& name, int ranks, int count)
+{
+#if defined(__linux__)
+    destroy();
+    if (ranks < 1 || count < 1) {
+        return false;
+    }
+
+    m_ranks  = ranks;
+    m_count  = count;
+    m_stride = roundUpTo16(count);
+    m_mappedSize = kHeaderBytes +
+                   static_cast<std::size_t>(ranks + 2) * static_cast<std::size_t>(m_stride) * sizeof(float);
+
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "shm_open failed for " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(m_mappedSize)) != 0) {
+        std::cerr << "ftruncate failed for " << name << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void* base = mmap(nullptr, m_mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "mmap failed for " << name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    m_header = new (base) Header();
+    m_header->magic = kMagic;
+    m_header->ranks = ranks;
+    m_header->count = count;
+    m_header->arrived.store(0, std::memory_order_relaxed);
+    m_header->generation.store(0, std::memory_order_relaxed);
+    m_header->aborted.store(0, std::memory_order_relaxed);
+
+    m_slots    = reinterpret_cast<float*>(static_cast<char*>(base) + kHeaderBytes);
+    m_results  = m_slots + static_cast<std::size_t>(ranks) * m_stride;
+    m_name     = name;
+    m_owner    = true;
+    m_ownerPid = static_cast<int>(getpid());
+    m_calls    = 0;
+    return true;
+#else
+    (void)name;
+    (void)ranks;
+    (void)count;
+    std::cerr << "Shared-memory all-reduce is only supported on Linux" << std::endl;
+    return false;
+#endif
+}
+
+void ShmAllReduce::destroy()
+{
+#if defined(__linux__)
+    if (!m_header) {
+        return;
+    }
+    munmap(m_header, m_mappedSize);
+    // Forked children inherit m_owner; only the creating process unlinks.
+    if (m_owner && m_ownerPid == static_cast<int>(getpid())) {
+        shm_unlink(m_name.c_str());
+    }
+#endif
+    m_header  = nullptr;
+    m_slots   = nullptr;
+    m_results = nullptr;
+    m_owner   = false;
+}
+
+void ShmAllReduce::setRank(int rank)
+{
+    m_rank = rank;
+}
+
+int ShmAllReduce::getRank() const
+{
+    return m_rank;
+}
+
+int ShmAllReduce::getRanks() const
+{
+    return m_ranks;
+}
+
+bool ShmAllReduce::barrier()
+{
+#if defined(__linux__)
+    Header& h = *m_header;
+    const std::uint32_t gen = h.generation.load(std::memory_order_acquire);
+
+    if (h.arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == static_cast<std::uint32_t>(m_ranks)) {
+        // Last to arrive: reset for the next round and release everyone.
+        h.arrived.store(0, std::memory_order_relaxed);
+        h.generation.fetch_add(1, std::memory_order_acq_rel);
+        futexWakeAll(&h.generation);
+    } else {
+        while (h.generation.load(std::memory_order_acquire) == gen) {
+            if (h.aborted.load(std::memory_order_acquire)) {
+                return false;
+            }
+            futexWait(&h.generation, gen);
+        }
+    }
+    return h.aborted.load(std::memory_order_acquire) == 0;
+#else
+    return false;
+#endif
+}
+
+bool ShmAllReduce::allReduceSum(float* data)
+{
+    if (!m_header) {
+        return false;
+    }
+
+    // Phase 1: publish this rank's contribution.
+    std::memcpy(m_slots + static_cast<std::size_t>(m_rank) * m_stride, data,
+                static_cast<std::size_t>(m_count) * sizeof(float));
+    if (!barrier()) {
+        return false;
+    }
+
+    // Phase 2 (reduce-scatter): sum this rank's chunk across all slots.
+    // Results alternate between two buffers, so a fast rank starting the
+    // next call never overwrites a result a slow rank is still reading.
+    float* result = m_results + static_cast<std::size_t>(m_calls & 1u) * m_stride;
+    const int chunk = (m_count + m_ranks - 1) / m_ranks;
+    const int begin = std::min(m_count, m_rank * chunk);
+    const int end   = std::min(m_count, begin + chunk);
+    for (int i = begin; i < end; ++i) {
+        float sum = 0.0f;
+        for (int r = 0; r < m_ranks; ++r) {
+            sum += m_slots[static_cast<std::size_t>(r) * m_stride + i];
+        }
+        result[i] = sum;
+    }
+    ++m_calls;
+    if (!barrier()) {
+        return false;
+    }
+
+    // Phase 3 (all-gather): every rank reads the complete result.
+    std::memcpy(data, result, static_cast<std::size_t>(m_count) * sizeof(float));
+    return true;
+}
+
+void ShmAllReduce::abort()
+{
+#if defined(__linux__)
+    if (!m_header) {
+        return;
+    }
+    m_header->aborted.store(1, std::memory_order_release);
+    m_header->generation.fetch_add(1, std::memory_order_acq_rel);
+    futexWakeAll(&m_header->generation);
+#endif
+}
+
+bool ShmAllReduce::isAborted() const
+{
+    return m_header && m_header->aborted.load(std::memory_order_acquire) != 0;
+}
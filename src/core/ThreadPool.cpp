@@ -0,0 +1,264 @@
+#include "ThreadPool.h"
+
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Identifies which pool (if any) the current thread works for, so nested
+// submissions go to the worker's own deque.
+thread_local const ThreadPool* t_pool        = nullptr;
+thread_local int               t_workerIndex = -1;
+
+int defaultWorkerCount()
+{
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    // WebAssembly builds without pthread support cannot spawn threads.
+    return 0;
+#else
+    if (const char* env = std::getenv("NNDEMO_THREADS")) {
+        int n = std::atoi(env);
+        return n < 0 ? 0 : n;
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 1 ? static_cast<int>(hw) - 1 : 0;
+#endif
+}
+
+bool defaultPinThreads()
+{
+    const char* env = std::getenv("NNDEMO_PIN_THREADS");
+    return env && env[0] == '1';
+}
+
+void pinToCore(std::thread& thread, int core)
+{
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+    const unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<unsigned>(core) % hw, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(int workerCount, bool pinThreads)
+    : m_queued(0)
+    , m_nextQueue(0)
+    , m_stop(false)
+{
+    if (workerCount < 0) {
+        workerCount = 0;
+    }
+
+    m_workers.reserve(static_cast<std::size_t>(workerCount));
+    for (int i = 0; i < workerCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+
+    // Start threads only after every deque exists, since workers steal
+    // from each other immediately.
+    for (int i = 0; i < workerCount; ++i) {
+        m_workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+        if (pinThreads) {
+            // Leave core 0 for the render/main thread.
+            pinToCore(m_workers[i]->thread, i + 1);
+        }
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_sleepCv.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool(defaultWorkerCount(), defaultPinThreads());
+    return pool;
+}
+
+int ThreadPool::workerCount() const
+{
+    return static_cast<int>(m_workers.size());
+}
+
+int ThreadPool::concurrency() const
+{
+    return workerCount() + 1;
+}
+
+int ThreadPool::currentWorkerIndex() const
+{
+    return (t_pool == this) ? t_workerIndex : -1;
+}
+
+void ThreadPool::submit(Task task, TaskGroup* group)
+{
+    const int self = currentWorkerIndex();
+    const int queueCount = workerCount();
+    const int target = (self >= 0)
+        ? self
+        : static_cast<int>(m_nextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<unsigned>(queueCount));
+
+    {
+        Worker& worker = *m_workers[target];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(TaskItem{std::move(task), group});
+    }
+
+    {
+        // Publish under the sleep mutex so a worker that just found
+        // nothing to do cannot miss this wakeup.
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_queued.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_sleepCv.notify_one();
+}
+
+bool ThreadPool::popTask(int selfIndex, TaskItem& out)
+{
+    const int queueCount = workerCount();
+
+    // Own deque first, newest task (LIFO keeps the working set warm).
+    if (selfIndex >= 0) {
+        Worker& own = *m_workers[selfIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Steal the oldest task from someone else.
+    const int start = (selfIndex >= 0) ? selfIndex + 1 : 0;
+    for (int k = 0; k < queueCount; ++k) {
+        const int victim = (start + k) % queueCount;
+        if (victim == selfIndex) {
+            continue;
+        }
+        Worker& other = *m_workers[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            out = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::popGroupTask(int selfIndex, TaskGroup* group, TaskItem& out)
+{
+    const int queueCount = workerCount();
+    for (int k = 0; k < queueCount; ++k) {
+        // Own deque first, as in popTask().
+        const int index = (selfIndex >= 0) ? (selfIndex + k) % queueCount : k;
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        for (auto it = worker.tasks.begin(); it != worker.tasks.end(); ++it) {
+            if (it->group == group) {
+                out = std::move(*it);
+                worker.tasks.erase(it);
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTask(TaskItem& item)
+{
+    item.fn();
+    if (item.group) {
+        item.group->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+bool ThreadPool::tryRunOne(TaskGroup* group)
+{
+    TaskItem item;
+    if (!popGroupTask(currentWorkerIndex(), group, item)) {
+        return false;
+    }
+    runTask(item);
+    return true;
+}
+
+void ThreadPool::workerLoop(int index)
+{
+    t_pool        = this;
+    t_workerIndex = index;
+
+    for (;;) {
+        TaskItem item;
+        if (popTask(index, item)) {
+            runTask(item);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCv.wait(lock, [this] {
+            return m_stop || m_queued.load(std::memory_order_relaxed) > 0;
+        });
+        if (m_stop) {
+            return;
+        }
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : m_pool(pool)
+    , m_pending(0)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    wait();
+}
+
+void TaskGroup::run(ThreadPool::Task task)
+{
+    if (m_pool.workerCount() == 0) {
+        task();
+        return;
+    }
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    m_pool.submit(std::move(task), this);
+}
+
+void TaskGroup::wait()
+{
+    while (m_pending.load(std::memory_order_acquire) > 0) {
+        if (!m_pool.tryRunOne(this)) {
+            std::this_thread::yield();
+        }
+    }
+}
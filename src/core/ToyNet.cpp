@@ -5,8 +5,15 @@
 #include <cstdlib>
 #include <limits>
 
+#include "PhaseTimer.h"
+#include "ThreadPool.h"
+
 namespace {
 
+// Samples per parallel chunk in trainBatch. Below two chunks the batch is
+// processed on the calling thread, since task overhead would dominate.
+const int kParallelGrain = 64;
+
 inline int idx(int row, int col, int cols) {
     return row * cols + col;
 }
@@ -18,22 +25,32 @@ inline float relu(float x) {
 }
 
 ToyNet::ToyNet()
+    : ToyNet(ThreadPool::shared()) {
+}
+
+ToyNet::ToyNet(ThreadPool& pool)
     : m_initMode(InitMode::HeUniform)
     , m_learningRate(0.1f)
+    , m_featureSet(FeatureSet::Raw)
+    , m_inputDim(featureDim(FeatureSet::Raw))
     , m_optimizerType(OptimizerType::SGD)
     , m_momentum(0.9f)
     , m_adamBeta1(0.9f)
     , m_adamBeta2(0.999f)
     , m_adamEps(1e-8f)
-    , m_adamStep(0) {
-    m_W1.resize(Hidden1 * InputDim);
+    , m_adamStep(0)
+    , m_parallelTraining(true)
+    , m_deterministic(false)
+    , m_pool(&pool) {
+    m_W1.resize(Hidden1 * m_inputDim);
     m_b1.resize(Hidden1);
     m_W2.resize(Hidden2 * Hidden1);
     m_b2.resize(Hidden2);
     m_W3.resize(OutputDim * Hidden2);
     m_b3.resize(OutputDim);
 
-    m_a0.resize(MaxBatch * InputDim);
+    m_a0.resize(MaxBatch * MaxInputDim);
+    m_labels.resize(MaxBatch);
     m_z1.resize(MaxBatch * Hidden1);
     m_a1.resize(MaxBatch * Hidden1);
     m_z2.resize(MaxBatch * Hidden2);
@@ -48,6 +65,15 @@ ToyNet::ToyNet()
     m_dW3.resize(m_W3.size());
     m_db3.resize(m_b3.size());
 
+    m_gradSlots.resize(static_cast<std::size_t>(m_pool->concurrency()));
+    for (auto& slot : m_gradSlots) {
+        resizeSlot(slot);
+    }
+    m_blockSlots.resize(MaxBatch / DeterministicBlock);
+    for (auto& slot : m_blockSlots) {
+        resizeSlot(slot);
+    }
+
     m_mW1.resize(m_W1.size());
     m_mb1.resize(m_b1.size());
     m_mW2.resize(m_W2.size());
@@ -86,7 +112,7 @@ void ToyNet::resetParameters(unsigned int seed) {
         return r * std::cos(theta);
     };
 
-    const float fanIn1 = static_cast<float>(InputDim);
+    const float fanIn1 = static_cast<float>(m_inputDim);
     const float fanIn2 = static_cast<float>(Hidden1);
     const float fanIn3 = static_cast<float>(Hidden2);
 
@@ -133,19 +159,61 @@ float ToyNet::trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy
         return 0.0f;
     }
     const int batchSize = std::min(N, MaxBatch);
+    TrainPhaseTimer phases;
 
-    // Copy inputs into a0 (the input activations for the batch)
+    // Expand inputs into a0 (the input activations for the batch)
     for (int n = 0; n < batchSize; ++n) {
-        m_a0[idx(n, 0, InputDim)] = batch[n].x;
-        m_a0[idx(n, 1, InputDim)] = batch[n].y;
+        expandFeatures(m_featureSet, batch[n].x, batch[n].y, &m_a0[idx(n, 0, m_inputDim)]);
+        m_labels[n] = batch[n].label;
     }
+    phases.lap(TrainPhase::Input);
+
+    return trainFromInputs(batchSize, outAccuracy);
+}
+
+float ToyNet::trainBatchFeatures(const float* features,
+                                 const int* labels,
+                                 int count,
+                                 float& outAccuracy) {
+    if (count <= 0 || !features || !labels) {
+        outAccuracy = 0.0f;
+        return 0.0f;
+    }
+    const int batchSize = std::min(count, MaxBatch);
+    TrainPhaseTimer phases;
+
+    std::copy(features, features + batchSize * m_inputDim, m_a0.begin());
+    std::copy(labels, labels + batchSize, m_labels.begin());
+    phases.lap(TrainPhase::Input);
+
+    return trainFromInputs(batchSize, outAccuracy);
+}
+
+float ToyNet::computeGradients(const std::vector<DataPoint>& batch, float& outAccuracy) {
+    const int N = static_cast<int>(batch.size());
+    if (N <= 0) {
+        outAccuracy = 0.0f;
+        return 0.0f;
+    }
+    const int batchSize = std::min(N, MaxBatch);
 
-    // Forward pass: layer 1 (ReLU(Input * W1 + b1))
     for (int n = 0; n < batchSize; ++n) {
+        expandFeatures(m_featureSet, batch[n].x, batch[n].y, &m_a0[idx(n, 0, m_inputDim)]);
+        m_labels[n] = batch[n].label;
+    }
+
+    return gradientsFromInputs(batchSize, outAccuracy);
+}
+
+void ToyNet::forwardBackwardRange(int begin, int end, GradientSlot& g) {
+    TrainPhaseTimer phases;
+
+    // Forward pass: layer 1 (ReLU(Input * W1 + b1))
+    for (int n = begin; n < end; ++n) {
         for (int j = 0; j < Hidden1; ++j) {
             float sum = m_b1[j];
-            for (int i = 0; i < InputDim; ++i) {
-                sum += m_W1[idx(j, i, InputDim)] * m_a0[idx(n, i, InputDim)];
+            for (int i = 0; i < m_inputDim; ++i) {
+                sum += m_W1[idx(j, i, m_inputDim)] * m_a0[idx(n, i, m_inputDim)];
             }
             const int zIndex = idx(n, j, Hidden1);
             m_z1[zIndex] = sum;
@@ -154,7 +222,7 @@ float ToyNet::trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy
     }
 
     // Forward pass: layer 2 (ReLU(a1 * W2 + b2))
-    for (int n = 0; n < batchSize; ++n) {
+    for (int n = begin; n < end; ++n) {
         for (int j = 0; j < Hidden2; ++j) {
             float sum = m_b2[j];
             for (int i = 0; i < Hidden1; ++i) {
@@ -166,21 +234,24 @@ float ToyNet::trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy
         }
     }
 
-    // Forward pass: output layer (logits + softmax)
-    float lossSum   = 0.0f;
-    int   correct   = 0;
-
-    for (int n = 0; n < batchSize; ++n) {
-        // logits: z3 = a2 * W3 + b3
-        float maxLogit = -std::numeric_limits<float>::infinity();
+    // Forward pass: output layer logits (z3 = a2 * W3 + b3)
+    for (int n = begin; n < end; ++n) {
         for (int k = 0; k < OutputDim; ++k) {
             float sum = m_b3[k];
             for (int j = 0; j < Hidden2; ++j) {
                 sum += m_W3[idx(k, j, Hidden2)] * m_a2[idx(n, j, Hidden2)];
             }
-            const int lIndex = idx(n, k, OutputDim);
-            m_logits[lIndex] = sum;
-            if (sum > maxLogit) maxLogit = sum;
+            m_logits[idx(n, k, OutputDim)] = sum;
+        }
+    }
+    phases.lap(TrainPhase::Forward);
+
+    // Softmax and cross-entropy loss
+    for (int n = begin; n < end; ++n) {
+        float maxLogit = -std::numeric_limits<float>::infinity();
+        for (int k = 0; k < OutputDim; ++k) {
+            const float z = m_logits[idx(n, k, OutputDim)];
+            if (z > maxLogit) maxLogit = z;
         }
 
         // softmax: p_k = exp(z3_k) / sum_j exp(z3_j)
@@ -192,7 +263,7 @@ float ToyNet::trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy
             expSum += e;
         }
 
-        int   label      = batch[n].label;
+        int   label      = m_labels[n];
         int   predicted  = 0;
         float bestProb   = -1.0f;
         float correctProb = 0.0f;
@@ -209,30 +280,19 @@ float ToyNet::trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy
         }
 
         if (predicted == label) {
-            ++correct;
+            ++g.correct;
         }
 
         const float eps = 1e-6f;
-        lossSum += -std::log(std::max(correctProb, eps));
+        g.lossSum += -std::log(std::max(correctProb, eps));
     }
-
-    const float invN = 1.0f / static_cast<float>(batchSize);
-    float loss = lossSum * invN;
-    outAccuracy = static_cast<float>(correct) * invN;
-
-    // Zero gradients
-    std::fill(m_dW1.begin(), m_dW1.end(), 0.0f);
-    std::fill(m_db1.begin(), m_db1.end(), 0.0f);
-    std::fill(m_dW2.begin(), m_dW2.end(), 0.0f);
-    std::fill(m_db2.begin(), m_db2.end(), 0.0f);
-    std::fill(m_dW3.begin(), m_dW3.end(), 0.0f);
-    std::fill(m_db3.begin(), m_db3.end(), 0.0f);
+    phases.lap(TrainPhase::Loss);
 
     // Backward pass
     // We use cross-entropy loss with softmax, so dL/dz3 = (p - y).
     // For ReLU, dL/dz = dL/da * 1(z > 0).
-    for (int n = 0; n < batchSize; ++n) {
-        int label = batch[n].label;
+    for (int n = begin; n < end; ++n) {
+        int label = m_labels[n];
 
         // delta3_k = dL/dz3_k = p_k - y_k
         float delta3[OutputDim] = {0.0f, 0.0f};
@@ -252,10 +312,10 @@ float ToyNet::trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy
         // delta2Raw_j = sum_k delta3_k * W3_{k,j}.
         for (int k = 0; k < OutputDim; ++k) {
             for (int j = 0; j < Hidden2; ++j) {
-                m_dW3[idx(k, j, Hidden2)] += delta3[k] * m_a2[idx(n, j, Hidden2)];
+                g.dW3[idx(k, j, Hidden2)] += delta3[k] * m_a2[idx(n, j, Hidden2)];
                 delta2Raw[j] += delta3[k] * m_W3[idx(k, j, Hidden2)];
             }
-            m_db3[k] += delta3[k];
+            g.db3[k] += delta3[k];
         }
 
         // Apply ReLU derivative at layer 2: delta2_j = delta2Raw_j * 1(z2_j > 0).
@@ -275,10 +335,10 @@ float ToyNet::trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy
         // delta1Raw_i = sum_j delta2_j * W2_{j,i}.
         for (int j = 0; j < Hidden2; ++j) {
             for (int i = 0; i < Hidden1; ++i) {
-                m_dW2[idx(j, i, Hidden1)] += delta2[j] * m_a1[idx(n, i, Hidden1)];
+                g.dW2[idx(j, i, Hidden1)] += delta2[j] * m_a1[idx(n, i, Hidden1)];
                 delta1Raw[i] += delta2[j] * m_W2[idx(j, i, Hidden1)];
             }
-            m_db2[j] += delta2[j];
+            g.db2[j] += delta2[j];
         }
 
         // Apply ReLU derivative at layer 1: delta1_i = delta1Raw_i * 1(z1_i > 0).
@@ -291,20 +351,23 @@ float ToyNet::trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy
         // Gradients for W1, b1.
         // dL/dW1_{i,d} += delta1_i * a0_d.
         for (int i = 0; i < Hidden1; ++i) {
-            for (int d = 0; d < InputDim; ++d) {
-                m_dW1[idx(i, d, InputDim)] += delta1[i] * m_a0[idx(n, d, InputDim)];
+            for (int d = 0; d < m_inputDim; ++d) {
+                g.dW1[idx(i, d, m_inputDim)] += delta1[i] * m_a0[idx(n, d, m_inputDim)];
             }
-            m_db1[i] += delta1[i];
+            g.db1[i] += delta1[i];
         }
     }
+    phases.lap(TrainPhase::Backward);
+}
 
-    // Average gradients over batch
-    for (auto& g : m_dW1) g *= invN;
-    for (auto& g : m_db1) g *= invN;
-    for (auto& g : m_dW2) g *= invN;
-    for (auto& g : m_db2) g *= invN;
-    for (auto& g : m_dW3) g *= invN;
-    for (auto& g : m_db3) g *= invN;
+float ToyNet::trainFromInputs(int batchSize, float& outAccuracy) {
+    const float loss = gradientsFromInputs(batchSize, outAccuracy);
+    applyOptimizerStep();
+    return loss;
+}
+
+void ToyNet::applyOptimizerStep() {
+    TrainPhaseTimer phases;
 
     OptimizerConfig cfg;
     cfg.type         = m_optimizerType;
@@ -328,6 +391,146 @@ float ToyNet::trainBatch(const std::vector<DataPoint>& batch, float& outAccuracy
                          m_vW2, m_vb2,
                          m_vW3, m_vb3,
                          m_adamStep);
+    phases.lap(TrainPhase::Optimizer);
+    phases.countStep();
+}
+
+void ToyNet::resizeSlot(GradientSlot& slot) const {
+    slot.dW1.resize(m_W1.size());
+    slot.db1.resize(m_b1.size());
+    slot.dW2.resize(m_W2.size());
+    slot.db2.resize(m_b2.size());
+    slot.dW3.resize(m_W3.size());
+    slot.db3.resize(m_b3.size());
+}
+
+void ToyNet::zeroSlot(GradientSlot& slot) {
+    std::fill(slot.dW1.begin(), slot.dW1.end(), 0.0f);
+    std::fill(slot.db1.begin(), slot.db1.end(), 0.0f);
+    std::fill(slot.dW2.begin(), slot.dW2.end(), 0.0f);
+    std::fill(slot.db2.begin(), slot.db2.end(), 0.0f);
+    std::fill(slot.dW3.begin(), slot.dW3.end(), 0.0f);
+    std::fill(slot.db3.begin(), slot.db3.end(), 0.0f);
+    slot.lossSum = 0.0f;
+    slot.correct = 0;
+}
+
+void ToyNet::addSlot(GradientSlot& dst, const GradientSlot& src) {
+    for (std::size_t i = 0; i < dst.dW1.size(); ++i) dst.dW1[i] += src.dW1[i];
+    for (std::size_t i = 0; i < dst.db1.size(); ++i) dst.db1[i] += src.db1[i];
+    for (std::size_t i = 0; i < dst.dW2.size(); ++i) dst.dW2[i] += src.dW2[i];
+    for (std::size_t i = 0; i < dst.db2.size(); ++i) dst.db2[i] += src.db2[i];
+    for (std::size_t i = 0; i < dst.dW3.size(); ++i) dst.dW3[i] += src.dW3[i];
+    for (std::size_t i = 0; i < dst.db3.size(); ++i) dst.db3[i] += src.db3[i];
+    dst.lossSum += src.lossSum;
+    dst.correct += src.correct;
+}
+
+const ToyNet::GradientSlot& ToyNet::accumulateFast(int batchSize) {
+    ThreadPool& pool = *m_pool;
+
+    // Small batches run on the calling thread; larger ones are split into
+    // sample chunks, each accumulating into the slot of whichever thread
+    // runs it (slot 0 for threads outside the pool). The final sum depends
+    // on which thread ran which chunk.
+    //
+    // Slot 0 is only safe because the one non-pool thread that can run
+    // these chunks is the caller: TaskGroup::wait() never runs another
+    // group's tasks. This assumes a single external thread trains this
+    // network at a time.
+    const bool parallel = m_parallelTraining &&
+                          batchSize >= 2 * kParallelGrain &&
+                          pool.workerCount() > 0;
+    const std::size_t slotCount = parallel ? m_gradSlots.size() : 1;
+
+    TrainPhaseTimer phases;
+    for (std::size_t s = 0; s < slotCount; ++s) {
+        zeroSlot(m_gradSlots[s]);
+    }
+    phases.lap(TrainPhase::Reduce);
+
+    if (!parallel) {
+        forwardBackwardRange(0, batchSize, m_gradSlots[0]);
+    } else {
+        pool.parallelFor(0, batchSize, kParallelGrain, [this, &pool](int begin, int end) {
+            forwardBackwardRange(begin, end, m_gradSlots[pool.currentWorkerIndex() + 1]);
+        });
+    }
+
+    // forwardBackwardRange timed its own phases.
+    phases.restart();
+    for (std::size_t s = 1; s < slotCount; ++s) {
+        addSlot(m_gradSlots[0], m_gradSlots[s]);
+    }
+    phases.lap(TrainPhase::Reduce);
+    return m_gradSlots[0];
+}
+
+const ToyNet::GradientSlot& ToyNet::accumulateDeterministic(int batchSize) {
+    ThreadPool& pool = *m_pool;
+
+    // Fixed blocks of samples, each with its own partial, are summed in a
+    // fixed pairwise tree. Neither depends on the worker count or on which
+    // thread ran a block, so the result is bit-identical for any pool size.
+    const int blockCount = (batchSize + DeterministicBlock - 1) / DeterministicBlock;
+
+    auto runBlocks = [this, batchSize](int first, int last) {
+        for (int b = first; b < last; ++b) {
+            GradientSlot& slot = m_blockSlots[b];
+            TrainPhaseTimer phases;
+            zeroSlot(slot);
+            phases.lap(TrainPhase::Reduce);
+            forwardBackwardRange(b * DeterministicBlock,
+                                 std::min((b + 1) * DeterministicBlock, batchSize),
+                                 slot);
+        }
+    };
+
+    if (m_parallelTraining && pool.workerCount() > 0 && blockCount > 1) {
+        // Blocks per task only affects scheduling, never the result.
+        const int grain = std::max(1, blockCount / pool.concurrency());
+        pool.parallelFor(0, blockCount, grain, runBlocks);
+    } else {
+        runBlocks(0, blockCount);
+    }
+
+    TrainPhaseTimer phases;
+    for (int stride = 1; stride < blockCount; stride *= 2) {
+        for (int b = 0; b + stride < blockCount; b += 2 * stride) {
+            addSlot(m_blockSlots[b], m_blockSlots[b + stride]);
+        }
+    }
+    phases.lap(TrainPhase::Reduce);
+    return m_blockSlots[0];
+}
+
+float ToyNet::gradientsFromInputs(int batchSize, float& outAccuracy) {
+    const GradientSlot& total = m_deterministic
+        ? accumulateDeterministic(batchSize)
+        : accumulateFast(batchSize);
+    TrainPhaseTimer phases;
+
+    m_dW1 = total.dW1;
+    m_db1 = total.db1;
+    m_dW2 = total.dW2;
+    m_db2 = total.db2;
+    m_dW3 = total.dW3;
+    m_db3 = total.db3;
+    const float lossSum = total.lossSum;
+    const int   correct = total.correct;
+
+    const float invN = 1.0f / static_cast<float>(batchSize);
+    float loss = lossSum * invN;
+    outAccuracy = static_cast<float>(correct) * invN;
+
+    // Average gradients over batch
+    for (auto& g : m_dW1) g *= invN;
+    for (auto& g : m_db1) g *= invN;
+    for (auto& g : m_dW2) g *= invN;
+    for (auto& g : m_db2) g *= invN;
+    for (auto& g : m_dW3) g *= invN;
+    for (auto& g : m_db3) g *= invN;
+    phases.lap(TrainPhase::Reduce);
 
     return loss;
 }
@@ -342,15 +545,16 @@ void ToyNet::forwardSingleWithActivations(float x, float y,
                                           float& p0, float& p1,
                                           float* outA1,
                                           float* outA2) const {
-    float a_in[InputDim] = {x, y};
+    float a_in[MaxInputDim];
+    expandFeatures(m_featureSet, x, y, a_in);
     float a_h1[Hidden1];
     float a_h2[Hidden2];
     float logitsLocal[OutputDim];
 
     for (int j = 0; j < Hidden1; ++j) {
         float sum = m_b1[j];
-        for (int i = 0; i < InputDim; ++i) {
-            sum += m_W1[idx(j, i, InputDim)] * a_in[i];
+        for (int i = 0; i < m_inputDim; ++i) {
+            sum += m_W1[idx(j, i, m_inputDim)] * a_in[i];
         }
         a_h1[j] = relu(sum);
     }
@@ -421,6 +625,31 @@ InitMode ToyNet::getInitMode() const {
     return m_initMode;
 }
 
+void ToyNet::setFeatureSet(FeatureSet set) {
+    m_featureSet = set;
+    m_inputDim   = featureDim(set);
+
+    const std::size_t w1Size = static_cast<std::size_t>(Hidden1 * m_inputDim);
+    m_W1.resize(w1Size);
+    m_dW1.resize(w1Size);
+    m_mW1.resize(w1Size);
+    m_vW1.resize(w1Size);
+    for (auto& slot : m_gradSlots) {
+        slot.dW1.resize(w1Size);
+    }
+    for (auto& slot : m_blockSlots) {
+        slot.dW1.resize(w1Size);
+    }
+}
+
+FeatureSet ToyNet::getFeatureSet() const {
+    return m_featureSet;
+}
+
+int ToyNet::getInputDim() const {
+    return m_inputDim;
+}
+
 void ToyNet::setOptimizer(OptimizerType type) {
     m_optimizerType = type;
 }
@@ -432,6 +661,108 @@ void ToyNet::setOptimizerHyperparams(float momentum, float beta1, float beta2, f
     m_adamEps   = eps;
 }
 
+void ToyNet::setParallelTraining(bool enabled) {
+    m_parallelTraining = enabled;
+}
+
+void ToyNet::setDeterministicReduction(bool enabled) {
+    m_deterministic = enabled;
+}
+
+bool ToyNet::getDeterministicReduction() const {
+    return m_deterministic;
+}
+
+void ToyNet::setThreadPool(ThreadPool& pool) {
+    m_pool = &pool;
+    m_gradSlots.resize(static_cast<std::size_t>(pool.concurrency()));
+    for (auto& slot : m_gradSlots) {
+        resizeSlot(slot);
+    }
+}
+
+int ToyNet::parameterCountFor(FeatureSet set) {
+    return Hidden1 * featureDim(set) + Hidden1 +
+           Hidden2 * Hidden1 + Hidden2 +
+           OutputDim * Hidden2 + OutputDim;
+}
+
+int ToyNet::getParameterCount() const {
+    return parameterCountFor(m_featureSet);
+}
+
+namespace {
+
+template <typename T>
+std::size_t vectorBytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+std::size_t slotBytes(const std::vector<float>& a, const std::vector<float>& b,
+                      const std::vector<float>& c, const std::vector<float>& d,
+                      const std::vector<float>& e, const std::vector<float>& f) {
+    return vectorBytes(a) + vectorBytes(b) + vectorBytes(c) +
+           vectorBytes(d) + vectorBytes(e) + vectorBytes(f);
+}
+
+}
+
+std::size_t ToyNet::modelMemoryBytes() const {
+    std::size_t bytes = slotBytes(m_W1, m_b1, m_W2, m_b2, m_W3, m_b3) +
+                        slotBytes(m_dW1, m_db1, m_dW2, m_db2, m_dW3, m_db3) +
+                        slotBytes(m_a0, m_z1, m_a1, m_z2, m_a2, m_logits) +
+                        vectorBytes(m_probs) + vectorBytes(m_labels);
+    for (const GradientSlot& g : m_gradSlots) {
+        bytes += slotBytes(g.dW1, g.db1, g.dW2, g.db2, g.dW3, g.db3);
+    }
+    for (const GradientSlot& g : m_blockSlots) {
+        bytes += slotBytes(g.dW1, g.db1, g.dW2, g.db2, g.dW3, g.db3);
+    }
+    return bytes + (m_gradSlots.capacity() + m_blockSlots.capacity()) * sizeof(GradientSlot);
+}
+
+std::size_t ToyNet::optimizerMemoryBytes() const {
+    return slotBytes(m_mW1, m_mb1, m_mW2, m_mb2, m_mW3, m_mb3) +
+           slotBytes(m_vW1, m_vb1, m_vW2, m_vb2, m_vW3, m_vb3);
+}
+
+void ToyNet::copyParametersTo(float* out) const {
+    out = std::copy(m_W1.begin(), m_W1.end(), out);
+    out = std::copy(m_b1.begin(), m_b1.end(), out);
+    out = std::copy(m_W2.begin(), m_W2.end(), out);
+    out = std::copy(m_b2.begin(), m_b2.end(), out);
+    out = std::copy(m_W3.begin(), m_W3.end(), out);
+    std::copy(m_b3.begin(), m_b3.end(), out);
+}
+
+void ToyNet::copyParametersFrom(const float* in) {
+    std::copy(in, in + m_W1.size(), m_W1.begin()); in += m_W1.size();
+    std::copy(in, in + m_b1.size(), m_b1.begin()); in += m_b1.size();
+    std::copy(in, in + m_W2.size(), m_W2.begin()); in += m_W2.size();
+    std::copy(in, in + m_b2.size(), m_b2.begin()); in += m_b2.size();
+    std::copy(in, in + m_W3.size(), m_W3.begin()); in += m_W3.size();
+    std::copy(in, in + m_b3.size(), m_b3.begin());
+}
+
+void ToyNet::copyGradientsTo(float* out) const {
+    out = std::copy(m_dW1.begin(), m_dW1.end(), out);
+    out = std::copy(m_db1.begin(), m_db1.end(), out);
+    out = std::copy(m_dW2.begin(), m_dW2.end(), out);
+    out = std::copy(m_db2.begin(), m_db2.end(), out);
+    out = std::copy(m_dW3.begin(), m_dW3.end(), out);
+    std::copy(m_db3.begin(), m_db3.end(), out);
+}
+
+void ToyNet::applyGradients(const float* grads) {
+    std::copy(grads, grads + m_dW1.size(), m_dW1.begin()); grads += m_dW1.size();
+    std::copy(grads, grads + m_db1.size(), m_db1.begin()); grads += m_db1.size();
+    std::copy(grads, grads + m_dW2.size(), m_dW2.begin()); grads += m_dW2.size();
+    std::copy(grads, grads + m_db2.size(), m_db2.begin()); grads += m_db2.size();
+    std::copy(grads, grads + m_dW3.size(), m_dW3.begin()); grads += m_dW3.size();
+    std::copy(grads, grads + m_db3.size(), m_db3.begin());
+    applyOptimizerStep();
+}
+
 const std::vector<float>& ToyNet::getW1() const { return m_W1; }
 const std::vector<float>& ToyNet::getB1() const { return m_b1; }
 const std::vector<float>& ToyNet::getW2() const { return m_W2; }
@@ -1,5 +1,31 @@
 #include "Trainer.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "AllocTracker.h"
+#include "LinearArena.h"
+#include "PerfCounters.h"
+#include "ThreadPool.h"
+
+namespace {
+
+// Points per chunk for full-dataset evaluation.
+const int kEvalGrain = 1024;
+
+// Batches the prefetch pipeline keeps ready ahead of training.
+const int kPrefetchDepth = 4;
+
+std::uint64_t nextRandom64(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+}
+
 Trainer::Trainer()
     : learningRate(0.1f)
     , batchSize(64)
@@ -13,16 +39,49 @@ Trainer::Trainer()
     , adamBeta2(0.999f)
     , adamEps(1e-8f)
     , initMode(InitMode::HeUniform)
+    , featureSet(FeatureSet::Raw)
+    , deterministic(false)
+    , hogwild(false)
+    , hogwildThreads(HogwildTrainer::defaultThreadCount())
+    , prefetch(false)
+    , streaming(false)
+    , compactStorage(false)
     , epochCount(0)
     , lastLoss(0.0f)
     , lastAccuracy(0.0f)
+    , fullLoss(0.0f)
+    , fullAccuracy(0.0f)
+    , fullEvalEpoch(-1)
     , historyCount(0)
     , m_dataCursor(0)
+    , m_augmentKey(0)
+    , m_hogwildBaseEpoch(0)
+    , m_streamType(DatasetType::TwoBlobs)
+    , m_streamSpread(0.1f)
+    , m_streamSeed(1)
+    , m_reservoirSize(0)
+    , m_streamSamples(0)
+    , m_reservoirRng(0)
+    , m_reservoirReset(false)
+    , m_historyStride(1)
+    , m_historySkip(0)
+    , m_historyLimit(HistorySize)
+    , m_phaseBaseline(trainPhaseTotals())
+    , m_modelMemory(MemoryTag::Model)
+    , m_optimizerMemory(MemoryTag::OptimizerState)
+    , m_trainingMemory(MemoryTag::TrainingData)
+    , m_historyMemory(MemoryTag::Histories)
 {
     m_batch.reserve(ToyNet::MaxBatch);
+    m_batchIndices.reserve(ToyNet::MaxBatch);
+    m_batchFeatures.resize(ToyNet::MaxBatch * ToyNet::MaxInputDim);
+    m_batchLabels.resize(ToyNet::MaxBatch);
+    m_batchX.resize(ToyNet::MaxBatch);
+    m_batchY.resize(ToyNet::MaxBatch);
     lossHistory.reserve(HistorySize);
     accuracyHistory.reserve(HistorySize);
     net.setInitMode(initMode);
+    net.setFeatureSet(featureSet);
     net.resetParameters();
     net.setOptimizer(optimizerType);
     net.setOptimizerHyperparams(momentum, adamBeta1, adamBeta2, adamEps);
@@ -30,17 +89,91 @@ Trainer::Trainer()
 
 void Trainer::resetForNewDataset()
 {
+    m_hogwild.stop();
     net.setInitMode(initMode);
+    net.setFeatureSet(featureSet);
     net.resetParameters();
     epochCount   = 0;
     lastLoss     = 0.0f;
     lastAccuracy = 0.0f;
+    fullLoss      = 0.0f;
+    fullAccuracy  = 0.0f;
+    fullEvalEpoch = -1;
     autoTrain    = false;
     m_dataCursor = 0;
 
+    resetPhaseTimes();
+
+    invalidateFeatureCache();
+    resetStream();
+
+    if (isLiveAttached()) {
+        // A reset while mirroring (e.g. the viewer regenerated its points)
+        // must not lose the mirrored state; the history is only appended to
+        // as points arrive, so it is kept as is.
+        applyLiveSnapshot();
+    } else {
+        clearHistory();
+    }
+}
+
+void Trainer::clearHistory()
+{
     historyCount = 0;
     lossHistory.clear();
     accuracyHistory.clear();
+    m_historyStride = 1;
+    m_historySkip   = 0;
+}
+
+void Trainer::invalidateFeatureCache()
+{
+    m_featureColumns.invalidate();
+    m_quantized.invalidate();
+    // Its batches were gathered from the old points.
+    m_pipeline.stop();
+}
+
+void Trainer::pointAppended(const std::vector<DataPoint>& dataset)
+{
+    if (dataset.empty()) {
+        return;
+    }
+    m_featureColumns.appendPoint(dataset.back());
+    m_quantized.appendPoint(dataset.back());
+    datasetEdited(dataset);
+}
+
+void Trainer::pointRemoved(const std::vector<DataPoint>& dataset, int index)
+{
+    m_featureColumns.removePointSwap(index);
+    m_quantized.removePointSwap(index);
+    datasetEdited(dataset);
+}
+
+void Trainer::swapFeatureColumns(FeatureColumns& columns)
+{
+    std::swap(m_featureColumns, columns);
+    m_quantized.invalidate();
+    m_pipeline.stop();
+}
+
+std::size_t Trainer::trainingCopyBytes() const
+{
+    return compactStorage ? m_quantized.memoryBytes() : m_featureColumns.memoryBytes();
+}
+
+void Trainer::datasetEdited(const std::vector<DataPoint>& dataset)
+{
+    // Background consumers hold a copy of the old points. Hogwild workers
+    // hand their weights back and restart on the next auto-train frame;
+    // the prefetch pipeline restarts on the next step.
+    stopHogwild();
+    m_pipeline.stop();
+
+    if (m_dataCursor >= static_cast<int>(dataset.size())) {
+        m_dataCursor = 0;
+    }
 }
 
 void Trainer::makeBatch(const std::vector<DataPoint>& dataset)
@@ -66,32 +199,409 @@ void Trainer::makeBatch(const std::vector<DataPoint>& dataset)
     }
 }
 
+void Trainer::makeFeatureBatch(const std::vector<DataPoint>& dataset)
+{
+    const int dataCount = static_cast<int>(dataset.size());
+
+    // Expanded features are computed once per dataset; every later step
+    // only gathers rows from the cached columns.
+    const FeatureSet set = net.getFeatureSet();
+    if (!m_featureColumns.matches(set, dataCount)) {
+        NN_ALLOW_ALLOC();
+        m_featureColumns.build(set, dataset);
+    }
+
+    int size = batchSize;
+    if (size < 1) {
+        size = 1;
+    }
+    if (size > ToyNet::MaxBatch) {
+        size = ToyNet::MaxBatch;
+    }
+
+    m_batchIndices.clear();
+    for (int i = 0; i < size; ++i) {
+        m_batchIndices.push_back(m_dataCursor);
+        m_batchLabels[i] = dataset[m_dataCursor].label;
+        m_dataCursor = (m_dataCursor + 1) % dataCount;
+    }
+
+    m_featureColumns.gatherRows(m_batchIndices.data(), size, m_batchFeatures.data());
+}
+
+int Trainer::makeAugmentedBatch(const std::vector<DataPoint>& dataset)
+{
+    int size = batchSize;
+    if (size < 1) {
+        size = 1;
+    }
+    if (size > ToyNet::MaxBatch) {
+        size = ToyNet::MaxBatch;
+    }
+
+    const int dataCount = static_cast<int>(dataset.size());
+    for (int i = 0; i < size; ++i) {
+        const DataPoint& p = dataset[m_dataCursor];
+        m_batchX[i]      = p.x;
+        m_batchY[i]      = p.y;
+        m_batchLabels[i] = p.label;
+        m_dataCursor = (m_dataCursor + 1) % dataCount;
+    }
+
+    // Rotation and scaling act on the raw inputs, so the cached feature
+    // columns cannot be used; expansion is O(batch) per step.
+    augmentBatch(augment, m_augmentKey++, m_batchX.data(), m_batchY.data(), m_batchLabels.data(), size);
+    expandFeatureRows(net.getFeatureSet(), m_batchX.data(), m_batchY.data(), size, m_batchFeatures.data());
+    return size;
+}
+
+int Trainer::makeCompactBatch(const std::vector<DataPoint>& dataset)
+{
+    const int dataCount = static_cast<int>(dataset.size());
+    if (!m_quantized.matches(dataCount)) {
+        NN_ALLOW_ALLOC();
+        m_quantized.build(dataset);
+        // The expanded columns would be several times the size of the
+        // quantized copy; drop them while this mode is on.
+        m_featureColumns = FeatureColumns();
+    }
+
+    int size = batchSize;
+    if (size < 1) {
+        size = 1;
+    }
+    if (size > ToyNet::MaxBatch) {
+        size = ToyNet::MaxBatch;
+    }
+
+    m_batchIndices.clear();
+    for (int i = 0; i < size; ++i) {
+        m_batchIndices.push_back(m_dataCursor);
+        m_dataCursor = (m_dataCursor + 1) % dataCount;
+    }
+
+    m_quantized.gather(m_batchIndices.data(), size,
+                       m_batchX.data(), m_batchY.data(), m_batchLabels.data());
+    if (augment.isActive()) {
+        augmentBatch(augment, m_augmentKey++, m_batchX.data(), m_batchY.data(), m_batchLabels.data(), size);
+    }
+    expandFeatureRows(net.getFeatureSet(), m_batchX.data(), m_batchY.data(), size, m_batchFeatures.data());
+    return size;
+}
+
 void Trainer::trainOneEpoch(const std::vector<DataPoint>& dataset)
 {
-    if (dataset.empty()) {
+    NN_ASSERT_NO_ALLOC("Trainer::trainOneEpoch");
+
+    if (dataset.empty() && !streaming) {
         return;
     }
 
+    if (isLiveAttached()) {
+        return;
+    }
+
+    stopHogwild();
+
     net.setLearningRate(learningRate);
     net.setOptimizer(optimizerType);
     net.setOptimizerHyperparams(momentum, adamBeta1, adamBeta2, adamEps);
+    net.setDeterministicReduction(deterministic);
 
-    makeBatch(dataset);
+    if (!prefetch && !streaming) {
+        m_pipeline.stop();
+    }
+
+    const PreparedBatch* prepared = nullptr;
+    if (streaming) {
+        prepared = acquireStreamed();
+    } else if (prefetch) {
+        prepared = acquirePrefetched(dataset);
+    }
+    if (!prepared && dataset.empty()) {
+        return;
+    }
 
-    lastLoss = net.trainBatch(m_batch, lastAccuracy);
+    int samples = 0;
+    if (prepared) {
+        samples  = prepared->count;
+        lastLoss = net.trainBatchFeatures(prepared->features.data(),
+                                          prepared->labels.data(),
+                                          prepared->count,
+                                          lastAccuracy);
+        if (streaming) {
+            sampleIntoReservoir(*prepared);
+        }
+        m_pipeline.release(prepared);
+    } else if (compactStorage) {
+        const int count = makeCompactBatch(dataset);
+        samples  = count;
+        lastLoss = net.trainBatchFeatures(m_batchFeatures.data(),
+                                          m_batchLabels.data(),
+                                          count,
+                                          lastAccuracy);
+    } else if (augment.isActive()) {
+        const int count = makeAugmentedBatch(dataset);
+        samples  = count;
+        lastLoss = net.trainBatchFeatures(m_batchFeatures.data(),
+                                          m_batchLabels.data(),
+                                          count,
+                                          lastAccuracy);
+    } else if (net.getFeatureSet() != FeatureSet::Raw) {
+        makeFeatureBatch(dataset);
+        samples  = static_cast<int>(m_batchIndices.size());
+        lastLoss = net.trainBatchFeatures(m_batchFeatures.data(),
+                                          m_batchLabels.data(),
+                                          static_cast<int>(m_batchIndices.size()),
+                                          lastAccuracy);
+    } else {
+        makeBatch(dataset);
+        samples  = static_cast<int>(m_batch.size());
+        lastLoss = net.trainBatch(m_batch, lastAccuracy);
+    }
     ++epochCount;
 
-    lossHistory.push_back(lastLoss);
-    accuracyHistory.push_back(lastAccuracy);
+    PerfRegistry::shared().add(PerfCounter::TrainSteps, 1);
+    PerfRegistry::shared().add(PerfCounter::TrainSamples, static_cast<std::uint64_t>(samples));
+
+    recordHistory();
+}
+
+void Trainer::recordHistory()
+{
+    appendHistoryPoint(lastLoss, lastAccuracy);
+}
+
+void Trainer::appendHistoryPoint(float loss, float accuracy)
+{
+    if (++m_historySkip < m_historyStride) {
+        return;
+    }
+    m_historySkip = 0;
+
+    if (lossHistory.size() >= static_cast<std::size_t>(m_historyLimit)) {
+        halveHistory();
+    }
+
+    lossHistory.push_back(loss);
+    accuracyHistory.push_back(accuracy);
     historyCount = static_cast<int>(lossHistory.size());
 }
 
+void Trainer::halveHistory()
+{
+    // Keep every other point; stays within the reserved capacity.
+    const std::size_t kept = lossHistory.size() / 2;
+    for (std::size_t i = 0; i < kept; ++i) {
+        lossHistory[i]     = lossHistory[2 * i + 1];
+        accuracyHistory[i] = accuracyHistory[2 * i + 1];
+    }
+    lossHistory.resize(kept);
+    accuracyHistory.resize(kept);
+    m_historyStride *= 2;
+    historyCount = static_cast<int>(kept);
+}
+
+void Trainer::setHistoryLimit(int points)
+{
+    points = std::max(16, std::min(points, static_cast<int>(HistorySize)));
+    if (points == m_historyLimit) {
+        return;
+    }
+    m_historyLimit = points;
+
+    while (lossHistory.size() >= static_cast<std::size_t>(m_historyLimit)) {
+        halveHistory();
+    }
+    // Reallocate at the new cap so the memory is actually returned.
+    std::vector<float> loss;
+    std::vector<float> accuracy;
+    loss.reserve(m_historyLimit);
+    accuracy.reserve(m_historyLimit);
+    loss.assign(lossHistory.begin(), lossHistory.end());
+    accuracy.assign(accuracyHistory.begin(), accuracyHistory.end());
+    lossHistory.swap(loss);
+    accuracyHistory.swap(accuracy);
+}
+
+int Trainer::historyLimit() const
+{
+    return m_historyLimit;
+}
+
+void Trainer::reportMemory()
+{
+    m_modelMemory.set(net.modelMemoryBytes());
+    m_optimizerMemory.set(net.optimizerMemoryBytes());
+
+    std::size_t training = trainingCopyBytes();
+    training += m_reservoir.capacity() * sizeof(DataPoint);
+    training += m_reservoirChangedSlots.capacity() * sizeof(int) + m_reservoirSlotChanged.capacity();
+    training += m_batch.capacity() * sizeof(DataPoint);
+    training += m_batchIndices.capacity() * sizeof(int);
+    training += m_batchFeatures.capacity() * sizeof(float);
+    training += m_batchLabels.capacity() * sizeof(int);
+    training += (m_batchX.capacity() + m_batchY.capacity()) * sizeof(float);
+    m_trainingMemory.set(training);
+
+    m_historyMemory.set((lossHistory.capacity() + accuracyHistory.capacity()) * sizeof(float));
+}
+
+TrainPhaseTimes Trainer::phaseTimes() const
+{
+    return trainPhaseDelta(trainPhaseTotals(), m_phaseBaseline);
+}
+
+void Trainer::resetPhaseTimes()
+{
+    m_phaseBaseline = trainPhaseTotals();
+}
+
+const PreparedBatch* Trainer::acquirePrefetched(const std::vector<DataPoint>& dataset)
+{
+    const FeatureSet set = net.getFeatureSet();
+    if (!m_pipeline.matches(set, batchSize, static_cast<int>(dataset.size()), augment)) {
+        // First use, or the batch size / feature set / augmentation changed.
+        NN_ALLOW_ALLOC();
+        const unsigned int seed = static_cast<unsigned int>(epochCount) + 1u;
+        if (!m_pipeline.start(dataset, set, batchSize, kPrefetchDepth, seed, augment)) {
+            prefetch = false;
+            return nullptr;
+        }
+    }
+    return m_pipeline.acquire();
+}
+
+const PreparedBatch* Trainer::acquireStreamed()
+{
+    const FeatureSet set = net.getFeatureSet();
+    if (!m_pipeline.matchesStream(m_streamType, m_streamSpread, m_streamSeed, set, batchSize, augment)) {
+        // Resume where training stopped so a restart never replays samples
+        // the network has already seen.
+        NN_ALLOW_ALLOC();
+        if (!m_pipeline.startStream(m_streamType, m_streamSpread, m_streamSeed,
+                                    m_streamSamples, set, batchSize, kPrefetchDepth, augment)) {
+            streaming = false;
+            return nullptr;
+        }
+    }
+    return m_pipeline.acquire();
+}
+
+void Trainer::sampleIntoReservoir(const PreparedBatch& batch)
+{
+    // Algorithm R: after n samples every one of them is in the reservoir
+    // with probability reservoirSize / n. The samples come from
+    // batch.points, not the feature rows, so augmentation never reaches the
+    // displayed points or the full-dataset evaluation.
+    const std::size_t capacity = static_cast<std::size_t>(std::max(m_reservoirSize, 0));
+    for (int i = 0; i < batch.count; ++i) {
+        const DataPoint& p = batch.points[static_cast<std::size_t>(i)];
+        ++m_streamSamples;
+        if (m_reservoir.size() < capacity) {
+            markReservoirSlot(m_reservoir.size());
+            m_reservoir.push_back(p);
+            continue;
+        }
+        const std::uint64_t slot = nextRandom64(m_reservoirRng) % m_streamSamples;
+        if (slot < capacity) {
+            m_reservoir[static_cast<std::size_t>(slot)] = p;
+            markReservoirSlot(static_cast<std::size_t>(slot));
+        }
+    }
+}
+
+void Trainer::markReservoirSlot(std::size_t slot)
+{
+    // Both lists are sized for the full reservoir in setStreamSource().
+    if (!m_reservoirSlotChanged[slot]) {
+        m_reservoirSlotChanged[slot] = 1;
+        m_reservoirChangedSlots.push_back(static_cast<int>(slot));
+    }
+}
+
+void Trainer::resetStream()
+{
+    m_pipeline.stop();
+    m_reservoir.clear();
+    m_streamSamples    = 0;
+    m_reservoirRng     = m_streamSeed;
+    clearReservoirChanges();
+    m_reservoirReset   = true;
+}
+
+void Trainer::setStreamSource(DatasetType type, float spread, unsigned int seed, int reservoirSize)
+{
+    if (type == m_streamType && spread == m_streamSpread && seed == m_streamSeed &&
+        reservoirSize == m_reservoirSize) {
+        return;
+    }
+    m_streamType    = type;
+    m_streamSpread  = spread;
+    m_streamSeed    = seed;
+    m_reservoirSize = reservoirSize;
+    // Only on a settings change.
+    NN_ALLOW_ALLOC();
+    const std::size_t capacity = static_cast<std::size_t>(std::max(reservoirSize, 0));
+    m_reservoir.reserve(capacity);
+    m_reservoirChangedSlots.reserve(capacity);
+    m_reservoirSlotChanged.assign(capacity, 0);
+    resetStream();
+}
+
+const std::vector<DataPoint>& Trainer::streamReservoir() const
+{
+    return m_reservoir;
+}
+
+std::uint64_t Trainer::streamSampleCount() const
+{
+    return m_streamSamples;
+}
+
+bool Trainer::reservoirWasReset() const
+{
+    return m_reservoirReset;
+}
+
+const std::vector<int>& Trainer::reservoirChangedSlots() const
+{
+    return m_reservoirChangedSlots;
+}
+
+void Trainer::clearReservoirChanges()
+{
+    for (int slot : m_reservoirChangedSlots) {
+        m_reservoirSlotChanged[static_cast<std::size_t>(slot)] = 0;
+    }
+    m_reservoirChangedSlots.clear();
+    m_reservoirReset = false;
+}
+
 bool Trainer::autoTrainEpochs(const std::vector<DataPoint>& dataset)
 {
+    if (isLiveAttached()) {
+        return pullLive();
+    }
+
+    if (m_hogwild.isRunning() && (!autoTrain || !hogwild)) {
+        // Auto-train was switched off, or back to synchronous mode, while
+        // the workers were running; keep what they learned.
+        stopHogwild();
+        if (!autoTrain) {
+            evaluateFullDataset(dataset);
+            return true;
+        }
+    }
+
     if (!autoTrain) {
         return false;
     }
 
+    if (hogwild && !streaming) {
+        return autoTrainHogwild(dataset);
+    }
+
     trainOneEpoch(dataset);
 
     bool stopByEpoch = (autoMaxEpochs > 0 && epochCount >= autoMaxEpochs);
@@ -99,7 +609,198 @@ bool Trainer::autoTrainEpochs(const std::vector<DataPoint>& dataset)
 
     if (stopByEpoch || stopByLoss) {
         autoTrain = false;
+        evaluateFullDataset(dataset);
     }
 
     return true;
 }
+
+bool Trainer::autoTrainHogwild(const std::vector<DataPoint>& dataset)
+{
+    if (!m_hogwild.isRunning()) {
+        // Worker threads and the shared parameter arrays: once per run.
+        NN_ALLOW_ALLOC();
+        net.setLearningRate(learningRate);
+        m_hogwild.setHyperparams(optimizerType, learningRate, momentum);
+        if (!m_hogwild.start(net, dataset, hogwildThreads, batchSize)) {
+            // No threads available: fall back to synchronous training.
+            hogwild = false;
+            trainOneEpoch(dataset);
+            return true;
+        }
+        m_hogwildBaseEpoch = epochCount;
+    }
+
+    m_hogwild.setHyperparams(optimizerType, learningRate, momentum);
+
+    // The workers run freely; once per frame pull their parameters for
+    // display and record one history point.
+    m_hogwild.readParameters(net);
+    const HogwildStats stats = m_hogwild.stats();
+    recordHogwildProgress(stats);
+    lastLoss     = stats.lastLoss;
+    lastAccuracy = stats.lastAccuracy;
+
+    recordHistory();
+
+    bool stopByEpoch = (autoMaxEpochs > 0 && epochCount >= autoMaxEpochs);
+    bool stopByLoss  = (useTargetLossStop && autoTargetLoss > 0.0f && lastLoss <= autoTargetLoss);
+
+    if (stopByEpoch || stopByLoss) {
+        autoTrain = false;
+        stopHogwild();
+        evaluateFullDataset(dataset);
+    }
+
+    return true;
+}
+
+void Trainer::stopHogwild()
+{
+    if (!m_hogwild.isRunning()) {
+        return;
+    }
+    m_hogwild.stop();
+    m_hogwild.readParameters(net);
+
+    recordHogwildProgress(m_hogwild.stats());
+}
+
+void Trainer::recordHogwildProgress(const HogwildStats& stats)
+{
+    // The workers' updates since the last call are this frame's steps.
+    const int updated = m_hogwildBaseEpoch + static_cast<int>(stats.updates);
+    if (updated > epochCount) {
+        const std::uint64_t steps = static_cast<std::uint64_t>(updated - epochCount);
+        PerfRegistry::shared().add(PerfCounter::TrainSteps, steps);
+        PerfRegistry::shared().add(PerfCounter::TrainSamples, steps * static_cast<std::uint64_t>(batchSize));
+    }
+    epochCount = updated;
+}
+
+bool Trainer::attachLive(const std::string& segmentName)
+{
+    stopHogwild();
+    autoTrain = false;
+    m_liveSnapshot = LiveSnapshot();
+    // The first read delivers the published history, up to LiveHistorySize
+    // points.
+    clearHistory();
+    return m_liveSubscriber.attach(segmentName);
+}
+
+void Trainer::detachLive()
+{
+    m_liveSubscriber.detach();
+}
+
+bool Trainer::isLiveAttached() const
+{
+    return m_liveSubscriber.isAttached();
+}
+
+const LiveSnapshot& Trainer::liveSnapshot() const
+{
+    return m_liveSnapshot;
+}
+
+bool Trainer::pullLive()
+{
+    if (!m_liveSubscriber.read(m_liveSnapshot)) {
+        return false;
+    }
+    applyLiveSnapshot();
+    // Same stride and decimation as local training, so the mirrored history
+    // stays within the history limit.
+    for (std::size_t i = 0; i < m_liveSnapshot.newLoss.size(); ++i) {
+        appendHistoryPoint(m_liveSnapshot.newLoss[i], m_liveSnapshot.newAccuracy[i]);
+    }
+    return true;
+}
+
+void Trainer::applyLiveSnapshot()
+{
+    if (featureSet != m_liveSnapshot.featureSet) {
+        // Reshapes W1; the scene notices the new feature set and rebuilds
+        // the field shader.
+        featureSet = m_liveSnapshot.featureSet;
+        net.setFeatureSet(featureSet);
+        invalidateFeatureCache();
+    }
+    if (static_cast<int>(m_liveSnapshot.params.size()) == net.getParameterCount()) {
+        net.copyParametersFrom(m_liveSnapshot.params.data());
+    }
+
+    epochCount   = m_liveSnapshot.step;
+    lastLoss     = m_liveSnapshot.loss;
+    lastAccuracy = m_liveSnapshot.accuracy;
+}
+
+bool Trainer::isHogwildRunning() const
+{
+    return m_hogwild.isRunning();
+}
+
+HogwildStats Trainer::hogwildStats() const
+{
+    return m_hogwild.stats();
+}
+
+bool Trainer::isPrefetchRunning() const
+{
+    return m_pipeline.isRunning();
+}
+
+BatchPipelineStats Trainer::prefetchStats() const
+{
+    return m_pipeline.stats();
+}
+
+void Trainer::evaluateFullDataset(const std::vector<DataPoint>& dataset)
+{
+    const int count = static_cast<int>(dataset.size());
+    if (count == 0) {
+        fullLoss      = 0.0f;
+        fullAccuracy  = 0.0f;
+        fullEvalEpoch = epochCount;
+        return;
+    }
+
+    const int chunkCount = (count + kEvalGrain - 1) / kEvalGrain;
+    // Per-chunk sums live only for this call; take them from the caller's
+    // scratch arena.
+    ArenaScope scratch;
+    ArenaVector<EvalPartial> partials(static_cast<std::size_t>(chunkCount),
+                                      EvalPartial{0.0f, 0},
+                                      ArenaAllocator<EvalPartial>(scratch.arena()));
+
+    const ToyNet& model = net;
+    ThreadPool::shared().parallelFor(0, count, kEvalGrain, [&](int begin, int end) {
+        EvalPartial& part = partials[begin / kEvalGrain];
+        for (int i = begin; i < end; ++i) {
+            const DataPoint& p = dataset[i];
+            float p0 = 0.0f;
+            float p1 = 0.0f;
+            model.forwardSingle(p.x, p.y, p0, p1);
+
+            const float correctProb = (p.label == 1) ? p1 : p0;
+            const int   predicted   = (p1 > p0) ? 1 : 0;
+            part.lossSum += -std::log(std::max(correctProb, 1e-6f));
+            if (predicted == p.label) {
+                ++part.correct;
+            }
+        }
+    });
+
+    float lossSum = 0.0f;
+    int   correct = 0;
+    for (const auto& part : partials) {
+        lossSum += part.lossSum;
+        correct += part.correct;
+    }
+
+    const float invN = 1.0f / static_cast<float>(count);
+    fullLoss      = lossSum * invN;
+    fullAccuracy  = static_cast<float>(correct) * invN;
+    fullEvalEpoch = epochCount;
+}
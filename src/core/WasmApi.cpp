@@ -1,5 +1,7 @@
 #ifdef __EMSCRIPTEN__
 
+#include <algorithm>
+
 #include "WasmScene.h"
 
 // C API functions for controlling the wasm scene from JavaScript.
@@ -18,19 +20,24 @@ void nn_set_dataset(int datasetIndex, int numPoints, float spread) {
     g_wasmState.ui.datasetIndex = datasetIndex;
     g_wasmState.ui.numPoints    = numPoints;
     g_wasmState.ui.spread       = spread;
-
-    DatasetType currentDataset = static_cast<DatasetType>(g_wasmState.ui.datasetIndex);
-    generateDataset(currentDataset,
-                    g_wasmState.ui.numPoints,
-                    g_wasmState.ui.spread,
-                    g_wasmState.dataset);
+    ++g_wasmState.ui.datasetSeed;
+
+    DatasetKey key;
+    key.type      = static_cast<DatasetType>(g_wasmState.ui.datasetIndex);
+    key.numPoints = g_wasmState.ui.numPoints;
+    key.spread    = g_wasmState.ui.spread;
+    key.seed      = g_wasmState.ui.datasetSeed;
+    activateDataset(key,
+                    g_wasmState.dataset,
+                    g_wasmState.pointGrid,
+                    g_wasmState.datasetCache,
+                    g_wasmState.trainer);
     g_wasmState.pointCloud.upload(g_wasmState.dataset);
 
     g_wasmState.ui.hasSelectedPoint   = false;
     g_wasmState.ui.selectedPointIndex = -1;
     g_wasmState.ui.selectedLabel      = -1;
 
-    g_wasmState.trainer.resetForNewDataset();
     g_wasmState.fieldVis.setDirty();
 }
 
@@ -105,6 +112,26 @@ void nn_set_init_mode(int initMode) {
     g_wasmState.fieldVis.setDirty();
 }
 
+void nn_set_feature_set(int featureSet) {
+    if (featureSet < 0) featureSet = 0;
+    if (featureSet >= FeatureSetCount) featureSet = FeatureSetCount - 1;
+    g_wasmState.trainer.featureSet = static_cast<FeatureSet>(featureSet);
+    g_wasmState.trainer.resetForNewDataset();
+    g_wasmState.fieldVis.setDirty();
+}
+
+void nn_set_deterministic(int enabled) {
+    g_wasmState.trainer.deterministic = (enabled != 0);
+}
+
+void nn_set_augmentation(float jitter, float maxRotation, float scaleRange, float labelNoise) {
+    AugmentConfig& aug = g_wasmState.trainer.augment;
+    aug.jitter      = std::max(jitter, 0.0f);
+    aug.maxRotation = std::min(std::max(maxRotation, 0.0f), MaxAugmentRotation);
+    aug.scaleRange  = std::min(std::max(scaleRange, 0.0f), 0.9f);
+    aug.labelNoise  = std::min(std::max(labelNoise, 0.0f), 1.0f);
+}
+
 void nn_set_probe_enabled(int enabled) {
     g_wasmState.ui.probeEnabled = (enabled != 0);
 }
@@ -190,6 +217,30 @@ int nn_get_init_mode() {
     return static_cast<int>(g_wasmState.trainer.initMode);
 }
 
+int nn_get_feature_set() {
+    return static_cast<int>(g_wasmState.trainer.featureSet);
+}
+
+int nn_get_deterministic() {
+    return g_wasmState.trainer.deterministic ? 1 : 0;
+}
+
+float nn_get_augment_jitter() {
+    return g_wasmState.trainer.augment.jitter;
+}
+
+float nn_get_augment_rotation() {
+    return g_wasmState.trainer.augment.maxRotation;
+}
+
+float nn_get_augment_scale() {
+    return g_wasmState.trainer.augment.scaleRange;
+}
+
+float nn_get_augment_label_noise() {
+    return g_wasmState.trainer.augment.labelNoise;
+}
+
 int nn_get_probe_enabled() {
     return g_wasmState.ui.probeEnabled ? 1 : 0;
 }
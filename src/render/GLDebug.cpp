@@ -0,0 +1,260 @@
+// Use GLAD as the OpenGL loader on desktop, and GLES3 headers on Emscripten.
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+
+#ifdef __EMSCRIPTEN__
+#define GLFW_INCLUDE_ES3
+#include <GLFW/glfw3.h>
+#else
+#define GLFW_INCLUDE_NONE
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#endif
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#include "GLDebug.h"
+#include "Logger.h"
+
+#ifndef __EMSCRIPTEN__
+namespace {
+
+// KHR_debug enums; the GLAD loader in extern/ is generated for 3.3 core
+// without the extension.
+const GLenum kDebugOutput             = 0x92E0;
+const GLenum kDebugSeverityHigh       = 0x9146;
+const GLenum kDebugSeverityMedium     = 0x9147;
+const GLenum kDebugSeverityLow        = 0x9148;
+const GLenum kDebugSeverityNotify     = 0x826B;
+const GLenum kDebugSourceApplication  = 0x824A;
+const GLenum kDebugTypeError          = 0x824C;
+const GLenum kDebugTypePushGroup      = 0x8269;
+const GLenum kDebugTypePopGroup       = 0x826A;
+const GLint  kContextFlagDebugBit     = 0x00000002;
+
+typedef void (APIENTRYP DebugMessageCallbackProc)(GLDEBUGPROC callback, const void* userParam);
+typedef void (APIENTRYP DebugMessageControlProc)(GLenum source, GLenum type, GLenum severity,
+                                                 GLsizei count, const GLuint* ids, GLboolean enabled);
+typedef void (APIENTRYP ObjectLabelProc)(GLenum identifier, GLuint name, GLsizei length, const GLchar* label);
+typedef void (APIENTRYP PushDebugGroupProc)(GLenum source, GLuint id, GLsizei length, const GLchar* message);
+typedef void (APIENTRYP PopDebugGroupProc)();
+
+DebugMessageCallbackProc s_debugMessageCallback = nullptr;
+DebugMessageControlProc  s_debugMessageControl  = nullptr;
+ObjectLabelProc          s_objectLabel          = nullptr;
+PushDebugGroupProc       s_pushDebugGroup       = nullptr;
+PopDebugGroupProc        s_popDebugGroup        = nullptr;
+bool                     s_outputActive         = false;
+
+// Messages logged before the callback goes quiet, so a per-frame warning
+// cannot flood the log.
+const int kMaxMessages = 100;
+std::atomic<int> s_messageCount(0);
+
+// Severities from most to least important; the threshold is an index.
+const GLenum kSeverities[] = {
+    kDebugSeverityHigh,
+    kDebugSeverityMedium,
+    kDebugSeverityLow,
+    kDebugSeverityNotify,
+};
+const int kSeverityCount = 4;
+
+struct ThresholdName {
+    const char* name;
+    int         threshold;
+};
+
+const ThresholdName kThresholdNames[] = {
+    {"off", 0}, {"high", 1}, {"medium", 2}, {"low", 3}, {"all", 4},
+};
+
+// Number of kSeverities reported: 0 = off, 4 = everything.
+int severityThreshold()
+{
+    const char* env = std::getenv("NNDEMO_GL_DEBUG");
+    if (env) {
+        for (const ThresholdName& entry : kThresholdNames) {
+            if (std::strcmp(env, entry.name) == 0) {
+                return entry.threshold;
+            }
+        }
+        NN_LOG_WARN("[GLDebug] Unknown NNDEMO_GL_DEBUG value '%s'", env);
+    }
+#ifdef NDEBUG
+    return 1;
+#else
+    return 3;
+#endif
+}
+
+const char* severityName(GLenum severity)
+{
+    switch (severity) {
+    case kDebugSeverityHigh:   return "high";
+    case kDebugSeverityMedium: return "medium";
+    case kDebugSeverityLow:    return "low";
+    default:                   return "note";
+    }
+}
+
+// May run on a driver thread, since the output is asynchronous.
+void APIENTRY debugMessageCallback(GLenum source,
+                                   GLenum type,
+                                   GLuint id,
+                                   GLenum severity,
+                                   GLsizei length,
+                                   const GLchar* message,
+                                   const void* userParam)
+{
+    (void)source;
+    (void)userParam;
+    const int count = s_messageCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (count > kMaxMessages) {
+        return;
+    }
+    const LogLevel level = type == kDebugTypeError || severity == kDebugSeverityHigh ? LogLevel::Error
+                         : severity == kDebugSeverityMedium                        ? LogLevel::Warn
+                                                                                   : LogLevel::Info;
+    if (!logEnabled(level)) {
+        return;
+    }
+    logMessage(level,
+               "[GL %s] (%s, id=%u) %.*s%s",
+               type == kDebugTypeError ? "ERROR" : "DEBUG",
+               severityName(severity),
+               id,
+               static_cast<int>(length >= 0 ? length : std::strlen(message)),
+               message,
+               count == kMaxMessages ? "; further messages suppressed" : "");
+}
+
+bool hasKhrDebug()
+{
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major > 4 || (major == 4 && minor >= 3)) {
+        return true;
+    }
+
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; ++i) {
+        const GLubyte* name = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+        if (name && std::strcmp(reinterpret_cast<const char*>(name), "GL_KHR_debug") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Proc>
+Proc loadProc(const char* name)
+{
+    return reinterpret_cast<Proc>(glfwGetProcAddress(name));
+}
+
+} // namespace
+#endif
+
+bool initGLDebug()
+{
+#ifdef __EMSCRIPTEN__
+    return false;
+#else
+    if (!hasKhrDebug()) {
+        NN_LOG_INFO("[GLDebug] KHR_debug not available; using glGetError checks in debug builds");
+        return false;
+    }
+
+    s_debugMessageCallback = loadProc<DebugMessageCallbackProc>("glDebugMessageCallback");
+    s_debugMessageControl  = loadProc<DebugMessageControlProc>("glDebugMessageControl");
+    s_objectLabel          = loadProc<ObjectLabelProc>("glObjectLabel");
+    s_pushDebugGroup       = loadProc<PushDebugGroupProc>("glPushDebugGroup");
+    s_popDebugGroup        = loadProc<PopDebugGroupProc>("glPopDebugGroup");
+    if (!s_pushDebugGroup || !s_popDebugGroup) {
+        s_pushDebugGroup = nullptr;
+        s_popDebugGroup  = nullptr;
+    }
+    if (!s_debugMessageCallback || !s_debugMessageControl) {
+        NN_LOG_WARN("[GLDebug] KHR_debug advertised but glDebugMessageCallback is missing");
+        return false;
+    }
+
+    const int threshold = severityThreshold();
+    if (threshold == 0) {
+        NN_LOG_INFO("[GLDebug] Debug output disabled (NNDEMO_GL_DEBUG=off)");
+        return false;
+    }
+
+    for (int i = 0; i < kSeverityCount; ++i) {
+        s_debugMessageControl(GL_DONT_CARE, GL_DONT_CARE, kSeverities[i], 0, nullptr,
+                              i < threshold ? GL_TRUE : GL_FALSE);
+    }
+    // Our own group markers would echo back every frame.
+    s_debugMessageControl(GL_DONT_CARE, kDebugTypePushGroup, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+    s_debugMessageControl(GL_DONT_CARE, kDebugTypePopGroup, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+
+    // GL_DEBUG_OUTPUT_SYNCHRONOUS stays off: messages may arrive late and on
+    // another thread, but the driver never has to serialize for them.
+    s_debugMessageCallback(debugMessageCallback, nullptr);
+    glEnable(kDebugOutput);
+    s_outputActive = true;
+
+    GLint flags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    NN_LOG_INFO("[GLDebug] Debug output enabled (%s severity and above%s)",
+                severityName(kSeverities[threshold - 1]),
+                (flags & kContextFlagDebugBit) ? ", debug context" : "");
+    return true;
+#endif
+}
+
+bool glDebugOutputActive()
+{
+#ifdef __EMSCRIPTEN__
+    return false;
+#else
+    return s_outputActive;
+#endif
+}
+
+void labelGLObject(GLObjectType type, unsigned int name, const char* label)
+{
+#ifdef __EMSCRIPTEN__
+    (void)type;
+    (void)name;
+    (void)label;
+#else
+    if (s_objectLabel && name != 0) {
+        s_objectLabel(static_cast<GLenum>(type), name, -1, label);
+    }
+#endif
+}
+
+GLDebugGroup::GLDebugGroup(const char* name)
+    : m_pushed(false)
+{
+#ifdef __EMSCRIPTEN__
+    (void)name;
+#else
+    if (s_pushDebugGroup) {
+        s_pushDebugGroup(kDebugSourceApplication, 0, -1, name);
+        m_pushed = true;
+    }
+#endif
+}
+
+GLDebugGroup::~GLDebugGroup()
+{
+#ifndef __EMSCRIPTEN__
+    if (m_pushed) {
+        s_popDebugGroup();
+    }
+#endif
+}
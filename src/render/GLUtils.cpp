@@ -12,36 +12,61 @@
 #include <GLFW/glfw3.h>
 #endif
 
-#include <iostream>
+#include <chrono>
 #include <fstream>
 #include <sstream>
 
+#include "GLDebug.h"
 #include "GLUtils.h"
+#include "Logger.h"
+
+namespace {
+
+// Minimum time between two glGetError polls. Each poll waits for the GPU
+// to catch up with every command issued so far.
+const std::chrono::milliseconds kMinErrorPollInterval(250);
+
+}
 
 void glfw_error_callback(int error, const char* description) {
-    std::cerr << "[GLFW ERROR] code=" << error << ", description=" << description << std::endl;
+    NN_LOG_ERROR("[GLFW ERROR] code=%d, description=%s", error, description);
 }
 
 void check_gl_error(const char* label) {
+#ifdef NDEBUG
+    (void)label;
+#else
+    if (glDebugOutputActive()) {
+        return;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    static Clock::time_point lastPoll;
+    static bool polled = false;
+    const Clock::time_point now = Clock::now();
+    if (polled && now - lastPoll < kMinErrorPollInterval) {
+        return;
+    }
+    polled   = true;
+    lastPoll = now;
+
+    // Errors are sticky, so one skipped by the rate limit shows up here
+    // under a later label.
     GLenum err;
-    bool hadError = false;
     while ((err = glGetError()) != GL_NO_ERROR) {
-        hadError = true;
-        std::cerr << "[GL ERROR] (" << label << ") code=0x" << std::hex << err << std::dec << std::endl;
-    }
-    if (!hadError) {
-        std::cout << "[GL OK] (" << label << ")" << std::endl;
+        NN_LOG_ERROR("[GL ERROR] (at or before %s) code=0x%x", label, err);
     }
+#endif
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
-    std::cout << "[Callback] framebuffer_size_callback: width=" << width << ", height=" << height << std::endl;
+    NN_LOG_INFO("[Callback] framebuffer_size_callback: width=%d, height=%d", width, height);
     glViewport(0, 0, width, height);
 }
 
 std::optional<std::string> loadTextFile(const char* path) {
     if (!path) {
-        std::cerr << "[File] Failed to open text file: <null path>" << std::endl;
+        NN_LOG_ERROR("[File] Failed to open text file: <null path>");
         return std::nullopt;
     }
 
@@ -52,8 +77,7 @@ std::optional<std::string> loadTextFile(const char* path) {
         std::string altPath = std::string("../") + path;
         file.open(altPath);
         if (!file) {
-            std::cerr << "[File] Failed to open text file: " << path
-                      << " or " << altPath << std::endl;
+            NN_LOG_ERROR("[File] Failed to open text file: %s or %s", path, altPath.c_str());
             return std::nullopt;
         }
     }
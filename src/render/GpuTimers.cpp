@@ -0,0 +1,170 @@
+// Use GLAD as the OpenGL loader on desktop, and GLES3 headers on Emscripten.
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+
+#ifdef __EMSCRIPTEN__
+#define GLFW_INCLUDE_ES3
+#include <GLFW/glfw3.h>
+#else
+#define GLFW_INCLUDE_NONE
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#endif
+
+#include <algorithm>
+
+#include "GpuTimers.h"
+
+GpuPassTimers::GpuPassTimers()
+    : m_slot(0)
+    , m_active(false)
+{
+    for (int f = 0; f < GpuTimerLatency; ++f) {
+        for (int p = 0; p < GpuPassCount; ++p) {
+            m_queries[f][p] = 0;
+            m_issued[f][p]  = false;
+        }
+    }
+    resetStats();
+}
+
+GpuPassTimers& GpuPassTimers::shared()
+{
+    static GpuPassTimers timers;
+    return timers;
+}
+
+bool GpuPassTimers::init()
+{
+#ifdef __EMSCRIPTEN__
+    return false;
+#else
+    if (m_active) {
+        return true;
+    }
+    // Timer queries are core since GL 3.3, which the desktop build requires.
+    if (!glGenQueries || !glGetQueryObjectui64v) {
+        return false;
+    }
+    glGenQueries(GpuTimerLatency * GpuPassCount, &m_queries[0][0]);
+    m_slot   = 0;
+    m_active = true;
+    resetStats();
+    return true;
+#endif
+}
+
+void GpuPassTimers::shutdown()
+{
+#ifndef __EMSCRIPTEN__
+    if (!m_active) {
+        return;
+    }
+    glDeleteQueries(GpuTimerLatency * GpuPassCount, &m_queries[0][0]);
+    for (int f = 0; f < GpuTimerLatency; ++f) {
+        for (int p = 0; p < GpuPassCount; ++p) {
+            m_queries[f][p] = 0;
+            m_issued[f][p]  = false;
+        }
+    }
+    m_active = false;
+#endif
+}
+
+void GpuPassTimers::begin(GpuPass pass)
+{
+#ifdef __EMSCRIPTEN__
+    (void)pass;
+#else
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_slot][static_cast<int>(pass)]);
+#endif
+}
+
+void GpuPassTimers::end(GpuPass pass)
+{
+#ifdef __EMSCRIPTEN__
+    (void)pass;
+#else
+    glEndQuery(GL_TIME_ELAPSED);
+    m_issued[m_slot][static_cast<int>(pass)] = true;
+#endif
+}
+
+void GpuPassTimers::endFrame()
+{
+    if (!m_active) {
+        return;
+    }
+    // The next slot is the oldest frame in flight; it is reused next.
+    m_slot = (m_slot + 1) % GpuTimerLatency;
+    collect(m_slot);
+}
+
+void GpuPassTimers::finish()
+{
+    if (!m_active) {
+        return;
+    }
+    for (int i = 1; i <= GpuTimerLatency; ++i) {
+        collect((m_slot + i) % GpuTimerLatency);
+    }
+}
+
+void GpuPassTimers::resetStats()
+{
+    for (GpuPassStats& s : m_stats) {
+        s.totalMs = 0.0;
+        s.maxMs   = 0.0;
+        s.frames  = 0;
+    }
+}
+
+void GpuPassTimers::collect(int slot)
+{
+#ifdef __EMSCRIPTEN__
+    (void)slot;
+#else
+    for (int p = 0; p < GpuPassCount; ++p) {
+        if (!m_issued[slot][p]) {
+            continue;
+        }
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(m_queries[slot][p], GL_QUERY_RESULT, &ns);
+        m_issued[slot][p] = false;
+
+        const double ms = static_cast<double>(ns) * 1e-6;
+        GpuPassStats& s = m_stats[p];
+        s.totalMs += ms;
+        s.maxMs    = std::max(s.maxMs, ms);
+        ++s.frames;
+    }
+#endif
+}
+
+const char* GpuPassTimers::passName(GpuPass pass)
+{
+    switch (pass) {
+    case GpuPass::Field:       return "Decision field";
+    case GpuPass::GridAxes:    return "Grid and axes";
+    case GpuPass::Points:      return "Points";
+    case GpuPass::ImGui:       return "ImGui";
+    default:                   return "?";
+    }
+}
+
+GpuPassScope::GpuPassScope(GpuPass pass)
+    : m_pass(pass)
+    , m_timing(GpuPassTimers::shared().active())
+{
+    if (m_timing) {
+        GpuPassTimers::shared().begin(m_pass);
+    }
+}
+
+GpuPassScope::~GpuPassScope()
+{
+    if (m_timing) {
+        GpuPassTimers::shared().end(m_pass);
+    }
+}
@@ -0,0 +1,241 @@
+// Use GLAD for desktop OpenGL and GLES3 headers for Emscripten/WebGL.
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/html5.h>
+#define GLFW_INCLUDE_ES3
+#include <GLFW/glfw3.h>
+#else
+#define GLFW_INCLUDE_NONE
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "ShaderCache.h"
+#include "Logger.h"
+
+namespace {
+
+#ifndef __EMSCRIPTEN__
+// ARB_get_program_binary (core in GL 4.1) and KHR_parallel_shader_compile
+// are not part of the GL 3.3 loader, so their entry points are fetched here.
+const GLenum kProgramBinaryRetrievableHint = 0x8257;
+const GLenum kProgramBinaryLength          = 0x8741;
+const GLenum kNumProgramBinaryFormats      = 0x87FE;
+
+typedef void (APIENTRYP GetProgramBinaryProc)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+typedef void (APIENTRYP ProgramBinaryProc)(GLuint, GLenum, const void*, GLsizei);
+typedef void (APIENTRYP ProgramParameteriProc)(GLuint, GLenum, GLint);
+typedef void (APIENTRYP MaxShaderCompilerThreadsProc)(GLuint);
+
+GetProgramBinaryProc  s_getProgramBinary  = nullptr;
+ProgramBinaryProc     s_programBinary     = nullptr;
+ProgramParameteriProc s_programParameteri = nullptr;
+
+bool hasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const GLubyte* ext = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+        if (ext && std::strcmp(reinterpret_cast<const char*>(ext), name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+const char     kMagic[4] = {'N', 'N', 'S', 'B'};
+const unsigned kFileVersion = 1;
+
+std::uint64_t fnv1a(std::uint64_t hash, const char* text)
+{
+    // Include the terminator so ("ab", "c") and ("a", "bc") differ.
+    const std::size_t length = text ? std::strlen(text) + 1 : 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::string glString(GLenum name)
+{
+    const GLubyte* s = glGetString(name);
+    return s ? reinterpret_cast<const char*>(s) : "";
+}
+
+} // namespace
+
+ShaderCache::ShaderCache(const std::string& directory)
+    : m_directory(directory)
+    , m_binariesSupported(false)
+    , m_parallelCompile(false)
+    , m_hits(0)
+    , m_misses(0)
+{
+    m_driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+
+#ifdef __EMSCRIPTEN__
+    // Shaders then compile in the background until their status is queried.
+    EMSCRIPTEN_WEBGL_CONTEXT_HANDLE context = emscripten_webgl_get_current_context();
+    m_parallelCompile = context && emscripten_webgl_enable_extension(context, "KHR_parallel_shader_compile");
+#else
+    int major = 0;
+    int minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    const bool core41 = major > 4 || (major == 4 && minor >= 1);
+
+    if (core41 || hasExtension("GL_ARB_get_program_binary")) {
+        s_getProgramBinary  = reinterpret_cast<GetProgramBinaryProc>(glfwGetProcAddress("glGetProgramBinary"));
+        s_programBinary     = reinterpret_cast<ProgramBinaryProc>(glfwGetProcAddress("glProgramBinary"));
+        s_programParameteri = reinterpret_cast<ProgramParameteriProc>(glfwGetProcAddress("glProgramParameteri"));
+
+        GLint formats = 0;
+        glGetIntegerv(kNumProgramBinaryFormats, &formats);
+        m_binariesSupported = s_getProgramBinary && s_programBinary && s_programParameteri && formats > 0;
+    }
+
+    MaxShaderCompilerThreadsProc maxThreads = nullptr;
+    if (hasExtension("GL_KHR_parallel_shader_compile")) {
+        maxThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(
+            glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+    } else if (hasExtension("GL_ARB_parallel_shader_compile")) {
+        maxThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(
+            glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+    }
+    if (maxThreads) {
+        // 0xFFFFFFFF lets the driver pick its maximum.
+        maxThreads(0xFFFFFFFFu);
+        m_parallelCompile = true;
+    }
+
+    if (m_binariesSupported) {
+        std::error_code ec;
+        std::filesystem::create_directories(m_directory, ec);
+        if (ec) {
+            NN_LOG_WARN("[ShaderCache] Cannot create %s: %s", m_directory.c_str(), ec.message().c_str());
+            m_binariesSupported = false;
+        }
+    }
+#endif
+
+    NN_LOG_INFO("[ShaderCache] Program binaries: %s, parallel compile: %s",
+                m_binariesSupported ? "yes" : "no",
+                m_parallelCompile ? "yes" : "no");
+}
+
+std::string ShaderCache::makeKey(const char* vertexSrc, const char* fragmentSrc) const
+{
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    hash = fnv1a(hash, vertexSrc);
+    hash = fnv1a(hash, fragmentSrc);
+    hash = fnv1a(hash, m_driver.c_str());
+
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+
+std::string ShaderCache::pathFor(const std::string& key) const
+{
+    return m_directory + "/" + key + ".bin";
+}
+
+bool ShaderCache::load(unsigned int program, const std::string& key)
+{
+#ifdef __EMSCRIPTEN__
+    (void)program;
+    (void)key;
+    return false;
+#else
+    if (!m_binariesSupported) {
+        return false;
+    }
+
+    std::ifstream file(pathFor(key), std::ios::binary);
+    if (!file) {
+        ++m_misses;
+        return false;
+    }
+
+    char     magic[4] = {};
+    unsigned version  = 0;
+    GLenum   format   = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&format), sizeof(format));
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || version != kFileVersion || binary.empty()) {
+        ++m_misses;
+        return false;
+    }
+
+    s_programBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // Usually a driver change the key did not capture; rebuild from source.
+        NN_LOG_INFO("[ShaderCache] Driver rejected cached binary %s", key.c_str());
+        ++m_misses;
+        return false;
+    }
+
+    ++m_hits;
+    return true;
+#endif
+}
+
+void ShaderCache::prepareForStore(unsigned int program) const
+{
+#ifdef __EMSCRIPTEN__
+    (void)program;
+#else
+    if (m_binariesSupported) {
+        s_programParameteri(program, kProgramBinaryRetrievableHint, GL_TRUE);
+    }
+#endif
+}
+
+void ShaderCache::store(unsigned int program, const std::string& key)
+{
+#ifdef __EMSCRIPTEN__
+    (void)program;
+    (void)key;
+#else
+    if (!m_binariesSupported) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, kProgramBinaryLength, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(static_cast<std::size_t>(length));
+    GLenum format = 0;
+    s_getProgramBinary(program, length, nullptr, &format, binary.data());
+
+    std::ofstream file(pathFor(key), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        NN_LOG_WARN("[ShaderCache] Cannot write %s", pathFor(key).c_str());
+        return;
+    }
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(&kFileVersion), sizeof(kFileVersion));
+    file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+    file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+#endif
+}
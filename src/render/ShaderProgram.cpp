@@ -12,72 +12,157 @@
 #include <GLFW/glfw3.h>
 #endif
 
-#include <iostream>
+#include <utility>
 
 #include "ShaderProgram.h"
+#include "ShaderCache.h"
+#include "Logger.h"
+#include "PerfCounters.h"
 
 ShaderProgram::ShaderProgram(const char* vertexSrc, const char* fragmentSrc)
-    : m_id(0) {
+    : ShaderProgram(vertexSrc, fragmentSrc, nullptr) {
+    finish();
+}
+
+ShaderProgram::ShaderProgram(const char* vertexSrc, const char* fragmentSrc, ShaderCache* cache)
+    : m_id(0)
+    , m_vertexShader(0)
+    , m_fragmentShader(0)
+    , m_pending(false)
+    , m_linked(false)
+    , m_fromCache(false)
+    , m_cache(cache) {
+    m_id = glCreateProgram();
+
+    if (m_cache) {
+        m_cacheKey = m_cache->makeKey(vertexSrc, fragmentSrc);
+        if (m_cache->load(m_id, m_cacheKey)) {
+            NN_LOG_INFO("[Shader] Program loaded from binary cache");
+            m_linked    = true;
+            m_fromCache = true;
+            return;
+        }
+        m_cache->prepareForStore(m_id);
+    }
+
+    startBuild(vertexSrc, fragmentSrc);
+}
+
+void ShaderProgram::startBuild(const char* vertexSrc, const char* fragmentSrc) {
+    // No status queries here: they would block until the driver finishes,
+    // serializing compiles that could otherwise run in parallel.
+    m_vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(m_vertexShader, 1, &vertexSrc, NULL);
+    glCompileShader(m_vertexShader);
+
+    m_fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(m_fragmentShader, 1, &fragmentSrc, NULL);
+    glCompileShader(m_fragmentShader);
+
+    glAttachShader(m_id, m_vertexShader);
+    glAttachShader(m_id, m_fragmentShader);
+    glLinkProgram(m_id);
+    m_pending = true;
+}
+
+bool ShaderProgram::finish() {
+    if (!m_pending) {
+        return m_linked;
+    }
+    m_pending = false;
+
     int success = 0;
     char infoLog[512];
 
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexSrc, NULL);
-    glCompileShader(vertexShader);
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+    glGetShaderiv(m_vertexShader, GL_COMPILE_STATUS, &success);
     if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        glGetShaderInfoLog(m_vertexShader, 512, NULL, infoLog);
+        NN_LOG_ERROR("ERROR::SHADER::VERTEX::COMPILATION_FAILED\n%s", infoLog);
     } else {
-        std::cout << "[Shader] Vertex shader compiled successfully" << std::endl;
+        NN_LOG_INFO("[Shader] Vertex shader compiled successfully");
     }
 
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentSrc, NULL);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+    glGetShaderiv(m_fragmentShader, GL_COMPILE_STATUS, &success);
     if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        glGetShaderInfoLog(m_fragmentShader, 512, NULL, infoLog);
+        NN_LOG_ERROR("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n%s", infoLog);
     } else {
-        std::cout << "[Shader] Fragment shader compiled successfully" << std::endl;
+        NN_LOG_INFO("[Shader] Fragment shader compiled successfully");
     }
 
-    m_id = glCreateProgram();
-    glAttachShader(m_id, vertexShader);
-    glAttachShader(m_id, fragmentShader);
-    glLinkProgram(m_id);
-
     glGetProgramiv(m_id, GL_LINK_STATUS, &success);
     if (!success) {
         glGetProgramInfoLog(m_id, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        NN_LOG_ERROR("ERROR::SHADER::PROGRAM::LINKING_FAILED\n%s", infoLog);
     } else {
-        std::cout << "[Shader] Program linked successfully" << std::endl;
+        NN_LOG_INFO("[Shader] Program linked successfully");
     }
+    m_linked = (success != 0);
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    releaseShaders();
+
+    if (m_linked && m_cache) {
+        m_cache->store(m_id, m_cacheKey);
+    }
+    // The cache is only needed while building.
+    m_cache = nullptr;
+    return m_linked;
+}
+
+void ShaderProgram::releaseShaders() {
+    if (m_vertexShader != 0) {
+        glDetachShader(m_id, m_vertexShader);
+        glDeleteShader(m_vertexShader);
+        m_vertexShader = 0;
+    }
+    if (m_fragmentShader != 0) {
+        glDetachShader(m_id, m_fragmentShader);
+        glDeleteShader(m_fragmentShader);
+        m_fragmentShader = 0;
+    }
 }
 
 ShaderProgram::~ShaderProgram() {
+    releaseShaders();
     if (m_id != 0) {
         glDeleteProgram(m_id);
     }
 }
 
 ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept
-    : m_id(other.m_id) {
-    other.m_id = 0;
+    : m_id(other.m_id)
+    , m_vertexShader(other.m_vertexShader)
+    , m_fragmentShader(other.m_fragmentShader)
+    , m_pending(other.m_pending)
+    , m_linked(other.m_linked)
+    , m_fromCache(other.m_fromCache)
+    , m_cache(other.m_cache)
+    , m_cacheKey(std::move(other.m_cacheKey)) {
+    other.m_id             = 0;
+    other.m_vertexShader   = 0;
+    other.m_fragmentShader = 0;
+    other.m_pending        = false;
 }
 
 ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept {
     if (this != &other) {
+        releaseShaders();
         if (m_id != 0) {
             glDeleteProgram(m_id);
         }
-        m_id = other.m_id;
-        other.m_id = 0;
+        m_id             = other.m_id;
+        m_vertexShader   = other.m_vertexShader;
+        m_fragmentShader = other.m_fragmentShader;
+        m_pending        = other.m_pending;
+        m_linked         = other.m_linked;
+        m_fromCache      = other.m_fromCache;
+        m_cache          = other.m_cache;
+        m_cacheKey       = std::move(other.m_cacheKey);
+
+        other.m_id             = 0;
+        other.m_vertexShader   = 0;
+        other.m_fragmentShader = 0;
+        other.m_pending        = false;
     }
     return *this;
 }
@@ -89,51 +174,56 @@ void ShaderProgram::use() const {
 void ShaderProgram::setVec2(int location, float x, float y) const {
     if (location == -1) {
 #ifndef NDEBUG
-        std::cerr << "[ShaderProgram] Warning: setVec2 called with location == -1" << std::endl;
+        NN_LOG_WARN("[ShaderProgram] Warning: setVec2 called with location == -1");
 #endif
         return;
     }
     glUniform2f(location, x, y);
+    PerfRegistry::shared().add(PerfCounter::UploadBytes, 2 * sizeof(float));
 }
 
 void ShaderProgram::setVec3(int location, float x, float y, float z) const {
     if (location == -1) {
 #ifndef NDEBUG
-        std::cerr << "[ShaderProgram] Warning: setVec3 called with location == -1" << std::endl;
+        NN_LOG_WARN("[ShaderProgram] Warning: setVec3 called with location == -1");
 #endif
         return;
     }
     glUniform3f(location, x, y, z);
+    PerfRegistry::shared().add(PerfCounter::UploadBytes, 3 * sizeof(float));
 }
 
 void ShaderProgram::setInt(int location, int value) const {
     if (location == -1) {
 #ifndef NDEBUG
-        std::cerr << "[ShaderProgram] Warning: setInt called with location == -1" << std::endl;
+        NN_LOG_WARN("[ShaderProgram] Warning: setInt called with location == -1");
 #endif
         return;
     }
     glUniform1i(location, value);
+    PerfRegistry::shared().add(PerfCounter::UploadBytes, sizeof(int));
 }
 
 void ShaderProgram::setFloat(int location, float value) const {
     if (location == -1) {
 #ifndef NDEBUG
-        std::cerr << "[ShaderProgram] Warning: setFloat called with location == -1" << std::endl;
+        NN_LOG_WARN("[ShaderProgram] Warning: setFloat called with location == -1");
 #endif
         return;
     }
     glUniform1f(location, value);
+    PerfRegistry::shared().add(PerfCounter::UploadBytes, sizeof(float));
 }
 
 void ShaderProgram::setFloatArray(int location, const float* data, int count) const {
     if (location == -1) {
 #ifndef NDEBUG
-        std::cerr << "[ShaderProgram] Warning: setFloatArray called with location == -1" << std::endl;
+        NN_LOG_WARN("[ShaderProgram] Warning: setFloatArray called with location == -1");
 #endif
         return;
     }
     if (data != nullptr && count > 0) {
         glUniform1fv(location, count, data);
+        PerfRegistry::shared().add(PerfCounter::UploadBytes, static_cast<std::uint64_t>(count) * sizeof(float));
     }
 }
@@ -0,0 +1,52 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "EmbeddedShaders.h"
+#include "GLUtils.h"
+#include "Logger.h"
+#include "ShaderSources.h"
+
+namespace {
+
+#ifdef __EMSCRIPTEN__
+const char* kEsHeader =
+    "#version 300 es\n"
+    "precision highp float;\n"
+    "precision highp int;\n";
+#endif
+
+std::optional<std::string> findSource(const char* name)
+{
+#ifndef __EMSCRIPTEN__
+    const char* overrideDir = std::getenv(ShaderOverrideEnv);
+    if (overrideDir && *overrideDir) {
+        const std::string path = std::string(overrideDir) + "/" + name;
+        if (auto source = loadTextFile(path.c_str())) {
+            NN_LOG_INFO("[Shader] Using override %s", path.c_str());
+            return source;
+        }
+    }
+#endif
+
+    for (const EmbeddedShader& shader : kEmbeddedShaders) {
+        if (std::strcmp(shader.name, name) == 0) {
+            return std::string(shader.source);
+        }
+    }
+    NN_LOG_ERROR("[Shader] No embedded shader named %s", name);
+    return std::nullopt;
+}
+
+} // namespace
+
+std::optional<std::string> loadShaderSource(const char* name)
+{
+    std::optional<std::string> source = findSource(name);
+#ifdef __EMSCRIPTEN__
+    if (source && source->compare(0, 8, "#version") == 0) {
+        const std::size_t lineEnd = source->find('\n');
+        source->replace(0, lineEnd == std::string::npos ? source->size() : lineEnd + 1, kEsHeader);
+    }
+#endif
+    return source;
+}
@@ -12,6 +12,7 @@
 #include <GLFW/glfw3.h>
 #endif
 
+#include "GLDebug.h"
 #include "TriangleMesh.h"
 
 TriangleMesh::TriangleMesh(const float* vertices, int vertexCount, unsigned int& outVAO, unsigned int& outVBO)
@@ -38,6 +39,9 @@ TriangleMesh::TriangleMesh(const float* vertices, int vertexCount, unsigned int&
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
+    labelGLObject(GLObjectType::VertexArray, m_vao, "triangle mesh VAO");
+    labelGLObject(GLObjectType::Buffer, m_vbo, "triangle mesh VBO");
+
     outVAO = m_vao;
     outVBO = m_vbo;
 }
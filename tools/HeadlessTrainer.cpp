@@ -0,0 +1,119 @@
+// Headless trainer: trains ToyNet without a window.
+//
+// Usage: HeadlessTrainer [options]
+//   --workers N      worker processes for data-parallel training (default 2)
+//   --steps N        training steps (default 2000)
+//   --batch N        samples per worker per step (default 64)
+//   --dataset N      DatasetType index, 0..4 (default 4 = Spirals)
+//   --points N       dataset size (default 4000)
+//   --spread F       dataset spread / noise (default 0.1)
+//   --seed N         dataset and initialization seed (default 1)
+//   --optimizer S    sgd | momentum | adam (default adam)
+//   --lr F           learning rate (default 0.01)
+//   --features N     FeatureSet index, 0..3 (default 0 = raw)
+//   --log N          steps between progress lines (default 100)
+//   --shm NAME       shared-memory segment name (default /nndemo_allreduce)
+//   --publish NAME   publish the run for live viewing (e.g. /nndemo_live)
+//   --publish-interval N  steps between live updates (default 10)
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "DataParallelTrainer.h"
+
+namespace {
+
+void printUsage()
+{
+    std::cout << "Usage: HeadlessTrainer [--workers N] [--steps N] [--batch N] [--dataset N]\n"
+                 "                       [--points N] [--spread F] [--seed N]\n"
+                 "                       [--optimizer sgd|momentum|adam] [--lr F]\n"
+                 "                       [--features N] [--log N] [--shm NAME]\n"
+                 "                       [--publish NAME] [--publish-interval N]\n";
+}
+
+bool parseOptimizer(const char* name, OptimizerType& out)
+{
+    if (std::strcmp(name, "sgd") == 0) {
+        out = OptimizerType::SGD;
+    } else if (std::strcmp(name, "momentum") == 0) {
+        out = OptimizerType::SGDMomentum;
+    } else if (std::strcmp(name, "adam") == 0) {
+        out = OptimizerType::Adam;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    DataParallelConfig cfg;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--workers") {
+            cfg.workers = std::atoi(value);
+        } else if (arg == "--steps") {
+            cfg.steps = std::atoi(value);
+        } else if (arg == "--batch") {
+            cfg.batchSize = std::atoi(value);
+        } else if (arg == "--dataset") {
+            int index = std::atoi(value);
+            if (index < 0 || index >= DatasetTypeCount) {
+                std::cerr << "Dataset index out of range" << std::endl;
+                return 1;
+            }
+            cfg.dataset = static_cast<DatasetType>(index);
+        } else if (arg == "--points") {
+            cfg.numPoints = std::atoi(value);
+        } else if (arg == "--spread") {
+            cfg.spread = static_cast<float>(std::atof(value));
+        } else if (arg == "--seed") {
+            cfg.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--optimizer") {
+            if (!parseOptimizer(value, cfg.optimizer)) {
+                std::cerr << "Unknown optimizer: " << value << std::endl;
+                return 1;
+            }
+        } else if (arg == "--lr") {
+            cfg.learningRate = static_cast<float>(std::atof(value));
+        } else if (arg == "--features") {
+            int index = std::atoi(value);
+            if (index < 0 || index >= FeatureSetCount) {
+                std::cerr << "Feature set index out of range" << std::endl;
+                return 1;
+            }
+            cfg.featureSet = static_cast<FeatureSet>(index);
+        } else if (arg == "--log") {
+            cfg.logInterval = std::atoi(value);
+        } else if (arg == "--shm") {
+            cfg.shmName = value;
+        } else if (arg == "--publish") {
+            cfg.publishName = value;
+        } else if (arg == "--publish-interval") {
+            cfg.publishInterval = std::atoi(value);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    return runDataParallelTraining(cfg);
+}